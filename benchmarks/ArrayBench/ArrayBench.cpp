@@ -0,0 +1,137 @@
+#include "../Benchmark.hpp"
+
+static PendingMessage preparePendingMessage(const CoAPMessage &message, unsigned long timestamp) {
+    PendingMessage pendingMessage;
+    pendingMessage.message_id = (unsigned short) (message.getMessageId() + timestamp);
+    pendingMessage.type = (unsigned char) message.getT();
+    pendingMessage.code = (unsigned char) message.getCode();
+    pendingMessage.token = message.getToken();
+    pendingMessage.timestamp = timestamp;
+    pendingMessage.resource = nullptr;
+    return pendingMessage;
+}
+
+static CoAPMessage prepareMessage() {
+    CoAPMessage message;
+    ByteArray payload;
+    for (int i = 0; i < 32; ++i) {
+        payload.pushBack((unsigned char) ('a' + i % 26));
+    }
+
+    message.setCode(CODE_GET);
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+    message.setPayload(payload);
+    return message;
+}
+
+int main(int argc, char **argv) {
+    const unsigned long iterations = 100000;
+    const CoAPMessage message = prepareMessage();
+
+    benchmark("ByteArray::pushBack x64", iterations, []() {
+        ByteArray array;
+        for (int i = 0; i < 64; ++i) {
+            array.pushBack((unsigned char) i);
+        }
+        doNotOptimize(array.begin());
+    });
+
+    benchmark("ByteArray copy (64 bytes)", iterations, []() {
+        static ByteArray source(64);
+        if (source.size() == 0) {
+            for (int i = 0; i < 64; ++i) {
+                source.pushBack((unsigned char) i);
+            }
+        }
+        ByteArray copy(source);
+        doNotOptimize(copy.begin());
+    });
+
+    benchmark("OptionArray::pushBack x16", iterations, []() {
+        OptionArray array;
+        for (unsigned int i = 0; i < 16; ++i) {
+            array.pushBack(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        }
+        doNotOptimize(array.begin());
+    });
+
+    benchmark("OptionArray::pushBackNew x16", iterations, []() {
+        OptionArray array;
+        for (unsigned int i = 0; i < 16; ++i) {
+            array.pushBackNew(OPTION_URI_PATH, String(RESOURCE_REMOTE));
+        }
+        doNotOptimize(array.begin());
+    });
+
+    benchmark("OptionArray pushBack/popBack x16", iterations, []() {
+        static OptionArray array;
+        for (unsigned int i = 0; i < 16; ++i) {
+            array.pushBack(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        }
+        while (array.size() > 0) {
+            array.popBack();
+        }
+        doNotOptimize(array.begin());
+    });
+
+    benchmark("Array<PendingMessage>::pushBack x16", iterations / 10, [&message]() {
+        Array<PendingMessage> array;
+        for (unsigned long i = 0; i < 16; ++i) {
+            array.pushBack(preparePendingMessage(message, i));
+        }
+        doNotOptimize(array.begin());
+    });
+
+    benchmark("Array<PendingMessage>::pop(0) x16", iterations / 10, [&message]() {
+        Array<PendingMessage> array(16);
+        for (unsigned long i = 0; i < 16; ++i) {
+            array.pushBack(preparePendingMessage(message, i));
+        }
+        while (array.size() > 0) {
+            doNotOptimize(array.pop(0).timestamp);
+        }
+    });
+
+    benchmark("CoAPPendingMessages insert/take x16", iterations / 10, [&message]() {
+        static CoAPPendingMessages pending_messages(PENDING_MESSAGES_CAPACITY);
+        PendingMessage pendingMessage;
+        for (unsigned long i = 0; i < 16; ++i) {
+            pending_messages.insert(preparePendingMessage(message, i));
+        }
+        for (unsigned long i = 0; i < 16; ++i) {
+            pending_messages.take((unsigned short) (message.getMessageId() + i), pendingMessage);
+            doNotOptimize(pendingMessage.timestamp);
+        }
+    });
+
+    benchmark("CoAPTimers schedule/popExpired x16", iterations / 10, []() {
+        static CoAPTimers timers(PENDING_MESSAGES_CAPACITY);
+        int handle;
+        for (int i = 0; i < 16; ++i) {
+            timers.schedule(i, (unsigned long) (16 - i));
+        }
+        while (timers.popExpired(16, handle)) {
+            doNotOptimize(handle);
+        }
+    });
+
+    benchmark("CoAPResources::findChild among 256 siblings", iterations, []() {
+        static CoAPResources resources;
+        static Node* branch = nullptr;
+        if (branch == nullptr) {
+            Array<String> uri_path;
+            uri_path.pushBack(RESOURCE_REMOTE);
+            uri_path.pushBack("");
+            for (unsigned short i = 0; i < 256; ++i) {
+                uri_path.popBack();
+                uri_path.pushBack(TO_STRING(i));
+                resources.insert(uri_path, new unsigned short(i));
+            }
+            branch = resources.findChild(resources.getRoot(), ByteView((const unsigned char *) RESOURCE_REMOTE, 6));
+        }
+        doNotOptimize(resources.findChild(branch, ByteView((const unsigned char *) "255", 3)));
+    });
+
+    return reportBenchmarks("ArrayBench", argc, argv);
+}
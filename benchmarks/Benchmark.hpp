@@ -0,0 +1,127 @@
+#ifndef COAPLIB_BENCHMARK_H
+#define COAPLIB_BENCHMARK_H
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "../src/CoAPLib.h"
+
+using namespace std;
+
+/** Number of allocations made so far by the whole process, including the library.
+ *  Replaced operator new is defined here, so this header has to be included by only one
+ *  translation unit of a benchmark. **/
+static unsigned long benchmark_allocations = 0;
+
+void *operator new(size_t size) {
+    ++benchmark_allocations;
+    void *pointer = malloc(size > 0 ? size : 1);
+    if (pointer == nullptr)
+        throw bad_alloc();
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+struct BenchmarkResult {
+    const char *name;
+    unsigned long iterations;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+/** Results of all benchmarks run so far, in order in which they were run **/
+inline vector<BenchmarkResult> &benchmarkResults() {
+    static vector<BenchmarkResult> results;
+    return results;
+}
+
+/** Keeps compiler from optimizing away computation which result is otherwise unused **/
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Runs given function given number of times and prints mean time and number of allocations of a single run.
+ *  Function is called once before measurement, so lazily prepared state is not counted. **/
+template <typename Function>
+double benchmark(const char *name, unsigned long iterations, Function function) {
+    function();
+
+    unsigned long allocations = benchmark_allocations;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+    for (unsigned long i = 0; i < iterations; ++i) {
+        function();
+    }
+
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    double ns_per_op = (double) chrono::duration_cast<chrono::nanoseconds>(end - begin).count() / iterations;
+    double allocs_per_op = (double) (benchmark_allocations - allocations) / iterations;
+
+    cout << name << ": " << ns_per_op << " ns/op, " << allocs_per_op << " allocs/op" << endl;
+    benchmarkResults().push_back(BenchmarkResult{name, iterations, ns_per_op, allocs_per_op});
+    return ns_per_op;
+}
+
+/** Writes given string as JSON string literal **/
+inline void writeJsonString(ostream &out, const char *value) {
+    out << '"';
+    for (; *value != '\0'; ++value) {
+        if (*value == '"' || *value == '\\')
+            out << '\\';
+        out << *value;
+    }
+    out << '"';
+}
+
+/** Writes results of all benchmarks as JSON object, so they can be compared between versions **/
+inline void writeBenchmarkResults(ostream &out, const char *suite) {
+    const vector<BenchmarkResult> &results = benchmarkResults();
+
+    out << "{\n  \"suite\": ";
+    writeJsonString(out, suite);
+    out << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << (i > 0 ? ",\n" : "\n") << "    {\"name\": ";
+        writeJsonString(out, results[i].name);
+        out << ", \"iterations\": " << results[i].iterations
+            << ", \"ns_per_op\": " << results[i].ns_per_op
+            << ", \"allocs_per_op\": " << results[i].allocs_per_op << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/** Writes results as JSON to file given by --json=<path> argument, if there is one.
+ *  Returns exit code of benchmark. **/
+inline int reportBenchmarks(const char *suite, int argc, char **argv) {
+    const String option = "--json=";
+
+    for (int i = 1; i < argc; ++i) {
+        String argument = argv[i];
+        if (argument.compare(0, option.size(), option) != 0) {
+            cerr << "Unknown argument: " << argument << endl;
+            return 1;
+        }
+
+        ofstream file(argument.substr(option.size()));
+        writeBenchmarkResults(file, suite);
+        if (!file) {
+            cerr << "Could not write " << argument.substr(option.size()) << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif //COAPLIB_BENCHMARK_H
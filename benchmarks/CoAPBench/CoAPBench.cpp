@@ -0,0 +1,221 @@
+#include "../Benchmark.hpp"
+
+#define STRINGIFY(x) #x
+#define TO_STRING_LITERAL(x) STRINGIFY(x)
+
+static struct OnCoAPMessageToSend : public CoAPMessageListener {
+    unsigned long sent = 0;
+
+    void operator()(const CoAPMessage &message) override {
+        ++sent;
+    }
+} onCoAPMessageToSend;
+
+static struct OnRadioMessageToSend : public RadioMessageListener {
+    unsigned long sent = 0;
+
+    void operator()(const RadioMessage &message) override {
+        ++sent;
+    }
+} onRadioMessageToSend;
+
+static CoAPManualClock manualClock;
+
+static struct LevelResource : public CoAPResourceHandler {
+    unsigned char level = '0';
+
+    unsigned short get(const CoAPMessageView &request, CoAPMessage &response) override {
+        ByteArray payload;
+        payload.pushBack(level);
+        response.setPayload(payload);
+        return CODE_CONTENT;
+    }
+
+    unsigned short put(const CoAPMessageView &request, CoAPMessage &response) override {
+        if (request.getPayload().size() != 1)
+            return CODE_BAD_REQUEST;
+
+        level = request.getPayload()[0];
+        return CODE_CHANGED;
+    }
+} levelResource;
+
+static Array<String> preparePath(const String &branch, const String &leaf) {
+    Array<String> uri_path;
+    uri_path.pushBack(branch);
+    uri_path.pushBack(leaf);
+    return uri_path;
+}
+
+static CoAPMessage preparePing() {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_EMPTY);
+    message.setMessageId(1);
+    return message;
+}
+
+static CoAPMessage prepareRequest(unsigned short code, const char *branch, const char *leaf, const char *payload) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(code);
+    message.setMessageId(1);
+    message.setToken(ByteView((const unsigned char *) "\x01\x02\x03\x04", 4));
+    message.addOption(CoAPOption(OPTION_URI_PATH, branch));
+    message.addOption(CoAPOption(OPTION_URI_PATH, leaf));
+
+    if (payload != nullptr) {
+        ByteArray content_format;
+        content_format.pushBack(CONTENT_TEXT_PLAIN);
+        message.addOption(CoAPOption(OPTION_CONTENT_FORMAT, content_format));
+
+        ByteArray value;
+        value.deserialize((const unsigned char *) payload, strlen(payload));
+        message.setPayload(value);
+    }
+    return message;
+}
+
+/** Serialized request which gets new message ID every time it is handled, so it is not taken for duplicate **/
+struct Request {
+    unsigned char buffer[64];
+    unsigned int size;
+    unsigned short message_id;
+
+    Request(const CoAPMessage &message) : size(message.serialize(buffer, sizeof(buffer))), message_id(1) {}
+
+    void handle(CoAPHandler &handler) {
+        ++message_id;
+        buffer[2] = (unsigned char) (message_id >> 8);
+        buffer[3] = (unsigned char) message_id;
+
+        CoAPMessageView view;
+        view.parse(buffer, size);
+        handler.handleMessage(view);
+    }
+};
+
+/** Handler with local resource served by LevelResource and radio resource remote/lamp **/
+static CoAPHandler *prepareHandler() {
+    CoAPHandler *handler = new CoAPHandler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+    handler->registerResource(preparePath("sensors", "level"), levelResource);
+    handler->registerResource(preparePath(RESOURCE_REMOTE, RESOURCE_LAMP), new unsigned short(RADIO_LAMP),
+                              RESOURCE_TYPE_RADIO);
+    return handler;
+}
+
+/** Handler with given number of requests waiting for radio reply **/
+static CoAPHandler *prepareHandler(unsigned int pending) {
+    CoAPHandler *handler = prepareHandler();
+    Request request(prepareRequest(CODE_GET, RESOURCE_REMOTE, RESOURCE_LAMP, nullptr));
+
+    while (handler->getPendingMessages().size() < pending) {
+        request.handle(*handler);
+    }
+    return handler;
+}
+
+static void benchmarkMessage(unsigned long iterations) {
+    static const CoAPMessage put = prepareRequest(CODE_PUT, RESOURCE_REMOTE, RESOURCE_LAMP, "12345");
+    static unsigned char serialized[64];
+    static unsigned int serialized_size = put.serialize(serialized, sizeof(serialized));
+
+    benchmark("CoAPMessage::deserialize (PUT request)", iterations, []() {
+        CoAPMessage message;
+        doNotOptimize(message.deserialize(serialized, serialized_size));
+    });
+
+    benchmark("CoAPMessage::serialize (PUT request)", iterations, []() {
+        unsigned char buffer[64];
+        doNotOptimize(put.serialize(buffer, sizeof(buffer)));
+        doNotOptimize(buffer);
+    });
+
+    benchmark("CoAPMessage::addOption x4", iterations, []() {
+        CoAPMessage message;
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        message.addOption(CoAPOption(OPTION_ACCEPT, "0"));
+        message.addOption(CoAPOption(OPTION_BLOCK2, Block2{0, 0, 6}));
+        doNotOptimize(message.getOptions().begin());
+    });
+}
+
+static void benchmarkResources(unsigned long iterations) {
+    static CoAPResources resources;
+    static const Array<String> last = preparePath(RESOURCE_REMOTE, "device255");
+    for (unsigned short i = 0; i < 256; ++i) {
+        resources.insert(preparePath(i < 16 ? "local" : RESOURCE_REMOTE, "device" + TO_STRING(i)),
+                         new unsigned short(i));
+    }
+
+    benchmark("CoAPResources::search (256 resources)", iterations, []() {
+        doNotOptimize(resources.search(last));
+    });
+
+    benchmark("CoAPResources::toLinkFormat (256 resources, cached)", iterations / 10, []() {
+        String document = resources.toLinkFormat();
+        doNotOptimize(document.size());
+    });
+
+    benchmark("CoAPResources::toLinkFormat (256 resources, rebuilt)", iterations / 1000, []() {
+        // Inserting existing resource again invalidates link format document
+        resources.insert(last, resources.search(last)->getValue());
+        String document = resources.toLinkFormat();
+        doNotOptimize(document.size());
+    });
+}
+
+static void benchmarkHandler(unsigned long iterations) {
+    static CoAPHandler *handler = prepareHandler();
+    static Request get(prepareRequest(CODE_GET, "sensors", "level", nullptr));
+    static Request put(prepareRequest(CODE_PUT, "sensors", "level", "7"));
+    static Request ping(preparePing());
+
+    benchmark("CoAPHandler::handleMessage (GET)", iterations, []() {
+        get.handle(*handler);
+    });
+
+    benchmark("CoAPHandler::handleMessage (PUT)", iterations, []() {
+        put.handle(*handler);
+    });
+
+    benchmark("CoAPHandler::handleMessage (ping)", iterations, []() {
+        ping.handle(*handler);
+    });
+}
+
+static void benchmarkTimeouts(unsigned long iterations) {
+    static CoAPHandler *few_pending = prepareHandler(16);
+    static CoAPHandler *all_pending = prepareHandler(PENDING_MESSAGES_CAPACITY);
+    static CoAPHandler *expiring = prepareHandler();
+    static Request request(prepareRequest(CODE_GET, RESOURCE_REMOTE, RESOURCE_LAMP, nullptr));
+
+    benchmark("CoAPHandler::deleteTimedOut (16 pending, none expired)", iterations, []() {
+        few_pending->deleteTimedOut();
+    });
+
+    benchmark("CoAPHandler::deleteTimedOut (" TO_STRING_LITERAL(PENDING_MESSAGES_CAPACITY) " pending, none expired)",
+              iterations, []() {
+        all_pending->deleteTimedOut();
+    });
+
+    // Clock advances so that about 256 requests are pending and the oldest one expires on every call
+    benchmark("CoAPHandler::handleMessage (GET to radio) + deleteTimedOut (~256 pending, one expired)",
+              iterations, []() {
+        manualClock.time += expiring->getTimeout() / 256;
+        request.handle(*expiring);
+        expiring->deleteTimedOut();
+    });
+}
+
+int main(int argc, char **argv) {
+    const unsigned long iterations = 1000000;
+
+    benchmarkMessage(iterations);
+    benchmarkResources(iterations);
+    benchmarkHandler(iterations / 10);
+    benchmarkTimeouts(iterations / 10);
+
+    return reportBenchmarks("CoAPBench", argc, argv);
+}
@@ -0,0 +1,140 @@
+#include "../Benchmark.hpp"
+
+/** CoAPMessageView::parse as it was before option parsing was reworked, kept as a baseline:
+ *  every extended value is bounds-checked and decoded with its own branches **/
+class BaselineView {
+private:
+    struct Header {
+        unsigned short Ver : 2;
+        unsigned short T : 2;
+        unsigned short TKL : 4;
+        unsigned short Code : 8;
+        unsigned short MessageId : 16;
+    } header_;
+
+    unsigned char* options_begin_;
+    unsigned char* options_end_;
+    unsigned char* buffer_end_;
+
+    static bool extractExtendableValue(unsigned char *&cursor, const unsigned char *buffer_end,
+                                       unsigned char header_value, unsigned int &extendable_value) {
+        if (header_value < 13) {
+            extendable_value = header_value;
+        }
+        else if (header_value == 13 && buffer_end - cursor >= 1) {
+            extendable_value = (unsigned int) cursor[0] + 13;
+            cursor += 1;
+        }
+        else if (header_value == 14 && buffer_end - cursor >= 2) {
+            extendable_value = (((unsigned int) cursor[0] << OFFSET_EXTENDABLE) | cursor[1]) + 269;
+            cursor += 2;
+        }
+        else {
+            return false;
+        }
+
+        return true;
+    }
+
+public:
+    __attribute__((noinline)) bool parse(unsigned char *buffer_begin, unsigned int num) {
+        unsigned char *cursor = buffer_begin;
+        buffer_end_ = buffer_begin + num;
+
+        if (num < 4)
+            return false;
+        header_.Ver = (cursor[0] & MASK_VER) >> OFFSET_VER;
+        header_.T = (cursor[0] & MASK_T) >> OFFSET_T;
+        header_.TKL = (cursor[0] & MASK_TKL);
+        header_.Code = cursor[1];
+        header_.MessageId = (cursor[2] << OFFSET_MESSAGE_ID) | cursor[3];
+        cursor += 4;
+        if (header_.Ver != DEFAULT_VERSION || header_.TKL > 8 || buffer_end_ - cursor < header_.TKL)
+            return false;
+        cursor += header_.TKL;
+
+        options_begin_ = cursor;
+        while (cursor != buffer_end_ && *cursor != PAYLOAD_MARKER) {
+            unsigned int delta = 0;
+            unsigned int length = 0;
+            unsigned char header_delta = (unsigned char) ((*cursor & MASK_DELTA) >> OFFSET_DELTA);
+            unsigned char header_length = (unsigned char) (*cursor & MASK_LENGTH);
+            ++cursor;
+
+            if (!extractExtendableValue(cursor, buffer_end_, header_delta, delta)
+                || !extractExtendableValue(cursor, buffer_end_, header_length, length)
+                || buffer_end_ - cursor < length)
+                return false;
+
+            cursor += length;
+        }
+        options_end_ = cursor;
+
+        return cursor == buffer_end_ || cursor + 1 != buffer_end_;
+    }
+};
+
+/** Serializes GET request with Uri-Path and Uri-Query options of given lengths **/
+static unsigned int prepareRequest(unsigned char *buffer, unsigned int capacity, unsigned int value_length) {
+    String value(value_length, 'x');
+
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_GET);
+    message.setMessageId(1);
+    message.setToken(ByteView((const unsigned char *) "\x01\x02\x03\x04", 4));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+    message.addOption(CoAPOption(OPTION_URI_QUERY, value));
+    message.addOption(CoAPOption(OPTION_ACCEPT, "0"));
+    message.addOption(CoAPOption(OPTION_BLOCK2, Block2{0, 0, 6}));
+    message.addOption(CoAPOption(OPTION_SIZE1, value));
+
+    return message.serialize(buffer, capacity);
+}
+
+int main(int argc, char **argv) {
+    const unsigned long iterations = 1000000;
+    static unsigned char small[64];
+    static unsigned char large[1024];
+    static unsigned char malformed[] = {0x44, 0x01, 0x00, 0x01, 0xab, 0xcd, 0xef, 0x01, 0xbd};
+    static unsigned int small_size = prepareRequest(small, sizeof(small), 4);
+    static unsigned int large_size = prepareRequest(large, sizeof(large), 300);
+
+    benchmark("baseline parse (small request)", iterations, []() {
+        BaselineView view;
+        doNotOptimize(view.parse(small, small_size));
+    });
+
+    benchmark("CoAPMessageView::parse (small request)", iterations, []() {
+        CoAPMessageView view;
+        doNotOptimize(view.parse(small, small_size));
+    });
+
+    benchmark("baseline parse (extended options)", iterations, []() {
+        BaselineView view;
+        doNotOptimize(view.parse(large, large_size));
+    });
+
+    benchmark("CoAPMessageView::parse (extended options)", iterations, []() {
+        CoAPMessageView view;
+        doNotOptimize(view.parse(large, large_size));
+    });
+
+    benchmark("CoAPMessageView::parse (malformed)", iterations, []() {
+        CoAPMessageView view;
+        doNotOptimize(view.parse(malformed, sizeof(malformed)));
+    });
+
+    benchmark("CoAPMessage::deserialize (small request)", iterations / 10, []() {
+        CoAPMessage message;
+        doNotOptimize(message.deserialize(small, small_size));
+    });
+
+    benchmark("CoAPMessage::deserialize (malformed)", iterations, []() {
+        CoAPMessage message;
+        doNotOptimize(message.deserialize(malformed, sizeof(malformed)));
+    });
+
+    return reportBenchmarks("ParserBench", argc, argv);
+}
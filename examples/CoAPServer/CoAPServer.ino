@@ -26,28 +26,37 @@ RF24 radio(7, 8);                               // nRF24L01(+) radio
 RF24Network network(radio);                     // Network initialized with radio
 
 // operator() of this struct is called when CoAPHandler needs to send a CoAP message.
-// It takes care of serializing the message into ByteArray and puts it into udp packet.
+// It takes care of serializing the message into ByteArray and puts it into udp packet addressed to given endpoint.
 struct : public CoAPMessageListener {
     void operator()(const CoAPMessage &message) {
-        unsigned int size = message.serialize(packet_buffer);
-        Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
+        (*this)(message, CoAPEndpoint((uint32_t) Udp.remoteIP(), Udp.remotePort()));
+    }
+
+    void operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+        unsigned int size = message.serialize(packet_buffer, MAX_BUFFER);
+        if (size == 0)
+            return;                             // Message does not fit into packet_buffer
+        Udp.beginPacket(IPAddress((uint32_t) endpoint.address), endpoint.port);
         Udp.write(packet_buffer, size);
         Udp.endPacket();
     }
 } onCoAPMessageToSend;
 
-// operator() of this struct is called when CoAPHandler needs to send a CoAP message.
-// It sends a message using channel '100' to address '01'
-struct : public RadioMessageListener {
-    void operator()(const RadioMessage &message) {
-        network.write(header, &message, sizeof(message));
+// operator() of this struct is called when batch of radio messages is ready to be sent.
+// It sends a frame using channel '100' to address '01'
+struct : public RadioFrameListener {
+    void operator()(const unsigned char *frame, unsigned int size) {
+        network.write(header, frame, size);
     }
-} onRadioMessageToSend;
+} onRadioFrameToSend;
+
+// Radio messages sent by CoAPHandler are coalesced into frames for up to RADIO_BATCH_WINDOW milliseconds
+RadioBatcher radioBatcher(onRadioFrameToSend);
+unsigned char radio_buffer[RADIO_FRAME_SIZE];   // Create buffer for incoming radio frames
 
-CoAPHandler coAPHandler(onCoAPMessageToSend, onRadioMessageToSend);
+CoAPHandler coAPHandler(onCoAPMessageToSend, radioBatcher);
 unsigned short ping_interval = 10000;
 unsigned long last_ping_sent = 0;
-unsigned long last_timeout_check = 0;
 
 void setup() {
     Serial.begin(115200);
@@ -67,17 +76,25 @@ void setup() {
 
 void loop() {
     network.update();
-    // Handle all available radio messages
+    // Handle all available radio frames, each of them may carry several radio messages
     while (network.available()) {
-        RadioMessage receivedMessage;
-        network.read(header, &receivedMessage, sizeof(receivedMessage));
-        coAPHandler.handleMessage(receivedMessage);
+        unsigned int frame_size = network.read(header, radio_buffer, RADIO_FRAME_SIZE);
+        RadioBatcher::split(radio_buffer, frame_size, coAPHandler);
     }
 
-    // Handle CoAP packet if received any
-    unsigned int packet_size = Udp.parsePacket();
-    if (packet_size) {
-        Udp.read(packet_buffer, MAX_BUFFER);
+    // Handle CoAP packet if received any. Packets which do not fit into packet_buffer are dropped,
+    // their unread rest is discarded by the next parsePacket().
+    int packet_size = Udp.parsePacket();
+    if (packet_size > (int) MAX_BUFFER) {
+        DEBUG_PRINT("Dropped ");
+        DEBUG_PRINT(packet_size);
+        DEBUG_PRINTLN(" bytes, packet too big");
+    }
+    else if (packet_size > 0) {
+        // Only bytes actually read may be parsed
+        packet_size = Udp.read(packet_buffer, MAX_BUFFER);
+        if (packet_size < 0)
+            packet_size = 0;
 
         DEBUG_PRINT("Received ");
         DEBUG_PRINT(packet_size);
@@ -89,16 +106,27 @@ void loop() {
         }
         DEBUG_PRINTLN();
 
-        CoAPMessage message;
-        message.deserialize(packet_buffer, packet_size);
-        coAPHandler.handleMessage(message);
+        // Message is parsed in place, without copying it out of packet_buffer.
+        // Sender is remembered, so late radio replies go back to it even if another client has sent something since.
+        // Malformed requests are rejected with 4.00 or 4.02.
+        CoAPMessageView message;
+        CoAPEndpoint sender((uint32_t) Udp.remoteIP(), Udp.remotePort());
+        if (message.parse(packet_buffer, packet_size))
+            coAPHandler.handleMessage(message, sender);
+        else
+            coAPHandler.handleMalformed(message, sender);
     }
 
-    // Deletes pending CoAP request if it can't be served in 5s
+    // Send radio messages which have waited for batch window
+    radioBatcher.poll();
+
+    // Deletes pending CoAP request if it can't be served in 5s and retransmits unacknowledged pings,
+    // only when the earliest deadline is due
 //    unsigned long now = millis();
-//    if (now - last_timeout_check >= coAPHandler.getTimeout()) {
+//    unsigned long next_deadline;
+//    if (coAPHandler.getNextDeadline(next_deadline) && (long) (now - next_deadline) >= 0) {
 //        coAPHandler.deleteTimedOut();
-//        last_timeout_check = now;
+//        coAPHandler.retransmit();
 //    }
 //    if (now - last_ping_sent >= ping_interval) {
 //
@@ -108,7 +136,7 @@ void loop() {
 //            DEBUG_PRINT(Udp.remoteIP());
 //            DEBUG_PRINT(":");
 //            DEBUG_PRINTLN(Udp.remotePort());
-//            coAPHandler.sendPing();
+//            coAPHandler.sendPing(CoAPEndpoint((uint32_t) Udp.remoteIP(), Udp.remotePort()));
 //            last_ping_sent = now;
 //        }
 //    }
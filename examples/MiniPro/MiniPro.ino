@@ -18,6 +18,39 @@ unsigned long last_sent;                // Last time the speaker buzzed
 bool runningFlag = false;               // Indicates if buzzer is working
 
 RadioMessage message;
+unsigned char frame[RADIO_FRAME_SIZE];  // Buffer for incoming radio frames
+
+// operator() of this struct is called when batch of replies is ready to be sent
+struct : public RadioFrameListener {
+    void operator()(const unsigned char *frame_begin, unsigned int size) {
+        RF24NetworkHeader header(other_node_id);
+        network.write(header, frame_begin, size);
+    }
+} onRadioFrameToSend;
+
+// Replies to all messages of received frame are sent back in one frame
+RadioBatcher replies(onRadioFrameToSend);
+
+// handleMessage of this struct is called for every message of received frame
+struct {
+    void handleMessage(RadioMessage &received) {
+        message = received;
+        Serial.println("Received:");
+        message.print();
+
+        // Depending on action update, or just send current values
+        if(message.resource == RADIO_LAMP){
+            if(message.code == RADIO_PUT)
+                setLampBrightness(message.value);
+            send(convert(lampValue));
+        }
+        else if(message.resource == RADIO_SPEAKER){
+            if(message.code == RADIO_PUT)
+                setSpeakerFrequency(message.value);
+            send(speakerValue);
+        }
+    }
+} onRadioMessage;
 
 
 void setup() {
@@ -48,24 +81,12 @@ void loop() {
         digitalWrite(2, digitalRead(2) ^ 1);
     }
 
-    // Check if there is anything ready to receive
+    // Check if there is anything ready to receive, every frame may carry several messages
     while (network.available()) {
         RF24NetworkHeader header;
-        network.read(header, &message, sizeof(message));
-        Serial.println("Received:");
-        message.print();
-
-        // Depending on action update, or just send current values
-        if(message.resource == RADIO_LAMP){
-            if(message.code == RADIO_PUT)
-                setLampBrightness(message.value);
-            send(convert(lampValue));
-        }
-        else if(message.resource == RADIO_SPEAKER){
-            if(message.code == RADIO_PUT)
-                setSpeakerFrequency(message.value);
-            send(speakerValue);
-        }
+        unsigned int size = network.read(header, frame, RADIO_FRAME_SIZE);
+        RadioBatcher::split(frame, size, onRadioMessage);
+        replies.flush();
     }
 }
 
@@ -99,11 +120,10 @@ unsigned short convert(unsigned short val){
     return (unsigned short) tmp;
 }
 
-// Send Radio Message
+// Send Radio Message, it is added to frame of replies
 void send(unsigned short value){
     message.value = value;
     Serial.println("Sent:");
     message.print();
-    RF24NetworkHeader header(other_node_id);
-    network.write(header, &message, sizeof(message));
+    replies(message);
 }
\ No newline at end of file
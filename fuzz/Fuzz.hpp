@@ -0,0 +1,23 @@
+#ifndef COAPLIB_FUZZ_H
+#define COAPLIB_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/CoAPLib.h"
+
+/** Entry point of fuzz target, called by libFuzzer or by FuzzDriver.cpp with every input **/
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/** Stops fuzzing when property of the code does not hold, so the input is reported as a crash **/
+#define FUZZ_ASSERT(x) \
+    do { \
+        if (!(x)) { \
+            fprintf(stderr, "%s:%d: fuzz assertion failed: %s\n", __FILE__, __LINE__, #x); \
+            abort(); \
+        } \
+    } while (0)
+
+#endif //COAPLIB_FUZZ_H
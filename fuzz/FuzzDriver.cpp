@@ -0,0 +1,199 @@
+#include <dirent.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Fuzz.hpp"
+
+#if defined(__SANITIZE_ADDRESS__)
+    #include <sanitizer/common_interface_defs.h>
+#endif
+
+/**
+ * Stand-in for libFuzzer main when fuzz targets are built with GCC. Every file of given corpus is run first,
+ * then random corpus entries are mutated and run for -runs iterations. There is no coverage feedback,
+ * so it is meant for smoke runs under sanitizers and for measuring executions per second:
+ *
+ *     MessageFuzz [-runs=N] [-seed=N] [-max_len=N] corpus_directory_or_file...
+ *
+ * Input which makes target crash is written into crash-<run> file, so it can be run again.
+ */
+
+static std::vector<uint8_t> current_input;
+static unsigned long current_run = 0;
+
+/** Saves input which is being run, called when target crashes **/
+static void saveCrash() {
+    char name[32];
+    snprintf(name, sizeof(name), "crash-%lu", current_run);
+
+    FILE *file = fopen(name, "wb");
+    if (file != nullptr) {
+        fwrite(current_input.data(), 1, current_input.size(), file);
+        fclose(file);
+        fprintf(stderr, "Input written into %s\n", name);
+    }
+}
+
+static void onSignal(int signal_number) {
+    saveCrash();
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+
+static bool readFile(const std::string &path, std::vector<uint8_t> &content) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    uint8_t buffer[4096];
+    size_t read;
+    content.clear();
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.insert(content.end(), buffer, buffer + read);
+    }
+    fclose(file);
+    return true;
+}
+
+/** Adds given file or every regular file of given directory to corpus **/
+static void loadCorpus(const std::string &path, std::vector<std::vector<uint8_t>> &corpus) {
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) {
+        fprintf(stderr, "Can not open %s\n", path.c_str());
+        return;
+    }
+
+    std::vector<uint8_t> content;
+    if (!S_ISDIR(status.st_mode)) {
+        if (readFile(path, content))
+            corpus.push_back(content);
+        return;
+    }
+
+    DIR *directory = opendir(path.c_str());
+    if (directory == nullptr)
+        return;
+
+    for (dirent *entry = readdir(directory); entry != nullptr; entry = readdir(directory)) {
+        std::string entry_path = path + "/" + entry->d_name;
+        if (stat(entry_path.c_str(), &status) == 0 && S_ISREG(status.st_mode) && readFile(entry_path, content))
+            corpus.push_back(content);
+    }
+    closedir(directory);
+}
+
+/** Small xorshift generator, so runs with the same seed are repeatable **/
+static uint64_t random_state = 1;
+
+static uint64_t nextRandom() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static size_t randomBelow(size_t bound) {
+    return bound == 0 ? 0 : (size_t) (nextRandom() % bound);
+}
+
+/** Applies one random mutation. Values interesting for CoAP (reserved nibbles, extended lengths,
+ *  payload marker) are preferred over random bytes. **/
+static void mutate(std::vector<uint8_t> &input, const std::vector<std::vector<uint8_t>> &corpus, size_t max_length) {
+    static const uint8_t interesting[] = {0x00, 0x01, 0x0c, 0x0d, 0x0e, 0x0f, 0x40, 0x7f, 0x80,
+                                          0xc0, 0xd0, 0xdd, 0xe0, 0xee, 0xf0, 0xff};
+
+    switch (randomBelow(7)) {
+        case 0:
+            if (!input.empty())
+                input[randomBelow(input.size())] ^= (uint8_t) (1 << randomBelow(8));
+            break;
+        case 1:
+            if (!input.empty())
+                input[randomBelow(input.size())] = (uint8_t) nextRandom();
+            break;
+        case 2:
+            if (!input.empty())
+                input[randomBelow(input.size())] = interesting[randomBelow(sizeof(interesting))];
+            break;
+        case 3:
+            if (input.size() < max_length)
+                input.insert(input.begin() + randomBelow(input.size() + 1), interesting[randomBelow(sizeof(interesting))]);
+            break;
+        case 4:
+            if (!input.empty())
+                input.erase(input.begin() + randomBelow(input.size()));
+            break;
+        case 5:
+            if (!input.empty())
+                input.resize(randomBelow(input.size()));
+            break;
+        default: {
+            // Splices tail of another corpus entry
+            const std::vector<uint8_t> &other = corpus[randomBelow(corpus.size())];
+            size_t offset = randomBelow(other.size() + 1);
+            input.resize(randomBelow(input.size() + 1));
+            input.insert(input.end(), other.begin() + offset, other.end());
+            break;
+        }
+    }
+
+    if (input.size() > max_length)
+        input.resize(max_length);
+}
+
+static void run(const std::vector<uint8_t> &input) {
+    current_input = input;
+    LLVMFuzzerTestOneInput(current_input.data(), current_input.size());
+    ++current_run;
+}
+
+int main(int argc, char **argv) {
+    unsigned long runs = 100000;
+    size_t max_length = 1280;
+    std::vector<std::vector<uint8_t>> corpus;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "-runs=", 6) == 0)
+            runs = strtoul(argv[i] + 6, nullptr, 10);
+        else if (strncmp(argv[i], "-seed=", 6) == 0)
+            random_state = strtoull(argv[i] + 6, nullptr, 10) | 1;
+        else if (strncmp(argv[i], "-max_len=", 9) == 0)
+            max_length = strtoul(argv[i] + 9, nullptr, 10);
+        else
+            loadCorpus(argv[i], corpus);
+    }
+
+    if (corpus.empty())
+        corpus.push_back(std::vector<uint8_t>());
+
+#if defined(__SANITIZE_ADDRESS__)
+    __sanitizer_set_death_callback(saveCrash);
+#endif
+    signal(SIGABRT, onSignal);
+    signal(SIGSEGV, onSignal);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        run(corpus[i]);
+    }
+
+    std::vector<uint8_t> input;
+    for (unsigned long i = 0; i < runs; ++i) {
+        input = corpus[randomBelow(corpus.size())];
+        for (size_t mutations = 1 + randomBelow(4); mutations > 0; --mutations) {
+            mutate(input, corpus, max_length);
+        }
+        run(input);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    printf("Done %lu runs (%zu from corpus) in %.2f s, %.0f exec/s\n",
+           current_run, corpus.size(), seconds, seconds > 0 ? current_run / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "../Fuzz.hpp"
+
+/**
+ * Feeds input as received datagram through option parser, both message parsers and CoAPHandler.
+ * Checked properties:
+ *  - CoAPMessageView and CoAPMessage accept the same inputs,
+ *  - accepted input serializes back into the same bytes, as CoAP encoding of options is canonical,
+ *  - everything handler sends is well-formed,
+ *  - radio message decoded from input encodes back into the same bytes.
+ */
+
+static CoAPManualClock manualClock;
+
+static struct OnCoAPMessageToSend : public CoAPMessageListener {
+    void operator()(const CoAPMessage &message) override {
+        ByteArray buffer;
+        buffer.resize(message.serializedSize());
+        FUZZ_ASSERT(message.serialize(buffer.begin(), buffer.size()) == buffer.size());
+
+        CoAPMessageView view;
+        FUZZ_ASSERT(view.parse(buffer.begin(), buffer.size()));
+    }
+} onCoAPMessageToSend;
+
+static struct OnRadioMessageToSend : public RadioMessageListener {
+    bool sent = false;
+    RadioMessage message;
+
+    void operator()(const RadioMessage &radio_message) override {
+        unsigned char buffer[RADIO_MESSAGE_MAX_SIZE];
+        FUZZ_ASSERT(radio_message.encode(buffer, sizeof(buffer)) > 0);
+
+        message = radio_message;
+        sent = true;
+    }
+} onRadioMessageToSend;
+
+static void checkOptions(unsigned char *buffer, size_t size) {
+    OptionArray options;
+    unsigned char *cursor = buffer;
+
+    if (CoAPOption::deserialize(cursor, buffer + size, options)) {
+        FUZZ_ASSERT(cursor <= buffer + size);
+        FUZZ_ASSERT(CoAPOption::serializedSize(options) <= size);
+    }
+}
+
+static void checkMessage(unsigned char *buffer, size_t size, const CoAPMessageView &view) {
+    CoAPMessage message;
+    bool deserialized = message.deserialize(buffer, (unsigned int) size);
+    FUZZ_ASSERT(deserialized == (view.getError() == PARSE_OK));
+    if (!deserialized)
+        return;
+
+    FUZZ_ASSERT(message.serializedSize() == size);
+
+    ByteArray serialized;
+    serialized.resize((unsigned int) size);
+    FUZZ_ASSERT(message.serialize(serialized.begin(), serialized.size()) == size);
+    FUZZ_ASSERT(size == 0 || memcmp(serialized.begin(), buffer, size) == 0);
+}
+
+static void checkRadioMessage(const unsigned char *buffer, size_t size) {
+    RadioMessage message;
+    unsigned int decoded = message.decode(buffer, (unsigned int) size);
+    if (decoded == 0)
+        return;
+
+    unsigned char encoded[RADIO_MESSAGE_MAX_SIZE];
+    FUZZ_ASSERT(message.encode(encoded, sizeof(encoded)) == decoded);
+    FUZZ_ASSERT(memcmp(encoded, buffer, decoded) == 0);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static CoAPHandler handler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+
+    // Exact copy, so sanitizers catch every read behind the end of datagram
+    unsigned char *buffer = new unsigned char[size];
+    if (size > 0)
+        memcpy(buffer, data, size);
+
+    checkOptions(buffer, size);
+    checkRadioMessage(buffer, size);
+
+    CoAPMessageView view;
+    bool parsed = view.parse(buffer, (unsigned int) size);
+    checkMessage(buffer, size, view);
+
+    // Request may reach radio node, which replies with value taken from the input
+    onRadioMessageToSend.sent = false;
+    if (parsed)
+        handler.handleMessage(view, CoAPEndpoint(0x0100007f, (unsigned short) (size > 0 ? buffer[0] : 0)));
+    else
+        handler.handleMalformed(view);
+
+    if (onRadioMessageToSend.sent) {
+        RadioMessage reply = onRadioMessageToSend.message;
+        reply.value = size > 1 ? buffer[size - 1] : 0;
+        handler.handleMessage(reply);
+    }
+
+    // Timers fire now and then, so pending requests, retransmissions and observers are exercised too
+    manualClock.time += 250;
+    handler.deleteTimedOut();
+    handler.retransmit();
+
+    delete[] buffer;
+    return 0;
+}
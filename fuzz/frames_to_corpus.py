@@ -0,0 +1,31 @@
+# Writes every frame pasted into tests (as produced by tests/frame_hex_to_array.py) into seed corpus
+# of fuzz targets, one file per frame named by SHA-1 of its content like libFuzzer does.
+# Usage: python3 fuzz/frames_to_corpus.py [corpus directory]
+import glob
+import hashlib
+import os
+import re
+import sys
+
+root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+corpus = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'fuzz', 'corpus', 'MessageFuzz')
+constants = {'PAYLOAD_MARKER': 0xff}
+
+os.makedirs(corpus, exist_ok=True)
+written = 0
+
+for path in sorted(glob.glob(os.path.join(root, 'tests', '*', '*.cpp'))):
+    with open(path) as source:
+        for initializer in re.findall(r'unsigned char \w+\[\w*\] = \{([^}]*)\};', source.read()):
+            values = [value.strip() for value in initializer.split(',') if value.strip()]
+            try:
+                frame = bytes(constants[value] if value in constants else int(value, 0) for value in values)
+            except (ValueError, KeyError):
+                continue
+
+            name = hashlib.sha1(frame).hexdigest()
+            with open(os.path.join(corpus, name), 'wb') as seed:
+                seed.write(frame)
+            written += 1
+
+print('Wrote %d frames into %s' % (written, corpus))
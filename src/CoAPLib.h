@@ -2,11 +2,31 @@
 #define CoAPLib_h
 
 #include "CoAPLib/Array.hpp"
+#include "CoAPLib/ArrayView.hpp"
+#include "CoAPLib/CoAPBlockAssembler.h"
+#include "CoAPLib/CoAPClock.h"
 #include "CoAPLib/CoAPConstants.h"
+#include "CoAPLib/CoAPDeduplicationCache.h"
+#include "CoAPLib/CoAPEndpoint.h"
 #include "CoAPLib/CoAPHandler.h"
+#include "CoAPLib/CoAPLinkFormat.h"
 #include "CoAPLib/CoAPMessage.h"
 #include "CoAPLib/CoAPMessageListener.h"
+#include "CoAPLib/CoAPMessageView.h"
+#include "CoAPLib/CoAPObservers.h"
 #include "CoAPLib/CoAPOption.h"
+#include "CoAPLib/CoAPPendingMessages.h"
+#include "CoAPLib/CoAPQueues.h"
+#include "CoAPLib/CoAPResourceHandler.h"
+#include "CoAPLib/CoAPResponseCache.h"
+#include "CoAPLib/CoAPRetransmitter.h"
+#include "CoAPLib/CoAPRoutes.h"
+#include "CoAPLib/CoAPShardedServer.h"
+#include "CoAPLib/CoAPTimers.h"
+#include "CoAPLib/CoAPUdpServer.h"
+#include "CoAPLib/CoAPValueResource.hpp"
+#include "CoAPLib/InlineArray.hpp"
+#include "CoAPLib/RingBuffer.hpp"
 #include "Environment.h"
 
 #endif //CoAPLib_h
\ No newline at end of file
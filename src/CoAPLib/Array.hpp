@@ -7,32 +7,87 @@ template <typename T>
 class Array;
 typedef Array<unsigned char> ByteArray;
 
-/**This class manages size and memory taken by char array used in CoApMessage**/
+/** Tells if elements of given type can be copied with memcpy (eg. unsigned char).
+ *  Compiler builtin is used, because type_traits are not available on AVR **/
+template <typename T>
+struct IsTriviallyCopyable {
+    static const bool value = __is_trivially_copyable(T);
+};
+
+/** Copies and moves elements one by one, using their assignment operators **/
+template <typename T, bool trivially_copyable = IsTriviallyCopyable<T>::value>
+struct ArrayElements {
+    static void copy(T *destination, const T *source, unsigned int num) {
+        for (unsigned int i = 0; i < num; ++i) {
+            destination[i] = source[i];
+        }
+    }
+
+    static void move(T *destination, T *source, unsigned int num) {
+        if (destination < source) {
+            for (unsigned int i = 0; i < num; ++i) {
+                destination[i] = static_cast<T &&>(source[i]);
+            }
+        }
+        else {
+            for (unsigned int i = num; i > 0; --i) {
+                destination[i - 1] = static_cast<T &&>(source[i - 1]);
+            }
+        }
+    }
+};
+
+/** Copies and moves elements with memcpy/memmove **/
+template <typename T>
+struct ArrayElements<T, true> {
+    static void copy(T *destination, const T *source, unsigned int num) {
+        if (num > 0)
+            memcpy(destination, source, num * sizeof(T));
+    }
+
+    static void move(T *destination, T *source, unsigned int num) {
+        if (num > 0)
+            memmove(destination, source, num * sizeof(T));
+    }
+};
+
+/**This class manages size and memory taken by char array used in CoApMessage.
+ * Capacity grows geometrically, so appending is amortised O(1), and shrinks
+ * only when array becomes sparse. **/
 template <typename T>
 class Array {
 private:
     unsigned int size_;
     unsigned int capacity_;
     T* array_begin_;
+
+    void grow(unsigned int min_capacity);
+    void shrink();
 public:
     Array();
     Array(unsigned int capacity);
     Array(const Array & array);
+    Array(Array && array);
 
     ~Array();
 
     void serialize(unsigned char *cursor) const;
-    void deserialize(unsigned char *cursor, unsigned int num);
+    void deserialize(const unsigned char *cursor, unsigned int num);
 
     void pushFront(const T &value);
     void pushBack(const T &value);
+    void pushBack(T &&value);
+    template <typename... Args>
+    T &pushBackNew(Args &&... args);
     const T popBack();
     void insert(const T &value, unsigned int index);
     const T pop(unsigned int index);
     void erase(unsigned int index);
     void reserve(unsigned int new_capacity);
+    void resize(unsigned int new_size);
 
     Array &operator=(const Array & array);
+    Array &operator=(Array && array);
     const T &operator[] (int index) const;
     Array &operator+=(const Array &array);
 
@@ -48,24 +103,27 @@ Array<T>::Array() : Array(0) {}
 
 /**Creates array with reserved memory for given number of elements**/
 template <typename T>
-Array<T>::Array(unsigned int capacity) : capacity_(capacity), size_(0), array_begin_(nullptr) {
+Array<T>::Array(unsigned int capacity) : size_(0), capacity_(0), array_begin_(nullptr) {
     if (capacity > 0)
         reserve(capacity);
 }
 
-/**Creates copy of another Array**/
+/**Creates copy of another Array, only valid elements are copied**/
 template <typename T>
-Array<T>::Array(const Array &array) {
-    T* new_array_begin = new T[array.capacity_];
-
-    if(array.array_begin_!= nullptr) {
-        for(int i = 0; i < array.capacity_; i++) {
-            new_array_begin[i] = array.array_begin_[i];
-        }
+Array<T>::Array(const Array &array) : size_(0), capacity_(0), array_begin_(nullptr) {
+    if (array.size_ > 0) {
+        reserve(array.size_);
+        ArrayElements<T>::copy(array_begin_, array.array_begin_, array.size_);
+        size_ = array.size_;
     }
-    array_begin_ = new_array_begin;
-    capacity_ = array.capacity_;
-    size_=array.size_;
+}
+
+/**Takes over memory of another Array, leaving it empty**/
+template <typename T>
+Array<T>::Array(Array &&array) : size_(array.size_), capacity_(array.capacity_), array_begin_(array.array_begin_) {
+    array.size_ = 0;
+    array.capacity_ = 0;
+    array.array_begin_ = nullptr;
 }
 
 template <typename T>
@@ -73,6 +131,22 @@ Array<T>::~Array() {
     delete[] array_begin_;
 }
 
+/** Reallocates array so it can hold at least given number of elements, at least doubling its capacity **/
+template <typename T>
+void Array<T>::grow(unsigned int min_capacity) {
+    unsigned int new_capacity = capacity_ > 0 ? capacity_ * 2 : 1;
+
+    reserve(new_capacity > min_capacity ? new_capacity : min_capacity);
+}
+
+/** Halves capacity when no more than quarter of it is used, so popping and pushing around
+ *  the threshold does not reallocate every time **/
+template <typename T>
+void Array<T>::shrink() {
+    if (size_ > 0 && size_ <= capacity_ / 4)
+        reserve(capacity_ / 2);
+}
+
 /** Adds given element at front of the array **/
 template <typename T>
 void Array<T>::pushFront(const T &value) {
@@ -84,105 +158,102 @@ void Array<T>::pushFront(const T &value) {
 template <typename T>
 void Array<T>::pushBack(const T &value) {
     if (size_ == capacity_) {
-        reserve(size_ + 1);
+        grow(size_ + 1);
     }
     array_begin_[size_] = value;
     ++size_;
 }
 
+/** Moves given element to the end of the array **/
+template <typename T>
+void Array<T>::pushBack(T &&value) {
+    if (size_ == capacity_) {
+        grow(size_ + 1);
+    }
+    array_begin_[size_] = static_cast<T &&>(value);
+    ++size_;
+}
+
+/** Creates temporary element from given arguments, moves it to the end of the array and returns it.
+ *  Slots of the array are already default-constructed, so element is not constructed in place. **/
+template <typename T>
+template <typename... Args>
+T &Array<T>::pushBackNew(Args &&... args) {
+    if (size_ == capacity_) {
+        grow(size_ + 1);
+    }
+    array_begin_[size_] = T(static_cast<Args &&>(args)...);
+    return array_begin_[size_++];
+}
+
 /** Returns last element and deletes it from array **/
 template<typename T>
 const T Array<T>::popBack() {
-    T element = array_begin_[size_ - 1];
+    T element = static_cast<T &&>(array_begin_[size_ - 1]);
     --size_;
-    if(size_ > 0 && size_ < capacity_ - 1)
-        reserve(size_);
+    shrink();
     return element;
 }
 
 /** Returns element at given index and deletes it from array **/
 template<typename T>
 const T Array<T>::pop(unsigned int index) {
-    T element = array_begin_[index];
-    T* iterator1 = array_begin_ + index;
-    T* iterator2 = array_begin_ + index + 1;
-    T* end = Array<T>::end();
-
-    while(iterator2 != end) {
-        *iterator1 = *iterator2;
-        iterator1++;
-        iterator2++;
-    }
-    --size_;
-    if(size_ > 0 && size_ < capacity_ - 1)
-        reserve(size_);
+    T element = static_cast<T &&>(array_begin_[index]);
+    erase(index);
     return element;
 }
 
 /** Deletes element at given index **/
 template<typename T>
 void Array<T>::erase(unsigned int index) {
-    T* iterator1 = array_begin_ + index;
-    T* iterator2 = array_begin_ + index + 1;
-    T* end = Array<T>::end();
-
-    while(iterator2 != end) {
-        *iterator1 = *iterator2;
-        iterator1++;
-        iterator2++;
-    }
+    ArrayElements<T>::move(array_begin_ + index, array_begin_ + index + 1, size_ - index - 1);
     --size_;
-    if(size_ > 0 && size_ < capacity_ - 1)
-        reserve(size_);
+    shrink();
 }
 
-/** Inserts element after given index **/
+/** Inserts element at given index, moving following elements by one.
+ *  If index is past the end, array is extended up to it. **/
 template <typename T>
 void Array<T>::insert(const T &value, unsigned int index) {
-    unsigned int old_capacity = capacity_;
-    if (index + 1 > size_) {
-        if (index + 1 > capacity_)
-            capacity_ = index + 1;
-        size_ = index + 1;
-    }
-    else if (size_ == capacity_) {
-        ++capacity_;
-        ++size_;
-    }
-
-    T* new_array_begin = new T[capacity_];
+    unsigned int new_size = index < size_ ? size_ + 1 : index + 1;
 
-    if (array_begin_ != nullptr) {
-        for (int i = 0; i < index; ++i) {
-            new_array_begin[i] = array_begin_[i];
-        }
+    if (new_size > capacity_) {
+        grow(new_size);
+    }
 
-        for (int i = index; i < old_capacity; ++i) {
-            new_array_begin[i + 1] = array_begin_[i];
-        }
-        delete[] array_begin_;
+    if (index < size_) {
+        ArrayElements<T>::move(array_begin_ + index + 1, array_begin_ + index, size_ - index);
     }
 
-    array_begin_ = new_array_begin;
     array_begin_[index] = value;
+    size_ = new_size;
 }
 
 /** Moves all elements to new array with given capacity **/
 template <typename T>
 void Array<T>::reserve(unsigned int new_capacity) {
-    unsigned int capacity = new_capacity > capacity_ ?  capacity_ : new_capacity;
+    unsigned int size = new_capacity > size_ ? size_ : new_capacity;
 
-    T* new_array_begin = new T[new_capacity];
+    T* new_array_begin = new_capacity > 0 ? new T[new_capacity] : nullptr;
 
     if (array_begin_ != nullptr) {
-        for (int i = 0; i < capacity; ++i) {
-            new_array_begin[i] = array_begin_[i];
-        }
+        ArrayElements<T>::move(new_array_begin, array_begin_, size);
         delete[] array_begin_;
     }
 
     array_begin_ = new_array_begin;
     capacity_ = new_capacity;
+    size_ = size;
+}
+
+/** Changes number of valid elements, eg. after they were written straight into memory of the array.
+ *  Capacity grows if needed, new elements are default-constructed. **/
+template <typename T>
+void Array<T>::resize(unsigned int new_size) {
+    if (new_size > capacity_)
+        reserve(new_size);
+
+    size_ = new_size;
 }
 
 /** Returns element at given index**/
@@ -194,11 +265,11 @@ const T &Array<T>::operator[](int index) const {
 /** Pushes element at the back and expands array if neccessary**/
 template <typename T>
 Array<T> &Array<T>::operator+=(const Array<T> &array) {
-    reserve(size_ + array.size_);
+    if (size_ + array.size_ > capacity_)
+        reserve(size_ + array.size_);
 
-    for (int i = 0; i < array.size_; ++i) {
-        pushBack(array[i]);
-    }
+    ArrayElements<T>::copy(array_begin_ + size_, array.array_begin_, array.size_);
+    size_ += array.size_;
 
     return *this;
 }
@@ -226,16 +297,33 @@ template <typename T>
 T *Array<T>::end() const {
     return &array_begin_[size_];
 }
-/**Copies into array content of another array **/
+/**Copies into array content of another array, memory is reused if it is big enough **/
 template <typename T>
 Array<T> &Array<T>::operator=(const Array<T> &array) {
     if(&array != this) {
+        if (capacity_ < array.size_) {
+            size_ = 0;
+            reserve(array.size_);
+        }
+
+        ArrayElements<T>::copy(array_begin_, array.array_begin_, array.size_);
+        size_ = array.size_;
+    }
+    return *this;
+}
+/**Takes over memory of another array, leaving it empty **/
+template <typename T>
+Array<T> &Array<T>::operator=(Array<T> &&array) {
+    if(&array != this) {
+        delete[] array_begin_;
+
         size_ = array.size_;
-        reserve(array.capacity_);
+        capacity_ = array.capacity_;
+        array_begin_ = array.array_begin_;
 
-        for (int i = 0; i < size_; ++i) {
-            array_begin_[i] = array.array_begin_[i];
-        }
+        array.size_ = 0;
+        array.capacity_ = 0;
+        array.array_begin_ = nullptr;
     }
     return *this;
 }
@@ -246,10 +334,14 @@ void Array<T>::serialize(unsigned char *cursor) const {
 }
 /**Copies content of char array into our Array **/
 template <typename T>
-void Array<T>::deserialize(unsigned char *cursor, unsigned int num) {
-    reserve(num);
-    size_ = capacity_;
-    memcpy(array_begin_, cursor, num);
+void Array<T>::deserialize(const unsigned char *cursor, unsigned int num) {
+    if (capacity_ < num) {
+        size_ = 0;
+        reserve(num);
+    }
+    size_ = num;
+    if (num > 0)
+        memcpy(array_begin_, cursor, num);
 }
 
 #endif //ARRAY_H
@@ -0,0 +1,88 @@
+#ifndef ARRAYVIEW_H
+#define ARRAYVIEW_H
+
+#include "../Environment.h"
+
+template <typename T>
+class ArrayView;
+typedef ArrayView<unsigned char> ByteView;
+
+/**This class describes read-only range of elements owned by someone else (eg. receive buffer)**/
+template <typename T>
+class ArrayView {
+private:
+    const T* begin_;
+    unsigned int size_;
+public:
+    ArrayView();
+    ArrayView(const T *begin, unsigned int size);
+
+    const T &operator[] (int index) const;
+    bool operator==(const ArrayView &view) const;
+    bool operator==(const char *value) const;
+
+    unsigned int size() const;
+
+    const T *begin() const;
+    const T *end() const;
+};
+
+template <typename T>
+ArrayView<T>::ArrayView() : begin_(nullptr), size_(0) {}
+
+/**Creates view of given number of elements starting at begin**/
+template <typename T>
+ArrayView<T>::ArrayView(const T *begin, unsigned int size) : begin_(begin), size_(size) {}
+
+/** Returns element at given index**/
+template <typename T>
+const T &ArrayView<T>::operator[](int index) const {
+    return begin_[index];
+}
+
+/** Compares content of both views **/
+template <typename T>
+bool ArrayView<T>::operator==(const ArrayView<T> &view) const {
+    if (size_ != view.size_)
+        return false;
+
+    for (unsigned int i = 0; i < size_; ++i) {
+        if (!(begin_[i] == view.begin_[i]))
+            return false;
+    }
+
+    return true;
+}
+
+/** Compares content of the view with null terminated string **/
+template <typename T>
+bool ArrayView<T>::operator==(const char *value) const {
+    unsigned int i = 0;
+
+    for (; i < size_; ++i) {
+        if (value[i] == '\0' || begin_[i] != (T) value[i])
+            return false;
+    }
+
+    return value[i] == '\0';
+}
+
+/** Returns number of elements in the view **/
+template <typename T>
+unsigned int ArrayView<T>::size() const {
+    return size_;
+}
+
+/** Returns pointer to the first element of the view **/
+template <typename T>
+const T *ArrayView<T>::begin() const {
+    return begin_;
+}
+
+/** Returns pointer to the element after the last element of the view **/
+template <typename T>
+const T *ArrayView<T>::end() const {
+    return begin_ + size_;
+}
+
+#endif //ARRAYVIEW_H
@@ -0,0 +1,106 @@
+#include "CoAPBlockAssembler.h"
+
+CoAPBlockAssembler::CoAPBlockAssembler(unsigned int capacity, unsigned int max_body_size) :
+        capacity_(capacity),
+        max_body_size_(max_body_size),
+        started_(0) {
+    transfers_ = new BlockTransfer[capacity_];
+    used_ = new bool[capacity_];
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        used_[i] = false;
+    }
+}
+
+CoAPBlockAssembler::~CoAPBlockAssembler() {
+    delete[] transfers_;
+    delete[] used_;
+}
+
+/** Returns position of transfer from given endpoint to given resource, -1 if there is none **/
+int CoAPBlockAssembler::locate(const CoAPEndpoint &endpoint, const void *resource) const {
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        if (used_[i] && transfers_[i].endpoint == endpoint && transfers_[i].resource == resource)
+            return (int) i;
+    }
+    return -1;
+}
+
+/** Drops transfer and frees memory taken by its body **/
+void CoAPBlockAssembler::release(unsigned int position) {
+    transfers_[position].body = ByteArray();
+    used_[position] = false;
+}
+
+/** Appends block to the body of transfer. Returns CODE_CONTINUE if more blocks are expected,
+ *  CODE_EMPTY if body is complete (it is then moved into given array) or error code which should be sent back:
+ *  CODE_REQUEST_ENTITY_INCOMPLETE if block does not follow previous one,
+ *  CODE_REQUEST_ENTITY_TOO_LARGE if body would exceed max size. **/
+unsigned short CoAPBlockAssembler::append(const CoAPEndpoint &endpoint, const void *resource, const Block2 &block,
+                                          const ByteView &payload, ByteArray &body) {
+    unsigned int block_size = 1u << block.szx;
+    int position = locate(endpoint, resource);
+
+    if (block.num == 0) {
+        if (capacity_ == 0)
+            return CODE_REQUEST_ENTITY_TOO_LARGE;
+
+        if (position < 0) {
+            position = 0;
+            for (unsigned int i = 0; i < capacity_; ++i) {
+                if (!used_[i]) {
+                    position = (int) i;
+                    break;
+                }
+                if (started_ - transfers_[i].started > started_ - transfers_[position].started)
+                    position = (int) i;
+            }
+        }
+
+        release((unsigned int) position);
+        transfers_[position].endpoint = endpoint;
+        transfers_[position].resource = resource;
+        transfers_[position].started = ++started_;
+        used_[position] = true;
+    }
+    else if (position < 0 || transfers_[position].body.size() != (unsigned long) block.num * block_size) {
+        if (position >= 0)
+            release((unsigned int) position);
+        return CODE_REQUEST_ENTITY_INCOMPLETE;
+    }
+
+    BlockTransfer &transfer = transfers_[position];
+    if ((block.m && payload.size() != block_size) || payload.size() > block_size) {
+        release((unsigned int) position);
+        return CODE_REQUEST_ENTITY_INCOMPLETE;
+    }
+    if (transfer.body.size() + payload.size() > max_body_size_) {
+        release((unsigned int) position);
+        return CODE_REQUEST_ENTITY_TOO_LARGE;
+    }
+
+    for (unsigned int i = 0; i < payload.size(); ++i) {
+        transfer.body.pushBack(payload[i]);
+    }
+
+    if (block.m)
+        return CODE_CONTINUE;
+
+    body = static_cast<ByteArray &&>(transfer.body);
+    release((unsigned int) position);
+    return CODE_EMPTY;
+}
+
+/** Returns number of transfers in progress **/
+unsigned int CoAPBlockAssembler::size() const {
+    unsigned int result = 0;
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        if (used_[i])
+            ++result;
+    }
+    return result;
+}
+
+/** Returns max size of reassembled body **/
+unsigned int CoAPBlockAssembler::getMaxBodySize() const {
+    return max_body_size_;
+}
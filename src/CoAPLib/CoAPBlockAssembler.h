@@ -0,0 +1,48 @@
+#ifndef COAPLIB_COAPBLOCKASSEMBLER_H
+#define COAPLIB_COAPBLOCKASSEMBLER_H
+
+#include "ArrayView.hpp"
+#include "CoAPEndpoint.h"
+#include "CoAPOption.h"
+#include "../Environment.h"
+
+/**
+ * Request body being received in blocks from one endpoint
+ */
+struct BlockTransfer {
+    CoAPEndpoint endpoint;
+    const void* resource;
+    ByteArray body;
+    unsigned long started;
+};
+
+/**
+ * Reassembles request bodies sent in Block1 transfers (RFC 7959). Transfer is identified by endpoint
+ * and target resource. Memory is bounded by number of transfers and max size of body, when all
+ * transfers are in use the oldest one is dropped.
+ */
+class CoAPBlockAssembler {
+private:
+    BlockTransfer* transfers_;
+    bool* used_;
+    unsigned int capacity_;
+    unsigned int max_body_size_;
+    unsigned long started_;
+
+    int locate(const CoAPEndpoint &endpoint, const void *resource) const;
+    void release(unsigned int position);
+
+    CoAPBlockAssembler(const CoAPBlockAssembler &assembler);
+    CoAPBlockAssembler &operator=(const CoAPBlockAssembler &assembler);
+public:
+    CoAPBlockAssembler(unsigned int capacity, unsigned int max_body_size);
+    ~CoAPBlockAssembler();
+
+    unsigned short append(const CoAPEndpoint &endpoint, const void *resource, const Block2 &block,
+                          const ByteView &payload, ByteArray &body);
+
+    unsigned int size() const;
+    unsigned int getMaxBodySize() const;
+};
+
+#endif //COAPLIB_COAPBLOCKASSEMBLER_H
@@ -0,0 +1,22 @@
+#ifndef COAPLIB_COAPCLOCK_H
+#define COAPLIB_COAPCLOCK_H
+
+#include "../Environment.h"
+
+/** Source of time used by timers, can be replaced eg. in tests to control time without waiting **/
+struct CoAPClock {
+    virtual unsigned long now() const {
+        return millis();
+    }
+};
+
+/** Clock which shows time set by its owner, so tests can move time forward without waiting **/
+struct CoAPManualClock : public CoAPClock {
+    unsigned long time = 0;
+
+    unsigned long now() const override {
+        return time;
+    }
+};
+
+#endif //COAPLIB_COAPCLOCK_H
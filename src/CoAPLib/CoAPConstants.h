@@ -25,6 +25,7 @@
 #define CODE_VALID COAP_CODE(203)
 #define CODE_CHANGED COAP_CODE(204)
 #define CODE_CONTENT COAP_CODE(205)
+#define CODE_CONTINUE COAP_CODE(231)
 #define CODE_BAD_REQUEST COAP_CODE(400)
 #define CODE_UNAUTHORIZED COAP_CODE(401)
 #define CODE_BAD_OPTION COAP_CODE(402)
@@ -32,6 +33,7 @@
 #define CODE_NOT_FOUND COAP_CODE(404)
 #define CODE_METHOD_NOT_ALLOWED COAP_CODE(405)
 #define CODE_NOT_ACCEPTABLE COAP_CODE(406)
+#define CODE_REQUEST_ENTITY_INCOMPLETE COAP_CODE(408)
 #define CODE_PRECONDITION_FAILED COAP_CODE(412)
 #define CODE_REQUEST_ENTITY_TOO_LARGE COAP_CODE(413)
 #define CODE_UNSUPPORTED_CONTENT_FORMAT COAP_CODE(415)
@@ -44,15 +46,127 @@
 
 
 // Option codes:
+#define OPTION_OBSERVE 6
 #define OPTION_URI_PATH 11
 #define OPTION_CONTENT_FORMAT 12
+#define OPTION_MAX_AGE 14
+#define OPTION_URI_QUERY 15
 #define OPTION_ACCEPT 17
 #define OPTION_BLOCK2 23
+#define OPTION_BLOCK1 27
+#define OPTION_SIZE2 28
+#define OPTION_SIZE1 60
 
 // Supported content formats:
 #define CONTENT_TEXT_PLAIN 0
 #define CONTENT_LINK_FORMAT 40
 
+// Inline storage sizes:
+#define TOKEN_MAX_LENGTH 8
+#define OPTION_INLINE_LENGTH 12
+
+// Max number of requests waiting for radio reply:
+#ifndef PENDING_MESSAGES_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define PENDING_MESSAGES_CAPACITY 8
+    #else
+        #define PENDING_MESSAGES_CAPACITY 1024
+    #endif
+#endif
+
+// Message transmission parameters (RFC 7252, section 4.8), times in milliseconds:
+#define ACK_TIMEOUT 2000
+#define ACK_RANDOM_FACTOR_PERCENT 150
+#define MAX_RETRANSMIT 4
+#define NSTART 1
+#define EXCHANGE_LIFETIME 247000UL
+
+// Max number of confirmable messages waiting for acknowledgement:
+#ifndef RETRANSMISSIONS_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define RETRANSMISSIONS_CAPACITY 2
+    #else
+        #define RETRANSMISSIONS_CAPACITY 64
+    #endif
+#endif
+
+// Max number of recently received requests remembered to detect duplicates:
+#ifndef DEDUPLICATION_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define DEDUPLICATION_CAPACITY 4
+    #else
+        #define DEDUPLICATION_CAPACITY 1024
+    #endif
+#endif
+
+// Number of seconds for which values of remote resources are served from cache:
+#ifndef DEFAULT_MAX_AGE
+    #define DEFAULT_MAX_AGE 60
+#endif
+
+// Max number of remote resources whose values are cached:
+#ifndef RESPONSE_CACHE_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define RESPONSE_CACHE_CAPACITY 2
+    #else
+        #define RESPONSE_CACHE_CAPACITY 64
+    #endif
+#endif
+
+// Max number of observers of single resource:
+#ifndef OBSERVERS_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define OBSERVERS_CAPACITY 2
+    #else
+        #define OBSERVERS_CAPACITY 32
+    #endif
+#endif
+
+// Binary logarithm of the biggest block sent or received in block-wise transfer, eg. 5 means 32 bytes:
+#ifndef MAX_BLOCK_SZX
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define MAX_BLOCK_SZX 5
+    #else
+        #define MAX_BLOCK_SZX 10
+    #endif
+#endif
+
+// Max size of request body reassembled from Block1 transfer and number of such transfers at once:
+#ifndef MAX_BLOCK1_BODY_SIZE
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define MAX_BLOCK1_BODY_SIZE 64
+        #define BLOCK1_TRANSFERS_CAPACITY 1
+    #else
+        #define MAX_BLOCK1_BODY_SIZE 16384
+        #define BLOCK1_TRANSFERS_CAPACITY 16
+    #endif
+#endif
+
+// Number of resource tree nodes allocated at once:
+#ifndef RESOURCE_NODES_PER_CHUNK
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define RESOURCE_NODES_PER_CHUNK 4
+    #else
+        #define RESOURCE_NODES_PER_CHUNK 64
+    #endif
+#endif
+
+// Max number of datagrams and radio messages waiting in each queue between transports and handler:
+#ifndef COAP_QUEUE_CAPACITY
+    #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+        #define COAP_QUEUE_CAPACITY 2
+        #define RADIO_QUEUE_CAPACITY 8
+    #else
+        #define COAP_QUEUE_CAPACITY 1024
+        #define RADIO_QUEUE_CAPACITY 1024
+    #endif
+#endif
+
+// Option values at least this long are referenced in place, when message is serialized into segments:
+#ifndef COAP_GATHER_MIN_SIZE
+    #define COAP_GATHER_MIN_SIZE 32
+#endif
+
 // Message header constants:
 #define MASK_VER 0xC0
 #define MASK_T 0x30
@@ -72,8 +186,6 @@
 #define OFFSET_EXTENDABLE 8
 
 // Resource types constants:
-#define RESOURCE_ALL1 "</remote/speaker>;value=1,</remote/lamp>;value=0"
-#define RESOURCE_ALL2 ",</local/jitter>,</local/rtt>,</local/timed_out>"
 #define RESOURCE_WELL_KNOWN ".well-known"
 #define RESOURCE_CORE "core"
 #define RESOURCE_LOCAL "local"
@@ -84,4 +196,8 @@
 #define RESOURCE_SPEAKER "speaker"
 #define RESOURCE_LAMP "lamp"
 
+// Resource types (rt attribute in link format):
+#define RESOURCE_TYPE_METRIC "metric"
+#define RESOURCE_TYPE_RADIO "radio"
+
 #endif //CODES_H
@@ -0,0 +1,136 @@
+#include "CoAPDeduplicationCache.h"
+
+/** Creates cache able to remember given number of messages for given time **/
+CoAPDeduplicationCache::CoAPDeduplicationCache(const CoAPClock &clock, unsigned int capacity, unsigned long lifetime) :
+        clock_(&clock),
+        capacity_(capacity),
+        index_capacity_(1),
+        head_(0),
+        size_(0),
+        lifetime_(lifetime) {
+    while (index_capacity_ < capacity_ * 2) {
+        index_capacity_ *= 2;
+    }
+
+    messages_ = new RecentMessage[capacity_];
+    index_ = new unsigned short[index_capacity_];
+    for (unsigned int i = 0; i < index_capacity_; ++i) {
+        index_[i] = (unsigned short) NO_RECENT_MESSAGE;
+    }
+}
+
+CoAPDeduplicationCache::~CoAPDeduplicationCache() {
+    delete[] messages_;
+    delete[] index_;
+}
+
+/** Returns index slot at which search for given message starts **/
+unsigned int CoAPDeduplicationCache::home(unsigned short message_id, const CoAPEndpoint &endpoint) const {
+    unsigned short key = (unsigned short) (message_id ^ endpoint.address ^ (endpoint.address >> 16) ^ endpoint.port);
+    return (unsigned int) ((unsigned short) (key * 40503u)) & (index_capacity_ - 1);
+}
+
+unsigned int CoAPDeduplicationCache::next(unsigned int slot) const {
+    return (slot + 1) & (index_capacity_ - 1);
+}
+
+/** Forgets the oldest message, index entries following it are moved back if they would not be found otherwise **/
+void CoAPDeduplicationCache::removeOldest() {
+    RecentMessage &oldest = messages_[head_];
+    unsigned int mask = index_capacity_ - 1;
+    unsigned int hole = home(oldest.message_id, oldest.endpoint);
+    while (index_[hole] != head_) {
+        hole = next(hole);
+    }
+
+    for (unsigned int current = next(hole); index_[current] != (unsigned short) NO_RECENT_MESSAGE; current = next(current)) {
+        const RecentMessage &message = messages_[index_[current]];
+        unsigned int current_home = home(message.message_id, message.endpoint);
+
+        if (((current - current_home) & mask) >= ((current - hole) & mask)) {
+            index_[hole] = index_[current];
+            hole = current;
+        }
+    }
+    index_[hole] = (unsigned short) NO_RECENT_MESSAGE;
+
+    oldest.response = CoAPMessage();
+    head_ = (head_ + 1) % capacity_;
+    --size_;
+}
+
+/** Forgets messages older than lifetime, they are all at the head of the ring **/
+void CoAPDeduplicationCache::removeExpired() {
+    unsigned long now = clock_->now();
+    while (size_ > 0 && now - messages_[head_].timestamp >= lifetime_) {
+        removeOldest();
+    }
+}
+
+/** Returns handle of message with given ID received from given endpoint within lifetime,
+ *  NO_RECENT_MESSAGE if it was not seen **/
+int CoAPDeduplicationCache::find(unsigned short message_id, const CoAPEndpoint &endpoint) {
+    removeExpired();
+
+    for (unsigned int slot = home(message_id, endpoint); index_[slot] != (unsigned short) NO_RECENT_MESSAGE; slot = next(slot)) {
+        const RecentMessage &message = messages_[index_[slot]];
+
+        if (message.message_id == message_id && message.endpoint == endpoint)
+            return index_[slot];
+    }
+    return NO_RECENT_MESSAGE;
+}
+
+/** Remembers message as not answered yet, forgetting the oldest one if cache is full. Returns its handle **/
+int CoAPDeduplicationCache::insert(unsigned short message_id, const CoAPEndpoint &endpoint) {
+    if (capacity_ == 0)
+        return NO_RECENT_MESSAGE;
+
+    removeExpired();
+    if (size_ == capacity_)
+        removeOldest();
+
+    unsigned int handle = (head_ + size_) % capacity_;
+    RecentMessage &message = messages_[handle];
+    message.message_id = message_id;
+    message.endpoint = endpoint;
+    message.timestamp = clock_->now();
+    message.answered = false;
+    ++size_;
+
+    unsigned int slot = home(message_id, endpoint);
+    while (index_[slot] != (unsigned short) NO_RECENT_MESSAGE) {
+        slot = next(slot);
+    }
+    index_[slot] = (unsigned short) handle;
+
+    return (int) handle;
+}
+
+/** Stores response sent to given message, so it can be sent again when duplicate arrives **/
+void CoAPDeduplicationCache::answer(unsigned short message_id, const CoAPEndpoint &endpoint, const CoAPMessage &response) {
+    int handle = find(message_id, endpoint);
+    if (handle == NO_RECENT_MESSAGE)
+        return;
+
+    messages_[handle].response = response;
+    messages_[handle].answered = true;
+}
+
+/** Returns message with given handle or nullptr if handle is not in use **/
+const RecentMessage *CoAPDeduplicationCache::at(int handle) const {
+    if (handle < 0 || (unsigned int) handle >= capacity_ || ((unsigned int) handle + capacity_ - head_) % capacity_ >= size_)
+        return nullptr;
+
+    return &messages_[handle];
+}
+
+/** Returns number of remembered messages **/
+unsigned int CoAPDeduplicationCache::size() const {
+    return size_;
+}
+
+/** Returns max number of remembered messages **/
+unsigned int CoAPDeduplicationCache::capacity() const {
+    return capacity_;
+}
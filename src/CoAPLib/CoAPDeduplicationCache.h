@@ -0,0 +1,59 @@
+#ifndef COAPLIB_COAPDEDUPLICATIONCACHE_H
+#define COAPLIB_COAPDEDUPLICATIONCACHE_H
+
+#include "CoAPClock.h"
+#include "CoAPEndpoint.h"
+#include "CoAPMessage.h"
+#include "../Environment.h"
+
+#define NO_RECENT_MESSAGE -1
+
+/**
+ * Request received recently, along with response if it was already sent
+ */
+struct RecentMessage {
+    unsigned short message_id;
+    CoAPEndpoint endpoint;
+    unsigned long timestamp;
+    bool answered;
+    CoAPMessage response;
+};
+
+/**
+ * Remembers requests for EXCHANGE_LIFETIME, so duplicates sent by retransmitting clients can be
+ * recognized (RFC 7252, section 4.5). Messages are kept in a ring in order of arrival, so expired ones
+ * are always at its head. When ring is full the oldest message is forgotten. Messages are found through
+ * an open-addressing index keyed by message ID and endpoint.
+ */
+class CoAPDeduplicationCache {
+private:
+    const CoAPClock* clock_;
+    RecentMessage* messages_;
+    unsigned short* index_;
+    unsigned int capacity_;
+    unsigned int index_capacity_;
+    unsigned int head_;
+    unsigned int size_;
+    unsigned long lifetime_;
+
+    unsigned int home(unsigned short message_id, const CoAPEndpoint &endpoint) const;
+    unsigned int next(unsigned int slot) const;
+    void removeOldest();
+    void removeExpired();
+
+    CoAPDeduplicationCache(const CoAPDeduplicationCache &cache);
+    CoAPDeduplicationCache &operator=(const CoAPDeduplicationCache &cache);
+public:
+    CoAPDeduplicationCache(const CoAPClock &clock, unsigned int capacity, unsigned long lifetime = EXCHANGE_LIFETIME);
+    ~CoAPDeduplicationCache();
+
+    int find(unsigned short message_id, const CoAPEndpoint &endpoint);
+    int insert(unsigned short message_id, const CoAPEndpoint &endpoint);
+    void answer(unsigned short message_id, const CoAPEndpoint &endpoint, const CoAPMessage &response);
+    const RecentMessage *at(int handle) const;
+
+    unsigned int size() const;
+    unsigned int capacity() const;
+};
+
+#endif //COAPLIB_COAPDEDUPLICATIONCACHE_H
@@ -0,0 +1,24 @@
+#ifndef COAPLIB_COAPENDPOINT_H
+#define COAPLIB_COAPENDPOINT_H
+
+/**
+ * Identifies remote side of CoAP communication, IPv4 address is kept in network order.
+ * Default endpoint (all zeros) stands for the only client, when transport does not tell them apart.
+ */
+struct CoAPEndpoint {
+    unsigned long address;
+    unsigned short port;
+
+    CoAPEndpoint() : address(0), port(0) {}
+    CoAPEndpoint(unsigned long address, unsigned short port) : address(address), port(port) {}
+
+    bool operator==(const CoAPEndpoint &endpoint) const {
+        return address == endpoint.address && port == endpoint.port;
+    }
+
+    bool operator!=(const CoAPEndpoint &endpoint) const {
+        return !(*this == endpoint);
+    }
+};
+
+#endif //COAPLIB_COAPENDPOINT_H
@@ -1,81 +1,115 @@
 #include "CoAPHandler.h"
 
+static CoAPClock system_clock;
+
+/** Sets up CoAPHandler which measures time with millis() **/
+CoAPHandler::CoAPHandler(CoAPMessageListener &coapMessageListener, RadioMessageListener &radioMessageListener) :
+        CoAPHandler(coapMessageListener, radioMessageListener, system_clock) {}
+
 /** Sets up CoAPHandler, binds callbacks used to process radio and internet input,
- * defines both local and remote resources.
+ * built-in resources come from compile-time route table. All timeouts are measured with given clock.
  */
-CoAPHandler::CoAPHandler(CoAPMessageListener &coapMessageListener, RadioMessageListener &radioMessageListener) :
+CoAPHandler::CoAPHandler(CoAPMessageListener &coapMessageListener, RadioMessageListener &radioMessageListener,
+                         const CoAPClock &clock) :
         coapMessageListener_(&coapMessageListener),
         radioMessageListener_(&radioMessageListener),
-        resources_() {
-    prepareSpeakerResource();
-    prepareLampResource();
-    prepareRttResource();
-    prepareJitterResource();
-    prepareTimedOutResource();
-}
-
-/** Creates "TimedOut" resource **/
-void CoAPHandler::prepareTimedOutResource() {
-    Array<String> uri_path;
-    uri_path.pushBack(RESOURCE_LOCAL);
-    uri_path.pushBack(RESOURCE_TIMED_OUT);
-    resources_.insert(uri_path, nullptr);
+        clock_(&clock),
+        pending_messages_(PENDING_MESSAGES_CAPACITY),
+        timers_(PENDING_MESSAGES_CAPACITY),
+        retransmitter_(clock, RETRANSMISSIONS_CAPACITY),
+        recent_messages_(clock, DEDUPLICATION_CAPACITY),
+        response_cache_(clock, RESPONSE_CACHE_CAPACITY),
+        next_message_id_((unsigned short) clock.now()),
+        next_radio_id_((unsigned short) clock.now()),
+        block_assembler_(BLOCK1_TRANSFERS_CAPACITY, MAX_BLOCK1_BODY_SIZE),
+        core_resource_(*this),
+        rtt_resource_(mean_rtt),
+        jitter_resource_(last_jitter),
+        timed_out_resource_(timed_out) {
+    routes_[ROUTE_CORE].setHandler(&core_resource_);
+    routes_[ROUTE_RTT].setHandler(&rtt_resource_);
+    routes_[ROUTE_JITTER].setHandler(&jitter_resource_);
+    routes_[ROUTE_TIMED_OUT].setHandler(&timed_out_resource_);
 }
 
-/** Creates "Jitter" resource **/
-void CoAPHandler::prepareJitterResource() {
-    Array<String> uri_path;
-    uri_path.pushBack(RESOURCE_LOCAL);
-    uri_path.pushBack(RESOURCE_JITTER);
-    resources_.insert(uri_path, nullptr);
+CoAPHandler::~CoAPHandler() {
+    delete resources_;
 }
 
-/** Creates "Rtt" resource **/
-void CoAPHandler::prepareRttResource() {
-    Array<String> uri_path;
-    uri_path.pushBack(RESOURCE_LOCAL);
-    uri_path.pushBack(RESOURCE_RTT);
-    resources_.insert(uri_path, nullptr);
-}
-
-/** Creates "Lamp" resource and maps it with resource number used in communication through radio**/
-void CoAPHandler::prepareLampResource() {
-    Array<String> uri_path;
-    uri_path.pushBack(RESOURCE_REMOTE);
-    uri_path.pushBack(RESOURCE_LAMP);
-    resources_.insert(uri_path, new unsigned short(RADIO_LAMP));
-}
+/** Serializes CoAP message and handles it the same way as message parsed straight from receive buffer **/
+void CoAPHandler::handleMessage(CoAPMessage &message, const CoAPEndpoint &endpoint) {
+    ByteArray buffer(message.serializedSize());
+    CoAPMessageView view;
 
-/** Creates "Speker" resource and maps it with resource number used in communication through radio**/
-void CoAPHandler::prepareSpeakerResource() {
-    Array<String> uri_path;
-    uri_path.pushBack(RESOURCE_REMOTE);
-    uri_path.pushBack(RESOURCE_SPEAKER);
-    resources_.insert(uri_path, new unsigned short(RADIO_SPEAKER));
+    if (view.parse(buffer.begin(), message.serialize(buffer.begin(), buffer.capacity())))
+        handleMessage(view, endpoint);
+    else
+        handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
 }
 
-/** Categorizes CoAP message to adequate category based on it's code (eg. GET, PUT) and calls suitable method **/
-void CoAPHandler::handleMessage(CoAPMessage &message) {
+/** Categorizes CoAP message to adequate category based on it's code (eg. GET, PUT) and calls suitable method.
+ *  Responses and later notifications are sent to given endpoint, from which message has come. **/
+void CoAPHandler::handleMessage(const CoAPMessageView &message, const CoAPEndpoint &endpoint) {
     DEBUG_PRINT_TIME();
     DEBUG_PRINTLN("RECEIVED");
     DEBUG_FUNCTION(message.print());
 
     if(message.getCode() == CODE_EMPTY) {
-        handlePing(message);
+        handlePing(message, endpoint);
     }
-    else if(message.getCode() == CODE_GET || message.getCode() == CODE_PUT) {
-        handleRequest(message);
+    else if(message.getCode() >= CODE_GET && message.getCode() <= CODE_DELETE) {
+        if (!isDuplicate(message, endpoint))
+            handleRequest(message, endpoint);
     }
     else {
-        handleBadRequest(message, CODE_BAD_REQUEST);
+        handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
+    }
+}
+
+/** Rejects confirmable request which failed to parse, so client does not retransmit it: malformed options
+ *  are answered with 4.02, other errors with 4.00. Messages which header could not be decoded and
+ *  non-confirmable ones are ignored. **/
+void CoAPHandler::handleMalformed(const CoAPMessageView &message, const CoAPEndpoint &endpoint) {
+    if (message.getError() < PARSE_BAD_TOKEN || message.getT() != TYPE_CON
+        || message.getCode() < CODE_GET || message.getCode() > CODE_DELETE)
+        return;
+
+    DEBUG_PRINT_TIME();
+    DEBUG_PRINTLN("MALFORMED");
+
+    handleBadRequest(message, endpoint, message.getError() == PARSE_BAD_OPTION ? CODE_BAD_OPTION : CODE_BAD_REQUEST);
+}
+
+/** Tells if request was already received from the same endpoint. Response to duplicate is sent again,
+ *  duplicate of request which is still being served (eg. waits for radio reply) is ignored. **/
+bool CoAPHandler::isDuplicate(const CoAPMessageView &message, const CoAPEndpoint &endpoint) {
+    int handle = recent_messages_.find(message.getMessageId(), endpoint);
+
+    if (handle == NO_RECENT_MESSAGE) {
+        recent_messages_.insert(message.getMessageId(), endpoint);
+        return false;
     }
+
+    const RecentMessage *recentMessage = recent_messages_.at(handle);
+    DEBUG_PRINT_TIME();
+    DEBUG_PRINTLN(recentMessage->answered ? "DUPLICATE, RESPONSE SENT AGAIN" : "DUPLICATE, IGNORED");
+    if (recentMessage->answered)
+        send(recentMessage->response, endpoint);
+    return true;
 }
 
-/** Responds with RST message if message is CoAP Ping. **/
-void CoAPHandler::handlePing(const CoAPMessage &message) {
-    if (message.getT() == TYPE_ACK) {
-        PendingMessage pendingMessage = finalizePendingMessage((unsigned short) (ping_messages_sent - 1));
-        updateMetrics((unsigned short) (millis() - pendingMessage.timestamp));
+/** Responds to CoAP Ping, or stops retransmitting our message if it was acknowledged or rejected. **/
+void CoAPHandler::handlePing(const CoAPMessageView &message, const CoAPEndpoint &endpoint) {
+    if (message.getT() == TYPE_ACK || message.getT() == TYPE_RST) {
+        int handle = retransmitter_.find(message.getMessageId(), endpoint);
+        const CoAPTransmission *transmission = retransmitter_.at(handle);
+
+        if (transmission != nullptr) {
+            // RTT of retransmitted message is ambiguous, it's not known which copy was answered
+            if (transmission->message.getCode() == CODE_EMPTY && transmission->retransmissions == 0)
+                updateMetrics((unsigned short) (clock_->now() - transmission->first_sent));
+            retransmitter_.release(handle);
+        }
     }
     else {
         CoAPMessage response;
@@ -84,72 +118,144 @@ void CoAPHandler::handlePing(const CoAPMessage &message) {
         response.setT(TYPE_ACK);
         response.setMessageId(message.getMessageId());
 
-        send(response);
+        send(response, endpoint);
     }
 }
 
 /** Parses options and prepares radio or CoAP message with proper options **/
-void CoAPHandler::handleRequest(const CoAPMessage &message) {
+void CoAPHandler::handleRequest(const CoAPMessageView &message, const CoAPEndpoint &endpoint) {
     CoAPMessage coapResponse;
     RadioMessage radioResponse;
     bool sendRadioMessage = false;
-    CoAPOption* iterator = message.getOptions().begin();
-    CoAPOption* end = message.getOptions().end();
+    CoAPMessageView::OptionIterator iterator = message.beginOptions();
+    CoAPMessageView::OptionIterator end = message.endOptions();
     int option_id = 0;
+    long observe = -1;
+    TokenArray token;
+    token.deserialize(message.getToken().begin(), message.getToken().size());
+    ByteView payload = message.getPayload();
+    ByteArray body;
+
+    // Block options follow Uri-Path, but they are needed to prepare response, so they are looked up first
+    Block2 block2;
+    unsigned short block_code = toRequestedBlock(message.findOption(OPTION_BLOCK2), end, block2);
+    if (block_code != CODE_EMPTY) {
+        handleBadRequest(message, endpoint, block_code);
+        return;
+    }
 
-    for(; iterator != end; iterator++) {
+    for(; iterator != end; ++iterator) {
         option_id = iterator->getNumber();
 
         switch(option_id) {
             case OPTION_URI_PATH:
                 {
-                    Array<String> uri_path;
-                    while (((iterator + 1) != end) && ((iterator + 1)->getNumber() == OPTION_URI_PATH)) {
-                        uri_path.pushBack(iterator->toString());
-                        ++iterator;
-                    }
-                    uri_path.pushBack(iterator->toString());
-
-                    Node* resource = resources_.search(uri_path);
+                    long radio_resource;
+                    Node* resource = findResource(iterator, end, radio_resource);
 
                     if (resource != nullptr) {
-                        if (uri_path[0] == RESOURCE_REMOTE) {
-                            unsigned short resourceId = *resource->getValue();
-                            sendRadioMessage = true;
-                            createResponse(message, radioResponse);
-                            radioResponse.resource = resourceId;
-                            addPendingMessage(message);
-                        }
-                        else if(message.getCode() == CODE_GET) {
-                            if (uri_path[0] == RESOURCE_WELL_KNOWN) {
+                        if (radio_resource != NO_RADIO_RESOURCE) {
+                            // Radio interface knows only GET and PUT
+                            if (message.getCode() != CODE_GET && message.getCode() != CODE_PUT) {
+                                handleBadRequest(message, endpoint, CODE_METHOD_NOT_ALLOWED);
+                                return;
+                            }
+                            if (message.getCode() == CODE_GET)
+                                updateObserver(resource, endpoint, token, observe);
+
+                            unsigned short resourceId = (unsigned short) radio_resource;
+                            unsigned long value;
+                            unsigned long max_age;
+
+                            if (message.getCode() == CODE_GET && response_cache_.find(resourceId, value, max_age)) {
                                 createResponse(message, coapResponse);
-                                coapResponse.addOption(toContentFormat(CONTENT_LINK_FORMAT));
-                                coapResponse.setPayload(toByteArray(RESOURCE_ALL1));
+                                coapResponse.addOption(toContentFormat(CONTENT_TEXT_PLAIN));
+                                coapResponse.addOption(toUintOption(OPTION_MAX_AGE, max_age));
+                                addObserveOption(resource, endpoint, token, coapResponse);
+                                setBlockPayload(coapResponse, TO_STRING(value), block2);
                             }
-                            else if (uri_path[0] == RESOURCE_LOCAL) {
-                                if(resource->getKey() == RESOURCE_JITTER) {
-                                    createResponse(message, coapResponse);
-                                    coapResponse.addOption(toContentFormat(CONTENT_TEXT_PLAIN));
-                                    coapResponse.setPayload(toByteArray(TO_STRING(last_jitter)));
+                            else {
+                                if (message.getCode() == CODE_PUT)
+                                    response_cache_.invalidate(resourceId);
+
+                                CoAPMessageView::OptionIterator block1 = message.findOption(OPTION_BLOCK1);
+                                bool blockwise = message.getCode() == CODE_PUT && block1 != end;
+                                Block2 last_block;
+                                if (blockwise) {
+                                    last_block = block1->toBlock2();
+                                    if (!receiveBlock(message, endpoint, resource, last_block, body))
+                                        return;
+                                    payload = ByteView(body.begin(), body.size());
                                 }
-                                else if(resource->getKey() == RESOURCE_RTT) {
-                                    createResponse(message, coapResponse);
-                                    coapResponse.addOption(toContentFormat(CONTENT_TEXT_PLAIN));
-                                    coapResponse.setPayload(toByteArray(TO_STRING(mean_rtt)));
+
+                                sendRadioMessage = addPendingMessage(message, endpoint, resource,
+                                                                     blockwise ? &last_block : nullptr,
+                                                                     radioResponse.message_id);
+                                if (sendRadioMessage) {
+                                    createResponse(message, radioResponse);
+                                    radioResponse.resource = resourceId;
                                 }
-                                else if(resource->getKey() == RESOURCE_TIMED_OUT) {
-                                    createResponse(message, coapResponse);
-                                    coapResponse.addOption(toContentFormat(CONTENT_TEXT_PLAIN));
-                                    coapResponse.setPayload(toByteArray(TO_STRING(timed_out)));
+                                else {
+                                    handleBadRequest(message, endpoint, CODE_SERVICE_UNAVAILABLE);
+                                    return;
                                 }
                             }
                         }
+                        else if (resource->getHandler() != nullptr) {
+                            CoAPResourceHandler *handler = resource->getHandler();
+                            bool observable = message.getCode() == CODE_GET && handler->isObservable();
+                            if (observable)
+                                updateObserver(resource, endpoint, token, observe);
+
+                            // Body sent in blocks is passed to handler only when complete, in request rebuilt around it
+                            CoAPMessageView request = message;
+                            ByteArray buffer;
+                            CoAPMessageView::OptionIterator block1 = message.findOption(OPTION_BLOCK1);
+                            bool blockwise = (message.getCode() == CODE_POST || message.getCode() == CODE_PUT)
+                                             && block1 != end;
+                            if (blockwise) {
+                                if (!receiveBlock(message, endpoint, resource, block1->toBlock2(), body))
+                                    return;
+                                replacePayload(message, ByteView(body.begin(), body.size()), buffer, request);
+                            }
+
+                            createResponse(message, coapResponse);
+                            unsigned short code = handler->handle(request, coapResponse);
+                            if (isError(code)) {
+                                handleBadRequest(message, endpoint, code);
+                                return;
+                            }
+
+                            coapResponse.setCode(code);
+                            if (observable)
+                                addObserveOption(resource, endpoint, token, coapResponse);
+                            if (blockwise)
+                                coapResponse.addOption(CoAPOption(OPTION_BLOCK1, block1->toBlock2()));
+
+                            ByteView representation;
+                            if (message.getCode() == CODE_GET && handler->getRepresentation(request, representation))
+                                setBlockPayload(coapResponse, representation, block2);
+                            else
+                                applyBlock(coapResponse, block2);
+
+                            // Options following Uri-Path (eg. Content-Format) are checked only for radio requests,
+                            // handler has already read from request what it needs
+                            if (coapResponse.getCode() == CODE_BAD_OPTION)
+                                handleBadRequest(message, endpoint, CODE_BAD_OPTION);
+                            else
+                                respond(message, endpoint, coapResponse);
+                            return;
+                        }
                         else {
-                            handleBadRequest(message, CODE_BAD_REQUEST);
+                            handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
+                            return;
                         }
                     }
                 }
                 break;
+            case OPTION_OBSERVE:
+                observe = (long) toUnsignedLong(iterator->getValue());
+                break;
             case OPTION_CONTENT_FORMAT:
             {
                 if(message.getCode() == CODE_PUT) {
@@ -157,14 +263,17 @@ void CoAPHandler::handleRequest(const CoAPMessage &message) {
                     unsigned short content_format_type = toUnsignedShort(s_value);
 
                     if(content_format_type == CONTENT_TEXT_PLAIN) {
-                        String s_payload = toString(message.getPayload());
-                        unsigned short payload = toUnsignedShort(s_payload);
-                        radioResponse.value = payload;
+                        if (!toNumber(payload, radioResponse.value)) {
+                            if (sendRadioMessage)
+                                cancelPendingMessage(radioResponse.message_id);
+                            handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
+                            return;
+                        }
                     } else {
-                        handleBadRequest(message, CODE_NOT_IMPLEMENTED);
+                        handleBadRequest(message, endpoint, CODE_NOT_IMPLEMENTED);
                     }
                 } else {
-                    handleBadRequest(message, CODE_BAD_REQUEST);
+                    handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
                 }
             }
             break;
@@ -179,48 +288,370 @@ void CoAPHandler::handleRequest(const CoAPMessage &message) {
                 }
             }
             break;
+            case OPTION_URI_QUERY:
+                // Queries are used only as link format filters
+                break;
+            case OPTION_BLOCK1:
             case OPTION_BLOCK2:
-                {
-                    Block2 values(iterator->toBlock2());
-                    values.m = 0;
-                    CoAPOption option(values);
-                    coapResponse.addOption(option);
-                }
+            case OPTION_SIZE1:
+            case OPTION_SIZE2:
+                // Block options were already used, size options are only informative
                 break;
             default:
-                handleBadRequest(message, CODE_BAD_REQUEST);
+                handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
                 break;
         }
     }
 
-    if(sendRadioMessage)
+    if(sendRadioMessage) {
+        // Radio node would never get request which can not be encoded (eg. too big value for legacy format)
+        if (!radioResponse.fits()) {
+            cancelPendingMessage(radioResponse.message_id);
+            handleBadRequest(message, endpoint, CODE_BAD_REQUEST);
+            return;
+        }
         send(radioResponse);
+    }
+    else if (coapResponse.getCode() == CODE_BAD_OPTION)
+        handleBadRequest(message, endpoint, CODE_BAD_OPTION);
     else
-        send(coapResponse);
+        respond(message, endpoint, coapResponse);
 }
 
-/** Handles RadioMessage, gets value from it and creates CoAP response **/
+/** Finds resource addressed by Uri-Path options starting at given one, leaving iterator at the last of them.
+ *  Resources registered at runtime take precedence over built-in routes with the same path. **/
+Node *CoAPHandler::findResource(CoAPMessageView::OptionIterator &iterator, const CoAPMessageView::OptionIterator &end,
+                                long &radio_resource) {
+    ByteView branch = iterator->getValue();
+    ByteView key;
+    unsigned int segments = 1;
+    Node* resource = resources_ != nullptr ? resources_->findChild(resources_->getRoot(), branch) : nullptr;
+
+    CoAPMessageView::OptionIterator next = iterator;
+    while ((++next != end) && (next->getNumber() == OPTION_URI_PATH)) {
+        iterator = next;
+        if (++segments == 2)
+            key = iterator->getValue();
+        if (resource != nullptr)
+            resource = resources_->findChild(resource, iterator->getValue());
+    }
+
+    StaticRouteId route = NO_ROUTE;
+    radio_resource = NO_RADIO_RESOURCE;
+
+    if (resource != nullptr && resource->getHandler() != nullptr)
+        return resource;
+
+    if (resource != nullptr && resource->getValue() != nullptr && branch == RESOURCE_REMOTE) {
+        radio_resource = *resource->getValue();
+        return resource;
+    }
+
+    if (segments == 2)
+        route = CoAPRoutes::find(branch, key);
+    if (route == NO_ROUTE)
+        return resource;
+
+    radio_resource = CoAPRoutes::at(route).radio_resource;
+    return &routes_[route];
+}
+
+/** Reads block of response requested by client, by default the first block of the biggest size.
+ *  If client asks for bigger blocks than supported, block number is scaled to smaller size.
+ *  Returns CODE_EMPTY, 4.00 for reserved block size or 4.02 if scaled block number does not fit into option **/
+unsigned short CoAPHandler::toRequestedBlock(const CoAPMessageView::OptionIterator &option,
+                                             const CoAPMessageView::OptionIterator &end, Block2 &block) {
+    block = {0, 0, MAX_BLOCK_SZX};
+    if (option == end)
+        return CODE_EMPTY;
+
+    block = option->toBlock2();
+    block.m = 0;
+    if (block.szx == RESERVED_BLOCK_SZX)
+        return CODE_BAD_REQUEST;
+
+    if (block.szx > MAX_BLOCK_SZX) {
+        unsigned long num = (unsigned long) block.num << (block.szx - MAX_BLOCK_SZX);
+        if (num >= (1UL << BLOCK_NUM_BITS))
+            return CODE_BAD_OPTION;
+
+        block.num = num;
+        block.szx = MAX_BLOCK_SZX;
+    }
+    return CODE_EMPTY;
+}
+
+/** Sets payload of response to given block of representation. If representation does not fit into
+ *  a single block, Block2 option is added, along with Size2 option in the first block.
+ *  Block out of range of representation turns response into 4.02 Bad Option. **/
+void CoAPHandler::setBlockPayload(CoAPMessage &response, const String &representation, const Block2 &block) {
+    setBlockPayload(response, ByteView((const unsigned char *) representation.c_str(), representation.length()), block);
+}
+
+void CoAPHandler::setBlockPayload(CoAPMessage &response, const ByteView &representation, const Block2 &block) {
+    unsigned int block_size = 1u << block.szx;
+    unsigned long offset = (unsigned long) block.num * block_size;
+    unsigned int length = representation.size();
+
+    if (block.num > 0 && offset >= length) {
+        response.setCode(CODE_BAD_OPTION);
+        return;
+    }
+
+    unsigned int payload_size = length - offset < block_size ? length - offset : block_size;
+    ByteArray payload(payload_size);
+    payload.deserialize(representation.begin() + offset, payload_size);
+
+    if (length > block_size) {
+        Block2 sent_block = block;
+        sent_block.m = offset + payload_size < length;
+        response.addOption(CoAPOption(sent_block));
+        if (block.num == 0)
+            response.addOption(toUintOption(OPTION_SIZE2, length));
+    }
+    response.setPayload(payload);
+}
+
+/** Sets payload of response to given block of its current payload, if payload does not fit into the block
+ *  or client asked for further block **/
+void CoAPHandler::applyBlock(CoAPMessage &response, const Block2 &block) {
+    const ByteArray &payload = response.getPayload();
+
+    if (block.num > 0 || payload.size() > (1u << block.szx))
+        setBlockPayload(response, ByteView(payload.begin(), payload.size()), block);
+}
+
+/** Tells if response code is client or server error **/
+bool CoAPHandler::isError(unsigned short code) {
+    return (code >> 5) >= 4;
+}
+
+CoAPHandler::WellKnownCoreResource::WellKnownCoreResource(CoAPHandler &handler) : handler_(&handler) {}
+
+/** Sends link format document of the handler filtered by Uri-Query options, unfiltered document
+ *  is served by getRepresentation straight from the cache **/
+unsigned short CoAPHandler::WellKnownCoreResource::get(const CoAPMessageView &request, CoAPMessage &response) {
+    CoAPMessageView::OptionIterator end = request.endOptions();
+    CoAPMessageView::OptionIterator query = request.findOption(OPTION_URI_QUERY);
+
+    response.addOption(handler_->toContentFormat(CONTENT_LINK_FORMAT));
+    if (query == end)
+        return CODE_CONTENT;
+
+    const CoAPLinkFormat &links = handler_->getLinkFormat();
+    Array<ByteView> queries;
+    for (; query != end; query = request.findOption(OPTION_URI_QUERY, ++query)) {
+        queries.pushBack(query->getValue());
+    }
+
+    ByteArray filtered;
+    links.filter(queries, filtered);
+    response.setPayload(filtered);
+    return CODE_CONTENT;
+}
+
+/** Points at cached link format document, if request has no Uri-Query options **/
+bool CoAPHandler::WellKnownCoreResource::getRepresentation(const CoAPMessageView &request, ByteView &representation) {
+    if (request.findOption(OPTION_URI_QUERY) != request.endOptions())
+        return false;
+
+    representation = handler_->getLinkFormat().getDocument();
+    return true;
+}
+
+/** Returns link format document describing built-in and registered resources.
+ *  Document is built again only after new resource is registered. **/
+const CoAPLinkFormat &CoAPHandler::getLinkFormat() {
+    if (!links_.isValid()) {
+        links_.clear();
+
+        for (unsigned int i = 0; i < ROUTES_COUNT; ++i) {
+            const StaticRoute &route = CoAPRoutes::at((StaticRouteId) i);
+            Array<String> uri_path;
+            uri_path.pushBack(route.branch);
+            uri_path.pushBack(route.key);
+
+            // Discovery resource is not listed, neither are built-in resources registered again
+            if (i == ROUTE_CORE || (resources_ != nullptr && resources_->search(uri_path) != nullptr))
+                continue;
+
+            links_.addLink(String("/") + route.branch + "/" + route.key);
+            links_.addAttribute("rt", route.type, true);
+            if (route.radio_resource != NO_RADIO_RESOURCE)
+                links_.addAttribute("value", TO_STRING(route.radio_resource), false);
+        }
+
+        if (resources_ != nullptr)
+            links_.addLinks(resources_->getLinkFormat());
+    }
+    return links_;
+}
+
+/** Adds block of request body sent by client to the transfer. Returns CODE_CONTINUE if more blocks are expected,
+ *  CODE_EMPTY if body is complete or error code which should be sent to client **/
+unsigned short CoAPHandler::appendBlock(const CoAPMessageView &message, const CoAPEndpoint &endpoint,
+                                        const Node *resource, const Block2 &block, ByteArray &body) {
+    if (block.szx == RESERVED_BLOCK_SZX)
+        return CODE_BAD_REQUEST;
+    if (block.szx > MAX_BLOCK_SZX)
+        return CODE_REQUEST_ENTITY_TOO_LARGE;
+
+    return block_assembler_.append(endpoint, resource, block, message.getPayload(), body);
+}
+
+/** Adds block of request body to its transfer. Returns true when body is complete, otherwise answers request
+ *  with 2.31 Continue or error code and returns false **/
+bool CoAPHandler::receiveBlock(const CoAPMessageView &message, const CoAPEndpoint &endpoint, const Node *resource,
+                               const Block2 &block, ByteArray &body) {
+    unsigned short code = appendBlock(message, endpoint, resource, block, body);
+
+    if (code == CODE_CONTINUE) {
+        CoAPMessage response;
+        createResponse(message, response);
+        response.setCode(CODE_CONTINUE);
+        response.addOption(CoAPOption(OPTION_BLOCK1, block));
+        respond(message, endpoint, response);
+        return false;
+    }
+    else if (code != CODE_EMPTY) {
+        handleBadRequest(message, endpoint, code);
+        return false;
+    }
+    return true;
+}
+
+/** Serializes given request again into given buffer with given payload, header, token and options stay the same **/
+void CoAPHandler::replacePayload(const CoAPMessageView &message, const ByteView &payload, ByteArray &buffer,
+                                 CoAPMessageView &request) {
+    ByteView old_payload = message.getPayload();
+    unsigned int header_size = old_payload.size() > 0
+                               ? (unsigned int) (old_payload.begin() - 1 - message.getBuffer())
+                               : message.getSize();
+
+    buffer = ByteArray(header_size + 1 + payload.size());
+    buffer.deserialize(message.getBuffer(), header_size);
+    if (payload.size() > 0) {
+        buffer.pushBack(0xFF);
+        for (unsigned int i = 0; i < payload.size(); ++i) {
+            buffer.pushBack(payload[i]);
+        }
+    }
+    request.parse(buffer.begin(), buffer.size());
+}
+
+/** Handles RadioMessage, gets value from it and creates CoAP response for endpoint which sent the request.
+ *  Value read by GET is cached, so following GET requests do not need radio round-trip.
+ *  If value has changed, observers of resource are notified. **/
 void CoAPHandler::handleMessage(RadioMessage &radioMessage) {
     DEBUG_PRINT_TIME();
     DEBUG_PRINTLN("RECEIVED");
     DEBUG_FUNCTION(radioMessage.print());
 
-    PendingMessage pendingMessage = finalizePendingMessage(radioMessage.message_id);
-    if (pendingMessage.timestamp != 0) {
-        CoAPMessage message;
-        message = pendingMessage.coapMessage;
+    PendingMessage pendingMessage;
+    if (finalizePendingMessage(radioMessage.message_id, pendingMessage)) {
+        notifyObservers(pendingMessage.resource, radioMessage.value, &pendingMessage);
 
         CoAPMessage response;
-        createResponse(message, response);
+        createResponse(pendingMessage, response);
         response.addOption(toContentFormat(0));
+        if (pendingMessage.blockwise)
+            response.addOption(CoAPOption(OPTION_BLOCK1, pendingMessage.block1));
+        if (pendingMessage.code == CODE_GET)
+            addObserveOption(pendingMessage.resource, pendingMessage.endpoint, pendingMessage.token, response);
+
+        if (pendingMessage.code == CODE_GET && response_cache_.getMaxAge() > 0) {
+            response_cache_.store(radioMessage.resource, radioMessage.value);
+            response.addOption(toUintOption(OPTION_MAX_AGE, response_cache_.getMaxAge()));
+        }
+        else {
+            response_cache_.invalidate(radioMessage.resource);
+        }
+
         response.setPayload(toByteArray(TO_STRING(radioMessage.value)));
-        send(response);
+        respond(pendingMessage, pendingMessage.endpoint, response);
     }
 
 }
 
+/** Registers or deregisters observer of resource, depending on value of Observe option (-1 if there was none) **/
+void CoAPHandler::updateObserver(Node *resource, const CoAPEndpoint &endpoint, const TokenArray &token, long observe) {
+    if (observe == OBSERVE_REGISTER) {
+        resource->addObserver(endpoint, token);
+    }
+    else if (observe == OBSERVE_DEREGISTER && resource->getObservers() != nullptr) {
+        resource->getObservers()->remove(endpoint, token);
+    }
+}
+
+/** Adds Observe option with current sequence number to response if its receiver observes given resource **/
+void CoAPHandler::addObserveOption(const Node *resource, const CoAPEndpoint &endpoint, const TokenArray &token,
+                                   CoAPMessage &response) {
+    const CoAPObservers *observers = resource != nullptr ? resource->getObservers() : nullptr;
+
+    if (observers != nullptr && observers->contains(endpoint, token))
+        response.addOption(toUintOption(OPTION_OBSERVE, observers->getSequence()));
+}
+
+/** Sends notification to every observer of resource if its value has changed.
+ *  Observer which sent given request is skipped, because it gets regular response **/
+void CoAPHandler::notifyObservers(Node *resource, unsigned long value, const PendingMessage *except) {
+    CoAPObservers *observers = resource != nullptr ? resource->getObservers() : nullptr;
+
+    if (observers == nullptr || !observers->update(value))
+        return;
+
+    // Handler resource is notified with the same representation as its GET response
+    CoAPMessage notification;
+    notification.setT(TYPE_NON);
+    notification.addOption(toUintOption(OPTION_OBSERVE, observers->getSequence()));
+    if (resource->getHandler() != nullptr) {
+        if (!createNotification(*resource->getHandler(), notification))
+            return;
+    }
+    else {
+        notification.setCode(CODE_CONTENT);
+        notification.addOption(toContentFormat(CONTENT_TEXT_PLAIN));
+        notification.setPayload(toByteArray(TO_STRING(value)));
+    }
+
+    for (unsigned int i = 0; i < observers->size(); ++i) {
+        const Observer &observer = (*observers)[i];
+        if (except != nullptr && observer.endpoint == except->endpoint
+            && ByteView(observer.token.begin(), observer.token.size())
+               == ByteView(except->token.begin(), except->token.size()))
+            continue;
+
+        notification.setMessageId(next_message_id_++);
+        notification.setToken(observer.token);
+        send(notification, observer.endpoint);
+    }
+}
+
+/** Fills notification with representation served by GET of given handler, the first block of it if it is too big.
+ *  Returns false if handler answered with error. **/
+bool CoAPHandler::createNotification(CoAPResourceHandler &handler, CoAPMessage &notification) {
+    // Empty non-confirmable GET, handler sees request without any options
+    unsigned char buffer[] = {0x50, CODE_GET, 0x00, 0x00};
+    CoAPMessageView request;
+    request.parse(buffer, sizeof(buffer));
+
+    unsigned short code = handler.get(request, notification);
+    if (isError(code))
+        return false;
+
+    notification.setCode(code);
+    Block2 block = {0, 0, MAX_BLOCK_SZX};
+    ByteView representation;
+    if (handler.getRepresentation(request, representation))
+        setBlockPayload(notification, representation, block);
+    else
+        applyBlock(notification, block);
+    return true;
+}
+
 /** Creates adequate CoAP response, based on received message TYPE **/
-void CoAPHandler::createResponse(const CoAPMessage &message, CoAPMessage &response) {
+template <typename Message>
+void CoAPHandler::createResponse(const Message &message, CoAPMessage &response) {
     response.setToken(message.getToken());
 
     if (message.getT() == TYPE_CON) {
@@ -237,9 +668,8 @@ void CoAPHandler::createResponse(const CoAPMessage &message, CoAPMessage &respon
         response.setCode(68); //if put then code 2.04 -changed
 }
 
-/** Creates reponse based on radio response **/
-void CoAPHandler::createResponse(const CoAPMessage &message, RadioMessage &response) {
-    response.message_id = message.getMessageId();
+/** Creates radio request based on CoAP request, its message ID is assigned when request is added to pending ones **/
+void CoAPHandler::createResponse(const CoAPMessageView &message, RadioMessage &response) {
     if (message.getCode() == CODE_GET) {
         response.code = RADIO_GET;
     }
@@ -248,7 +678,8 @@ void CoAPHandler::createResponse(const CoAPMessage &message, RadioMessage &respo
     }
 }
 /** Prepares response with given error code and sends it to browser client**/
-void CoAPHandler::handleBadRequest(const CoAPMessage &message, unsigned short error_code) {
+template <typename Message>
+void CoAPHandler::handleBadRequest(const Message &message, const CoAPEndpoint &endpoint, unsigned short error_code) {
     CoAPMessage response;
 
     response.setToken(message.getToken());
@@ -261,17 +692,24 @@ void CoAPHandler::handleBadRequest(const CoAPMessage &message, unsigned short er
     }
     response.setCode(error_code);
 
-    send(response);
+    respond(message, endpoint, response);
+}
+
+/** Sends response to given request and remembers it, so it can be sent again if request is duplicated **/
+template <typename Message>
+void CoAPHandler::respond(const Message &request, const CoAPEndpoint &endpoint, const CoAPMessage &response) {
+    recent_messages_.answer(request.getMessageId(), endpoint, response);
+    send(response, endpoint);
 }
 
-/** This callback tells CoApServer.ino to send given CoAPMessage**/
-void CoAPHandler::send(const CoAPMessage &message) {
+/** This callback tells CoApServer.ino to send given CoAPMessage to given endpoint**/
+void CoAPHandler::send(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
     DEBUG_PRINT_TIME();
     DEBUG_PRINTLN("SENT");
     DEBUG_FUNCTION(message.print());
 
     if (coapMessageListener_ != nullptr)
-        (*coapMessageListener_)(message);
+        (*coapMessageListener_)(message, endpoint);
 }
 
 /** This callback tells CoApServer.ino to send given RadioMessage**/
@@ -284,50 +722,169 @@ void CoAPHandler::send(const RadioMessage &message) {
         (*radioMessageListener_)(message);
 }
 
-/** Adds given message to list of pending request**/
-void CoAPHandler::addPendingMessage(const CoAPMessage &message) {
-    pending_messages_.pushBack({message, millis()});
-    DEBUG_PRINT("Added pending message. Array size: ");
+/** Returns radio ID starting with prefix of the handler which is not used by any pending request.
+ *  Table is never full when it is called and holds less requests than there are IDs, so free ID is always found. **/
+unsigned short CoAPHandler::nextRadioId() {
+    unsigned short radio_id;
+    do {
+        radio_id = (unsigned short) (radio_id_prefix_ | (next_radio_id_++ & radio_id_mask_));
+    } while (pending_messages_.find(radio_id) != NO_PENDING_MESSAGE);
+    return radio_id;
+}
+
+/** Adds given message to table of pending request under new radio ID and schedules its timeout,
+ *  returns false if table is full. Radio request has to be sent with returned radio ID,
+ *  so its reply is matched to this request even if other client uses the same message ID.
+ *  Last block of body sent in blocks is kept, so that final response can echo it. **/
+template <typename Message>
+bool CoAPHandler::addPendingMessage(const Message &message, const CoAPEndpoint &endpoint, Node *resource,
+                                    const Block2 *block1, unsigned short &radio_id) {
+    if (pending_messages_.size() == pending_messages_.capacity())
+        return false;
+
+    PendingMessage pendingMessage;
+    pendingMessage.radio_id = nextRadioId();
+    pendingMessage.message_id = message.getMessageId();
+    pendingMessage.endpoint = endpoint;
+    pendingMessage.resource = resource;
+    pendingMessage.type = (unsigned char) message.getT();
+    pendingMessage.code = (unsigned char) message.getCode();
+    pendingMessage.token.deserialize(message.getToken().begin(), message.getToken().size());
+    pendingMessage.timestamp = clock_->now();
+    pendingMessage.blockwise = block1 != nullptr;
+    if (block1 != nullptr)
+        pendingMessage.block1 = *block1;
+
+    int handle = pending_messages_.insert(pendingMessage);
+    if (handle == NO_PENDING_MESSAGE)
+        return false;
+
+    timers_.schedule(handle, pendingMessage.timestamp + timeout_);
+    radio_id = pendingMessage.radio_id;
+    DEBUG_PRINT("Added pending message. Table size: ");
     DEBUG_PRINTLN(pending_messages_.size());
     DEBUG_PRINTLN("");
+    return true;
+}
+
+/** Removes from pending request message with given radio ID and cancels its timeout, returns false if there was none**/
+bool CoAPHandler::finalizePendingMessage(const unsigned short radio_id, PendingMessage &message) {
+    int handle = pending_messages_.find(radio_id);
+    if (handle == NO_PENDING_MESSAGE)
+        return false;
+
+    message = *pending_messages_.at(handle);
+    pending_messages_.remove(handle);
+    timers_.cancel(handle);
+    return true;
 }
-/** Removes from pending reqyest message with given id**/
-CoAPHandler::PendingMessage CoAPHandler::finalizePendingMessage(const unsigned short message_id) {
-    for(unsigned int i = 0; i < pending_messages_.size(); ++i) {
-        if(pending_messages_[i].coapMessage.getMessageId() == message_id)
-            return pending_messages_.pop(i);
-    }
 
-    return PendingMessage();
+/** Removes pending request which radio request is not going to be sent, so it does not time out later **/
+void CoAPHandler::cancelPendingMessage(const unsigned short radio_id) {
+    PendingMessage cancelled;
+    finalizePendingMessage(radio_id, cancelled);
 }
 
-/** Deletes request that was not served and updates metric**/
+/** Deletes requests that were not served in time and updates metric.
+ *  Only expired requests are visited, so it is cheap to call even with many requests pending **/
 void CoAPHandler::deleteTimedOut() {
-    unsigned long now = millis();
-    for(unsigned int i = 0; i < pending_messages_.size(); ++i) {
-        if(now - pending_messages_[i].timestamp > timeout_) {
+    unsigned long now = clock_->now();
+    int handle;
+
+    while (timers_.popExpired(now, handle)) {
+        const PendingMessage* pendingMessage = pending_messages_.at(handle);
+
+        DEBUG_PRINT_TIME();
+        DEBUG_PRINTLN("TIMEOUT");
+        DEBUG_FUNCTION(pendingMessage->print());
+
+        handleBadRequest(*pendingMessage, pendingMessage->endpoint, CODE_GATEWAY_TIMEOUT);
+        pending_messages_.remove(handle);
+        updateTimeoutMetric();
+    }
+}
+
+/** Sends again confirmable messages which were not acknowledged in time,
+ *  gives up those which ran out of retransmissions and updates metric **/
+void CoAPHandler::retransmit() {
+    int handle;
+    bool again;
+
+    while (retransmitter_.popDue(handle, again)) {
+        const CoAPTransmission *transmission = retransmitter_.at(handle);
+
+        if (again) {
+            send(transmission->message, transmission->endpoint);
+        }
+        else {
             DEBUG_PRINT_TIME();
-            DEBUG_PRINTLN("TIMEOUT");
-            DEBUG_FUNCTION(pending_messages_[i].coapMessage.print());
+            DEBUG_PRINTLN("GIVEN UP");
+            DEBUG_FUNCTION(transmission->message.print());
 
-            handleBadRequest(pending_messages_[i].coapMessage, CODE_GATEWAY_TIMEOUT);
-            pending_messages_.erase(i);
+            retransmitter_.release(handle);
             updateTimeoutMetric();
         }
     }
 }
 
-/** Puts given path into resource tree, along with mapping into radio interface notation**/
-void CoAPHandler::registerResource(const Array<String> &uri_path, unsigned short *value) {
-    resources_.insert(uri_path, value);
+/** Returns time at which the next pending request times out or message has to be retransmitted,
+ *  false if there are none. Main loop can wait until then instead of calling deleteTimedOut
+ *  and retransmit all the time **/
+bool CoAPHandler::getNextDeadline(unsigned long &deadline) const {
+    unsigned long retransmission_deadline;
+
+    if (!retransmitter_.nextDeadline(retransmission_deadline))
+        return timers_.nextDeadline(deadline);
+
+    if (!timers_.nextDeadline(deadline) || (long) (retransmission_deadline - deadline) < 0)
+        deadline = retransmission_deadline;
+    return true;
+}
+
+/** Returns clock which measures deadlines of the handler **/
+const CoAPClock &CoAPHandler::getClock() const {
+    return *clock_;
+}
+
+/** Puts given path into resource tree, along with mapping into radio interface notation and optional resource type **/
+void CoAPHandler::registerResource(const Array<String> &uri_path, unsigned short *value, const String &type) {
+    if (resources_ == nullptr)
+        resources_ = new CoAPResources();
+
+    resources_->insert(uri_path, value, type);
+    links_.invalidate();
 }
-/** Sends ping message to CoAP Client in order to calculate RTT **/
-void CoAPHandler::sendPing() {
+
+/** Puts given path into resource tree, requests to it will be served by given handler (which has to outlive CoAPHandler).
+ *  Returned node can be used to notify observers about change of resource. **/
+Node *CoAPHandler::registerResource(const Array<String> &uri_path, CoAPResourceHandler &handler, const String &type) {
+    if (resources_ == nullptr)
+        resources_ = new CoAPResources();
+
+    Node *resource = resources_->insert(uri_path, nullptr, type);
+    resource->setHandler(&handler);
+    links_.invalidate();
+    return resource;
+}
+
+/** Sends notification to observers of given resource, if given value has changed.
+ *  Notification of resource served by handler carries representation returned by its get. **/
+void CoAPHandler::notify(Node *resource, unsigned long value) {
+    notifyObservers(resource, value);
+}
+/** Sends confirmable ping message to given CoAP Client in order to calculate RTT.
+ *  Nothing is sent while previous ping to it is still being retransmitted **/
+void CoAPHandler::sendPing(const CoAPEndpoint &endpoint) {
+    if (!retransmitter_.canSend(endpoint))
+        return;
+
     CoAPMessage message;
     message.setCode(CODE_EMPTY);
-    message.setMessageId(ping_messages_sent++);
-    send(message);
-    addPendingMessage(message);
+    message.setT(TYPE_CON);
+    message.setMessageId(next_message_id_++);
+    ++ping_messages_sent;
+    send(message, endpoint);
+    retransmitter_.track(message, endpoint);
 }
 
 /** Updates metrics describing internet connection with CoAP Client**/
@@ -348,6 +905,7 @@ void CoAPHandler::updateRoundTripTimeMetric(unsigned short rtt) {
 
     DEBUG_PRINT("RTT: ");
     DEBUG_PRINTLN(mean_rtt);
+    notifyObservers(&routes_[ROUTE_RTT], mean_rtt);
 }
 
 /** Calculates Jitter metric**/
@@ -356,6 +914,7 @@ void CoAPHandler::updateJitterMetric(unsigned short rtt) {
 
     DEBUG_PRINT("Jitter: ");
     DEBUG_PRINTLN(last_jitter);
+    notifyObservers(&routes_[ROUTE_JITTER], last_jitter);
 }
 
 /** Increments Timeout metric**/
@@ -364,6 +923,7 @@ void CoAPHandler::updateTimeoutMetric() {
 
     DEBUG_PRINT("Timed out messages: ");
     DEBUG_PRINTLN(timed_out);
+    notifyObservers(&routes_[ROUTE_TIMED_OUT], timed_out);
     DEBUG_PRINTLN("");
 }
 
@@ -372,6 +932,30 @@ unsigned short CoAPHandler::getTimeout() const {
     return timeout_;
 }
 
+/** Sets number of seconds for which values of remote resources are served from cache, 0 disables caching **/
+void CoAPHandler::setMaxAge(unsigned long seconds) {
+    response_cache_.setMaxAge(seconds);
+}
+
+/** Puts given prefix into given number of highest bits of every radio ID assigned by the handler,
+ *  so radio reply can be routed to the handler which sent the request. Remaining bits have to give
+ *  more IDs than PENDING_MESSAGES_CAPACITY. **/
+void CoAPHandler::setRadioIdPrefix(unsigned short prefix, unsigned char bits) {
+    if (bits == 0) {
+        radio_id_prefix_ = 0;
+        radio_id_mask_ = 0xFFFF;
+        return;
+    }
+
+    radio_id_mask_ = (unsigned short) (0xFFFFu >> bits);
+    radio_id_prefix_ = (unsigned short) (prefix << (16 - bits));
+}
+
+/** Returns table of requests waiting for reply, eg. to check its high-water mark **/
+const CoAPPendingMessages &CoAPHandler::getPendingMessages() const {
+    return pending_messages_;
+}
+
 /** Converts unsigned short into ByteArray**/
 ByteArray CoAPHandler::toByteArray(unsigned short value) {
     ByteArray result(1);
@@ -391,6 +975,38 @@ CoAPOption CoAPHandler::toContentFormat(unsigned short value) {
     return result;
 }
 
+/**Creates option with given number and unsigned integer value, encoded as big-endian in minimal number of bytes**/
+CoAPOption CoAPHandler::toUintOption(unsigned int number, unsigned long value) {
+    ByteArray bytes(4);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        if (bytes.size() > 0 || (value >> shift) > 0)
+            bytes.pushBack((unsigned char) ((value >> shift) & 0xff));
+    }
+    return CoAPOption(number, bytes);
+}
+
+/** Converts decimal number written as text into number, reading stops at the first character which is not a digit.
+ *  Returns false if number is bigger than radio message can carry **/
+bool CoAPHandler::toNumber(const ByteView &value, unsigned long &number) {
+    number = 0;
+    for (unsigned int i = 0; i < value.size() && value[i] >= '0' && value[i] <= '9'; ++i) {
+        unsigned long digit = (unsigned long) (value[i] - '0');
+        if (number > (RADIO_MAX_VALUE - digit) / 10)
+            return false;
+        number = number * 10 + digit;
+    }
+    return true;
+}
+
+/** Converts big-endian unsigned integer option value into number **/
+unsigned long CoAPHandler::toUnsignedLong(const ByteView &value) {
+    unsigned long result = 0;
+    for (unsigned int i = 0; i < value.size(); ++i) {
+        result = (result << 8) | value[i];
+    }
+    return result;
+}
+
 /** Converts string into ByteArray**/
 ByteArray CoAPHandler::toByteArray(const String &value) {
     ByteArray result(value.length());
@@ -405,8 +1021,8 @@ unsigned short CoAPHandler::toUnsignedShort(const String &value) {
     return (unsigned short) TO_INT(value);
 }
 
-/** Converts ByteArray into string**/
-String CoAPHandler::toString(const ByteArray &value) {
+/** Converts ByteView into string**/
+String CoAPHandler::toString(const ByteView &value) {
     String result;
     for(int i = 0; i < value.size(); ++i){
         result += char(value[i]);
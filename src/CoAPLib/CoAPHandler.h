@@ -2,9 +2,21 @@
 #define COAPLIB_SERVERCOAPHANDLER_H
 
 
+#include "CoAPBlockAssembler.h"
+#include "CoAPClock.h"
+#include "CoAPDeduplicationCache.h"
+#include "CoAPEndpoint.h"
 #include "CoAPMessage.h"
+#include "CoAPMessageView.h"
 #include "CoAPMessageListener.h"
+#include "CoAPPendingMessages.h"
+#include "CoAPResourceHandler.h"
 #include "CoAPResources.h"
+#include "CoAPResponseCache.h"
+#include "CoAPRetransmitter.h"
+#include "CoAPRoutes.h"
+#include "CoAPTimers.h"
+#include "CoAPValueResource.hpp"
 #include "../Environment.h"
 #include "../RadioLib.h"
 
@@ -13,9 +25,15 @@
  */
 class CoAPHandler {
 private:
-    struct PendingMessage {
-        CoAPMessage coapMessage;
-        unsigned long timestamp;
+    /** Serves /.well-known/core from link format document of the handler **/
+    class WellKnownCoreResource : public CoAPResourceHandler {
+    private:
+        CoAPHandler* handler_;
+    public:
+        WellKnownCoreResource(CoAPHandler &handler);
+
+        unsigned short get(const CoAPMessageView &request, CoAPMessage &response) override;
+        bool getRepresentation(const CoAPMessageView &request, ByteView &representation) override;
     };
 
     unsigned short timeout_ = 5000;
@@ -25,54 +43,114 @@ private:
     short last_jitter = 0;
     unsigned short timed_out = 0;
 
-    CoAPResources resources_;
+    Node routes_[ROUTES_COUNT];
+    CoAPResources* resources_ = nullptr;
+    CoAPLinkFormat links_;
     CoAPMessageListener* coapMessageListener_;
     RadioMessageListener* radioMessageListener_;
 
-    Array<PendingMessage> pending_messages_;
-
-    void handlePing(const CoAPMessage &message);
-    void handleRequest(const CoAPMessage &message);
-    void handleBadRequest(const CoAPMessage &message, unsigned short error_code);
+    const CoAPClock* clock_;
+    CoAPPendingMessages pending_messages_;
+    CoAPTimers timers_;
+    CoAPRetransmitter retransmitter_;
+    CoAPDeduplicationCache recent_messages_;
+    CoAPResponseCache response_cache_;
+    unsigned short next_message_id_;
+    unsigned short next_radio_id_;
+    unsigned short radio_id_prefix_ = 0;
+    unsigned short radio_id_mask_ = 0xFFFF;
+    CoAPBlockAssembler block_assembler_;
+    WellKnownCoreResource core_resource_;
+    CoAPValueResource<unsigned short> rtt_resource_;
+    CoAPValueResource<short> jitter_resource_;
+    CoAPValueResource<unsigned short> timed_out_resource_;
+
+    bool isDuplicate(const CoAPMessageView &message, const CoAPEndpoint &endpoint);
+    void handlePing(const CoAPMessageView &message, const CoAPEndpoint &endpoint);
+    void handleRequest(const CoAPMessageView &message, const CoAPEndpoint &endpoint);
+    Node *findResource(CoAPMessageView::OptionIterator &iterator, const CoAPMessageView::OptionIterator &end,
+                       long &radio_resource);
+    unsigned short toRequestedBlock(const CoAPMessageView::OptionIterator &option,
+                                    const CoAPMessageView::OptionIterator &end, Block2 &block);
+    void setBlockPayload(CoAPMessage &response, const String &representation, const Block2 &block);
+    void setBlockPayload(CoAPMessage &response, const ByteView &representation, const Block2 &block);
+    void applyBlock(CoAPMessage &response, const Block2 &block);
+    static bool isError(unsigned short code);
+    const CoAPLinkFormat &getLinkFormat();
+    unsigned short appendBlock(const CoAPMessageView &message, const CoAPEndpoint &endpoint, const Node *resource,
+                               const Block2 &block, ByteArray &body);
+    bool receiveBlock(const CoAPMessageView &message, const CoAPEndpoint &endpoint, const Node *resource,
+                      const Block2 &block, ByteArray &body);
+    void replacePayload(const CoAPMessageView &message, const ByteView &payload, ByteArray &buffer,
+                        CoAPMessageView &request);
+    template <typename Message>
+    void handleBadRequest(const Message &message, const CoAPEndpoint &endpoint, unsigned short error_code);
 
     void updateMetrics(unsigned short rtt);
     void updateRoundTripTimeMetric(unsigned short rtt);
     void updateJitterMetric(unsigned short rtt);
     void updateTimeoutMetric();
 
-    void addPendingMessage(const CoAPMessage &message);
-    PendingMessage finalizePendingMessage(const unsigned short message_id);
-
-    void send(const CoAPMessage &message);
+    void updateObserver(Node *resource, const CoAPEndpoint &endpoint, const TokenArray &token, long observe);
+    void addObserveOption(const Node *resource, const CoAPEndpoint &endpoint, const TokenArray &token,
+                          CoAPMessage &response);
+    void notifyObservers(Node *resource, unsigned long value, const PendingMessage *except = nullptr);
+    bool createNotification(CoAPResourceHandler &handler, CoAPMessage &notification);
+
+    unsigned short nextRadioId();
+    template <typename Message>
+    bool addPendingMessage(const Message &message, const CoAPEndpoint &endpoint, Node *resource,
+                           const Block2 *block1, unsigned short &radio_id);
+    bool finalizePendingMessage(const unsigned short radio_id, PendingMessage &message);
+    void cancelPendingMessage(const unsigned short radio_id);
+
+    template <typename Message>
+    void respond(const Message &request, const CoAPEndpoint &endpoint, const CoAPMessage &response);
+    void send(const CoAPMessage &message, const CoAPEndpoint &endpoint);
     void send(const RadioMessage &message);
 
-    void createResponse(const CoAPMessage &message, CoAPMessage &response);
-    void createResponse(const CoAPMessage &message, RadioMessage &response);
+    template <typename Message>
+    void createResponse(const Message &message, CoAPMessage &response);
+    void createResponse(const CoAPMessageView &message, RadioMessage &response);
 
     ByteArray toByteArray(const String &value);
     ByteArray toByteArray(unsigned short value);
     unsigned short toUnsignedShort(const String &value);
-    String toString(const ByteArray &value);
+    String toString(const ByteView &value);
     CoAPOption toContentFormat(unsigned short value);
+    CoAPOption toUintOption(unsigned int number, unsigned long value);
+    unsigned long toUnsignedLong(const ByteView &value);
+    bool toNumber(const ByteView &value, unsigned long &number);
 
-    void prepareSpeakerResource();
-    void prepareLampResource();
-    void prepareRttResource();
-    void prepareJitterResource();
-    void prepareTimedOutResource();
+    CoAPHandler(const CoAPHandler &handler);
+    CoAPHandler &operator=(const CoAPHandler &handler);
 public:
     CoAPHandler(CoAPMessageListener &coapMessageListener, RadioMessageListener &radioMessageListener);
+    CoAPHandler(CoAPMessageListener &coapMessageListener, RadioMessageListener &radioMessageListener,
+                const CoAPClock &clock);
+    ~CoAPHandler();
 
-    void handleMessage(CoAPMessage &message);
+    void handleMessage(CoAPMessage &message, const CoAPEndpoint &endpoint = CoAPEndpoint());
+    void handleMessage(const CoAPMessageView &message, const CoAPEndpoint &endpoint = CoAPEndpoint());
     void handleMessage(RadioMessage &radioMessage);
+    void handleMalformed(const CoAPMessageView &message, const CoAPEndpoint &endpoint = CoAPEndpoint());
 
-    void registerResource(const Array<String> &uri_path, unsigned short *value);
-    void sendPing();
+    void registerResource(const Array<String> &uri_path, unsigned short *value, const String &type = String());
+    Node *registerResource(const Array<String> &uri_path, CoAPResourceHandler &handler, const String &type = String());
+    void notify(Node *resource, unsigned long value);
+    void sendPing(const CoAPEndpoint &endpoint = CoAPEndpoint());
     void deleteTimedOut();
+    void retransmit();
+    bool getNextDeadline(unsigned long &deadline) const;
+    const CoAPClock &getClock() const;
 
     unsigned short getTimeout() const;
+    void setMaxAge(unsigned long seconds);
+    void setRadioIdPrefix(unsigned short prefix, unsigned char bits);
+    const CoAPPendingMessages &getPendingMessages() const;
     void print() {
-        PRINT(resources_.toLinkFormat());
+        ByteView document = getLinkFormat().getDocument();
+        PRINT(CoAPOption::toString(document.begin(), document.size()));
     }
 };
 
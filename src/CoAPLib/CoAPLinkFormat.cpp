@@ -0,0 +1,187 @@
+#include "CoAPLinkFormat.h"
+
+CoAPLinkFormat::CoAPLinkFormat() : valid_(false) {}
+
+/** Removes all links, document is valid (but empty) until it is invalidated **/
+void CoAPLinkFormat::clear() {
+    document_ = ByteArray();
+    link_ends_ = Array<unsigned int>();
+    valid_ = true;
+}
+
+/** Marks document as outdated, it has to be built again before use **/
+void CoAPLinkFormat::invalidate() {
+    valid_ = false;
+}
+
+bool CoAPLinkFormat::isValid() const {
+    return valid_;
+}
+
+void CoAPLinkFormat::append(const char *value) {
+    append(ByteView((const unsigned char *) value, strlen(value)));
+}
+
+void CoAPLinkFormat::append(const String &value) {
+    append(ByteView((const unsigned char *) value.c_str(), value.length()));
+}
+
+void CoAPLinkFormat::append(const ByteView &value) {
+    for (unsigned int i = 0; i < value.size(); ++i) {
+        document_.pushBack(value[i]);
+    }
+}
+
+/** Adds link to resource with given path (eg. /remote/lamp) **/
+void CoAPLinkFormat::addLink(const String &path) {
+    if (link_ends_.size() > 0)
+        document_.pushBack(',');
+
+    document_.pushBack('<');
+    append(path);
+    document_.pushBack('>');
+    link_ends_.pushBack(document_.size());
+}
+
+/** Adds attribute to the last link, value of quoted attribute is put in quotes (eg. rt="radio") **/
+void CoAPLinkFormat::addAttribute(const char *name, const String &value, bool quoted) {
+    document_.pushBack(';');
+    append(name);
+    document_.pushBack('=');
+    if (quoted)
+        document_.pushBack('"');
+    append(value);
+    if (quoted)
+        document_.pushBack('"');
+
+    link_ends_.popBack();
+    link_ends_.pushBack(document_.size());
+}
+
+/** Adds all links of another document **/
+void CoAPLinkFormat::addLinks(const CoAPLinkFormat &links) {
+    for (unsigned int i = 0; i < links.size(); ++i) {
+        if (link_ends_.size() > 0)
+            document_.pushBack(',');
+
+        append(links.getLink(i));
+        link_ends_.pushBack(document_.size());
+    }
+}
+
+/** Returns the whole document, ready to be sent **/
+ByteView CoAPLinkFormat::getDocument() const {
+    return ByteView(document_.begin(), document_.size());
+}
+
+/** Returns number of links in the document **/
+unsigned int CoAPLinkFormat::size() const {
+    return link_ends_.size();
+}
+
+ByteView CoAPLinkFormat::getLink(unsigned int index) const {
+    unsigned int begin = index == 0 ? 0 : link_ends_[index - 1] + 1;
+    return ByteView(document_.begin() + begin, link_ends_[index] - begin);
+}
+
+/** Writes into result document made of links matching all given queries **/
+void CoAPLinkFormat::filter(const Array<ByteView> &queries, ByteArray &result) const {
+    result = ByteArray();
+
+    for (unsigned int i = 0; i < link_ends_.size(); ++i) {
+        ByteView link = getLink(i);
+        bool matching = true;
+
+        for (unsigned int j = 0; j < queries.size() && matching; ++j) {
+            matching = matches(link, queries[j]);
+        }
+
+        if (matching) {
+            if (result.size() > 0)
+                result.pushBack(',');
+            for (unsigned int j = 0; j < link.size(); ++j) {
+                result.pushBack(link[j]);
+            }
+        }
+    }
+}
+
+/** Tells if link matches query of form name=value. Name href refers to path of resource,
+ *  other names to attributes of link. Value ending with '*' matches any value beginning with it. **/
+bool CoAPLinkFormat::matches(const ByteView &link, const ByteView &query) {
+    unsigned int separator = 0;
+    while (separator < query.size() && query[separator] != '=') {
+        ++separator;
+    }
+    if (separator == query.size())
+        return false;
+
+    ByteView name(query.begin(), separator);
+    ByteView pattern(query.begin() + separator + 1, query.size() - separator - 1);
+
+    unsigned int path_end = 1;
+    while (path_end < link.size() && link[path_end] != '>') {
+        ++path_end;
+    }
+
+    if (name == "href")
+        return matches(ByteView(link.begin() + 1, path_end - 1), pattern, false);
+
+    // Attributes follow path, each of them begins with ';'
+    unsigned int cursor = path_end + 1;
+    while (cursor < link.size()) {
+        unsigned int name_begin = cursor + 1;
+        unsigned int name_end = name_begin;
+        while (name_end < link.size() && link[name_end] != '=' && link[name_end] != ';') {
+            ++name_end;
+        }
+
+        unsigned int value_begin = name_end < link.size() && link[name_end] == '=' ? name_end + 1 : name_end;
+        unsigned int value_end = value_begin;
+        bool quoted = value_begin < link.size() && link[value_begin] == '"';
+        if (quoted) {
+            ++value_begin;
+            value_end = value_begin;
+            while (value_end < link.size() && link[value_end] != '"') {
+                ++value_end;
+            }
+            cursor = value_end + 1;
+        }
+        else {
+            while (value_end < link.size() && link[value_end] != ';') {
+                ++value_end;
+            }
+            cursor = value_end;
+        }
+
+        if (ByteView(link.begin() + name_begin, name_end - name_begin) == name
+            && matches(ByteView(link.begin() + value_begin, value_end - value_begin), pattern, quoted))
+            return true;
+    }
+
+    return false;
+}
+
+/** Compares value with pattern, which may end with '*'. Quoted values can be lists of words
+ *  separated with spaces (eg. rt="radio lamp"), then it is enough if any of them matches. **/
+bool CoAPLinkFormat::matches(const ByteView &value, const ByteView &pattern, bool any_word) {
+    bool prefix = pattern.size() > 0 && pattern[pattern.size() - 1] == '*';
+    unsigned int length = prefix ? pattern.size() - 1 : pattern.size();
+    unsigned int begin = 0;
+
+    while (begin <= value.size()) {
+        unsigned int end = begin;
+        while (end < value.size() && !(any_word && value[end] == ' ')) {
+            ++end;
+        }
+
+        unsigned int size = end - begin;
+        if ((prefix ? size >= length : size == length)
+            && ByteView(value.begin() + begin, length) == ByteView(pattern.begin(), length))
+            return true;
+
+        begin = end + 1;
+    }
+
+    return false;
+}
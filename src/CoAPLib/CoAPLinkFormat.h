@@ -0,0 +1,42 @@
+#ifndef COAPLIB_COAPLINKFORMAT_H
+#define COAPLIB_COAPLINKFORMAT_H
+
+#include "Array.hpp"
+#include "ArrayView.hpp"
+#include "../Environment.h"
+
+/**
+ * Serialized CoRE Link Format document (RFC 6690) along with positions of its links, so links can be
+ * filtered by query (eg. ?rt=radio or ?href=/remote/... prefix match) without building the document again.
+ * Document is built once and kept until it is invalidated by change of described resources.
+ */
+class CoAPLinkFormat {
+private:
+    ByteArray document_;
+    Array<unsigned int> link_ends_;
+    bool valid_;
+
+    void append(const char *value);
+    void append(const String &value);
+    void append(const ByteView &value);
+
+    ByteView getLink(unsigned int index) const;
+    static bool matches(const ByteView &link, const ByteView &query);
+    static bool matches(const ByteView &value, const ByteView &pattern, bool any_word);
+public:
+    CoAPLinkFormat();
+
+    void clear();
+    void invalidate();
+    bool isValid() const;
+
+    void addLink(const String &path);
+    void addAttribute(const char *name, const String &value, bool quoted);
+    void addLinks(const CoAPLinkFormat &links);
+
+    ByteView getDocument() const;
+    unsigned int size() const;
+    void filter(const Array<ByteView> &queries, ByteArray &result) const;
+};
+
+#endif //COAPLIB_COAPLINKFORMAT_H
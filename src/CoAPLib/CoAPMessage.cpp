@@ -1,20 +1,104 @@
 #include "CoAPMessage.h"
+#include "CoAPMessageView.h"
 
 CoAPMessage::CoAPMessage() {
     header_ = {DEFAULT_VERSION, 0, 0, 0, 0};
 }
 
-/** Puts values from CoAPMessage into unsigned char array, returns length**/
-unsigned int CoAPMessage::serialize(unsigned char* buffer_begin) const {
+/** Returns exact number of bytes taken by serialized message, payload marker is counted only if there is payload **/
+unsigned int CoAPMessage::serializedSize() const {
+    const unsigned int header_size = 4;
+    unsigned int size = header_size + token_.size() + CoAPOption::serializedSize(options_);
+
+    if (payload_.size() > 0)
+        size += 1 + payload_.size();
+
+    return size;
+}
+
+/** Puts values from CoAPMessage into unsigned char array, returns length.
+ *  Nothing is written and 0 is returned if message does not fit into given capacity. **/
+unsigned int CoAPMessage::serialize(unsigned char* buffer_begin, unsigned int capacity) const {
+    unsigned int size = serializedSize();
+    if (size > capacity)
+        return 0;
+
     unsigned char* cursor = buffer_begin;
 
     insert(cursor, header_);
     insert(cursor, token_);
     insert(cursor, options_);
-    insert(cursor, PAYLOAD_MARKER);
-    insert(cursor, payload_);
+    if (payload_.size() > 0) {
+        insert(cursor, PAYLOAD_MARKER);
+        insert(cursor, payload_);
+    }
+
+    return size;
+}
+
+/** Splits message into segments which together make the serialized message, eg. to send them with sendmsg.
+ *  Header, token, option headers and short option values are written into scratch, while payload and option
+ *  values of at least COAP_GATHER_MIN_SIZE bytes are referenced in place, so segments are valid as long as
+ *  the message is not changed. Returns number of segments or 0 if scratch or segments are too small. **/
+unsigned int CoAPMessage::serialize(unsigned char* scratch, unsigned int scratch_capacity,
+                                    ByteView* segments, unsigned int max_segments) const {
+    const unsigned int header_size = 4;
+    unsigned char* cursor = scratch;
+    unsigned char* run_begin = scratch;
+    unsigned int count = 0;
+
+    if (header_size + token_.size() > scratch_capacity)
+        return 0;
+
+    insert(cursor, header_);
+    insert(cursor, token_);
+
+    unsigned int previous_number = 0;
+    for (unsigned int i = 0; i < options_.size(); ++i) {
+        const CoAPOption &option = options_[i];
+        unsigned int delta = option.getNumber() - previous_number;
+        unsigned int value_size = option.getValue().size();
+        bool gathered = value_size >= COAP_GATHER_MIN_SIZE;
+        previous_number = option.getNumber();
+
+        if (option.serializedSize(delta) - (gathered ? value_size : 0) > scratch_capacity - (cursor - scratch))
+            return 0;
+
+        if (!gathered) {
+            option.serialize(cursor, delta);
+            continue;
+        }
+
+        option.serializeHeader(cursor, delta);
+        if (!addSegment(segments, max_segments, count, run_begin, cursor - run_begin)
+            || !addSegment(segments, max_segments, count, option.getValue().begin(), value_size))
+            return 0;
+        run_begin = cursor;
+    }
+
+    if (payload_.size() > 0) {
+        if (cursor - scratch == (int) scratch_capacity)
+            return 0;
+        insert(cursor, PAYLOAD_MARKER);
+    }
+
+    if (!addSegment(segments, max_segments, count, run_begin, cursor - run_begin)
+        || !addSegment(segments, max_segments, count, payload_.begin(), payload_.size()))
+        return 0;
 
-    return cursor - buffer_begin - 1;
+    return count;
+}
+
+/** Appends non-empty segment, returns false if there is no room for it **/
+bool CoAPMessage::addSegment(ByteView *segments, unsigned int max_segments, unsigned int &count,
+                             const unsigned char *begin, unsigned int size) {
+    if (size == 0)
+        return true;
+    if (count == max_segments)
+        return false;
+
+    segments[count++] = ByteView(begin, size);
+    return true;
 }
 
 /** Puts values from header into unsigned char array **/
@@ -32,6 +116,12 @@ void CoAPMessage::insert(unsigned char* &cursor, const ByteArray &bytes) const {
     cursor += bytes.size();
 }
 
+/** Puts token into unsigned char array **/
+void CoAPMessage::insert(unsigned char* &cursor, const TokenArray &bytes) const {
+    bytes.serialize(cursor);
+    cursor += bytes.size();
+}
+
 /** Puts values from OptionArray into unsigned char array **/
 void CoAPMessage::insert(unsigned char* &cursor, const OptionArray &options) const {
     CoAPOption::serialize(cursor, options);
@@ -43,42 +133,28 @@ void CoAPMessage::insert(unsigned char *&cursor, unsigned char value) const {
     ++cursor;
 }
 
-/** Fills Message with values extracted from unsigned char array**/
-void CoAPMessage::deserialize(unsigned char *buffer_begin, unsigned int num) {
-    unsigned char* cursor = buffer_begin;
-    unsigned char* buffer_end = buffer_begin + num;
-
-    extractHeader(cursor, buffer_end);
-    extractToken(cursor, buffer_end);
-    extractOptions(cursor, buffer_end);
-    extractPayload(cursor, buffer_end);
-}
-
-/** Fills header with values extracted from unsigned char array**/
-void CoAPMessage::extractHeader(unsigned char *&cursor, unsigned char* buffer_end) {
-    header_.Ver = (*cursor & MASK_VER) >> OFFSET_VER;
-    header_.T = (*cursor & MASK_T) >> OFFSET_T;
-    header_.TKL = (*cursor & MASK_TKL);
-    header_.Code = (*++cursor);
-    header_.MessageId = ((*++cursor) << OFFSET_MESSAGE_ID) | (*++cursor);
-    ++cursor;
-}
-
-/** Fills Token with value extracted from unsigned char array**/
-void CoAPMessage::extractToken(unsigned char *&cursor, unsigned char* buffer_end) {
-    token_.deserialize(cursor, header_.TKL);
-    cursor += header_.TKL;
-}
+/** Fills Message with values extracted from unsigned char array. Message is validated by CoAPMessageView first,
+ *  so nothing is allocated for malformed message and false is returned. **/
+bool CoAPMessage::deserialize(unsigned char *buffer_begin, unsigned int num) {
+    CoAPMessageView view;
+    if (!view.parse(buffer_begin, num))
+        return false;
+
+    header_.Ver = view.getVer();
+    header_.T = view.getT();
+    header_.Code = view.getCode();
+    header_.MessageId = view.getMessageId();
+    setToken(view.getToken());
+
+    options_ = OptionArray();
+    for (CoAPMessageView::OptionIterator it = view.beginOptions(); it != view.endOptions(); ++it) {
+        options_.pushBack(CoAPOption(it->getNumber(), it->getValue()));
+    }
 
-/** Fills Options with values extracted from unsigned char array**/
-void CoAPMessage::extractOptions(unsigned char* &cursor, unsigned char* buffer_end) {
-    CoAPOption::deserialize(cursor, buffer_end, options_);
-}
+    ByteView payload = view.getPayload();
+    payload_.deserialize(payload.begin(), payload.size());
 
-/** Fills Payload with values extracted from unsigned char array**/
-void CoAPMessage::extractPayload(unsigned char *&cursor, unsigned char* buffer_end) {
-    payload_.deserialize(cursor, buffer_end - cursor);
-    cursor += buffer_end - cursor;
+    return true;
 }
 
 unsigned short CoAPMessage::getVer() const {
@@ -113,16 +189,22 @@ void CoAPMessage::setMessageId(unsigned short MessageId) {
     header_.MessageId = MessageId;
 }
 
-const ByteArray &CoAPMessage::getToken() const {
+const TokenArray &CoAPMessage::getToken() const {
     return token_;
 }
 
 /** Sets token and appropriate value in TKL **/
-void CoAPMessage::setToken(const ByteArray &token) {
+void CoAPMessage::setToken(const TokenArray &token) {
     token_ = token;
     header_.TKL = (unsigned short) token.size();
 }
 
+/** Sets token copied from given view and appropriate value in TKL **/
+void CoAPMessage::setToken(const ByteView &token) {
+    token_.deserialize(token.begin(), token.size());
+    header_.TKL = (unsigned short) token.size();
+}
+
 const OptionArray &CoAPMessage::getOptions() const {
     return options_;
 }
@@ -163,7 +245,7 @@ void CoAPMessage::print() const {
 
     if (token_.size() != 0) {
         PRINT("Token:");
-        PRINTLN(CoAPMessage::toString(payload_));
+        PRINTLN(CoAPOption::toString(token_.begin(), token_.size()));
     }
 
     if (options_.size() != 0) {
@@ -2,8 +2,12 @@
 #define FRAME_H
 
 #include "Array.hpp"
+#include "ArrayView.hpp"
+#include "InlineArray.hpp"
 #include "CoAPOption.h"
 
+typedef InlineArray<unsigned char, TOKEN_MAX_LENGTH> TokenArray;
+
 /**
  * Describes CoAP message and provides options for serialization/deserialization
  */
@@ -17,26 +21,28 @@ private:
         unsigned short MessageId : 16;
     } header_;
 
-    ByteArray token_;
+    TokenArray token_;
     OptionArray options_;
     ByteArray payload_;
 
     void insert(unsigned char* &cursor, const Header &header) const;
     void insert(unsigned char* &cursor, const ByteArray &bytes) const;
+    void insert(unsigned char* &cursor, const TokenArray &bytes) const;
     void insert(unsigned char* &cursor, const OptionArray &options) const;
     void insert(unsigned char* &cursor, unsigned char value) const;
-    void extractHeader(unsigned char* &cursor, unsigned char* buffer_end);
-    void extractToken(unsigned char* &cursor, unsigned char* buffer_end);
-    void extractOptions(unsigned char* &cursor, unsigned char* buffer_end);
-    void extractPayload(unsigned char *&cursor, unsigned char* buffer_end);
+    static bool addSegment(ByteView *segments, unsigned int max_segments, unsigned int &count,
+                           const unsigned char *begin, unsigned int size);
     
     static const String toString(const ByteArray &byte_array);
     void print(const OptionArray &options) const;
 public:
     CoAPMessage();
 
-    unsigned int serialize(unsigned char* buffer_begin) const;
-    void deserialize(unsigned char* buffer_begin, unsigned int num);
+    unsigned int serializedSize() const;
+    unsigned int serialize(unsigned char* buffer_begin, unsigned int capacity) const;
+    unsigned int serialize(unsigned char* scratch, unsigned int scratch_capacity,
+                           ByteView* segments, unsigned int max_segments) const;
+    bool deserialize(unsigned char* buffer_begin, unsigned int num);
 
     unsigned short getVer() const;
 
@@ -51,8 +57,9 @@ public:
     unsigned short getMessageId() const;
     void setMessageId(unsigned short MessageId);
 
-    const ByteArray &getToken() const;
-    void setToken(const ByteArray &token);
+    const TokenArray &getToken() const;
+    void setToken(const TokenArray &token);
+    void setToken(const ByteView &token);
 
     const OptionArray &getOptions() const;
     void addOption(const CoAPOption &option);
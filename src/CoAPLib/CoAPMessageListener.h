@@ -1,11 +1,17 @@
 #ifndef COAPLIB_COAPMESSAGELISTENER_H
 #define COAPLIB_COAPMESSAGELISTENER_H
 
+#include "CoAPEndpoint.h"
 #include "CoAPMessage.h"
 
-/** Part of callback used to pass message from library to "ino" **/
+/** Part of callback used to pass message from library to "ino".
+ *  Transports which serve more than one client override the variant taking endpoint of receiver. **/
 struct CoAPMessageListener {
     virtual void operator()(const CoAPMessage &message) = 0;
+
+    virtual void operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+        (*this)(message);
+    }
 };
 
 #endif //COAPLIB_COAPMESSAGELISTENER_H
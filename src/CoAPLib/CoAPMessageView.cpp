@@ -0,0 +1,328 @@
+#include "CoAPMessageView.h"
+
+CoAPOptionView::CoAPOptionView() : number_(0), value_() {}
+
+CoAPOptionView::CoAPOptionView(unsigned int number, const ByteView &value) : number_(number), value_(value) {}
+
+unsigned int CoAPOptionView::getNumber() const {
+    return number_;
+}
+
+const ByteView &CoAPOptionView::getValue() const {
+    return value_;
+}
+
+void CoAPOptionView::print() const {
+    PRINT("\t");
+    PRINT(number_);
+    PRINT(": ");
+
+    switch (number_) {
+        case OPTION_BLOCK2:
+            toBlock2().print();
+            break;
+        default:
+            PRINT(toString());
+            break;
+    }
+
+    PRINT("\n");
+}
+
+const String CoAPOptionView::toString() const {
+    return CoAPOption::toString(value_.begin(), value_.size());
+}
+
+const Block2 CoAPOptionView::toBlock2() const {
+    return CoAPOption::toBlock2(value_.begin(), value_.size());
+}
+
+CoAPMessageView::OptionIterator::OptionIterator() :
+        current_(nullptr),
+        cursor_(nullptr),
+        options_end_(nullptr),
+        option_() {}
+
+/** Creates iterator pointing at option which header starts at cursor **/
+CoAPMessageView::OptionIterator::OptionIterator(unsigned char *cursor, unsigned char *options_end) :
+        current_(cursor),
+        cursor_(cursor),
+        options_end_(options_end),
+        option_() {
+    ++*this;
+}
+
+/** Decodes option which header starts at cursor and moves cursor behind its value **/
+CoAPMessageView::OptionIterator &CoAPMessageView::OptionIterator::operator++() {
+    unsigned int delta = 0;
+    unsigned int length = 0;
+
+    current_ = cursor_;
+    if (cursor_ == options_end_ || !extractOption(cursor_, options_end_, delta, length)) {
+        current_ = cursor_ = options_end_;
+        return *this;
+    }
+
+    option_ = CoAPOptionView(option_.getNumber() + delta, ByteView(cursor_, length));
+    cursor_ += length;
+
+    return *this;
+}
+
+const CoAPOptionView &CoAPMessageView::OptionIterator::operator*() const {
+    return option_;
+}
+
+const CoAPOptionView *CoAPMessageView::OptionIterator::operator->() const {
+    return &option_;
+}
+
+bool CoAPMessageView::OptionIterator::operator==(const OptionIterator &iterator) const {
+    return current_ == iterator.current_;
+}
+
+bool CoAPMessageView::OptionIterator::operator!=(const OptionIterator &iterator) const {
+    return current_ != iterator.current_;
+}
+
+CoAPMessageView::CoAPMessageView() :
+        buffer_begin_(nullptr),
+        options_begin_(nullptr),
+        options_end_(nullptr),
+        buffer_end_(nullptr),
+        error_(PARSE_TOO_SHORT) {
+    header_ = {DEFAULT_VERSION, 0, 0, 0, 0};
+}
+
+/** Points view at message stored in buffer, returns false if message is malformed (getError() tells why).
+ *  Nothing is copied, buffer has to outlive the view. **/
+bool CoAPMessageView::parse(unsigned char *buffer_begin, unsigned int num) {
+    unsigned char* cursor = buffer_begin;
+
+    buffer_begin_ = buffer_begin;
+    buffer_end_ = buffer_begin + num;
+    options_begin_ = options_end_ = buffer_end_;
+
+    error_ = extractHeader(cursor);
+    if (error_ == PARSE_OK)
+        error_ = extractToken(cursor);
+    if (error_ == PARSE_OK)
+        error_ = extractOptions(cursor);
+    if (error_ == PARSE_OK)
+        error_ = extractPayload(cursor);
+
+    return error_ == PARSE_OK;
+}
+
+/** Returns result of the last parse, PARSE_OK if message was well-formed **/
+unsigned char CoAPMessageView::getError() const {
+    return error_;
+}
+
+/** Decodes fixed size header **/
+unsigned char CoAPMessageView::extractHeader(unsigned char *&cursor) {
+    if (buffer_end_ - cursor < 4)
+        return PARSE_TOO_SHORT;
+
+    header_.Ver = (cursor[0] & MASK_VER) >> OFFSET_VER;
+    header_.T = (cursor[0] & MASK_T) >> OFFSET_T;
+    header_.TKL = (cursor[0] & MASK_TKL);
+    header_.Code = cursor[1];
+    header_.MessageId = (cursor[2] << OFFSET_MESSAGE_ID) | cursor[3];
+    cursor += 4;
+
+    return header_.Ver == DEFAULT_VERSION ? PARSE_OK : PARSE_BAD_VERSION;
+}
+
+/** Skips token, it is accessed directly from buffer. Token which does not fit is dropped from the header,
+ *  so error response to such message carries no token. **/
+unsigned char CoAPMessageView::extractToken(unsigned char *&cursor) {
+    if (header_.TKL > TOKEN_MAX_LENGTH || buffer_end_ - cursor < header_.TKL) {
+        header_.TKL = 0;
+        options_begin_ = options_end_ = cursor;
+        return PARSE_BAD_TOKEN;
+    }
+
+    cursor += header_.TKL;
+    return PARSE_OK;
+}
+
+/** Checks if all options fit into buffer and finds where they end. Option numbers may not exceed 16 bits,
+ *  numbers only grow, so it is enough to check the last one. **/
+unsigned char CoAPMessageView::extractOptions(unsigned char *&cursor) {
+    unsigned long number = 0;
+    unsigned int delta = 0;
+    unsigned int length = 0;
+
+    options_begin_ = options_end_ = cursor;
+    while (cursor != buffer_end_ && *cursor != PAYLOAD_MARKER) {
+        if (!extractOption(cursor, buffer_end_, delta, length) || (unsigned int) (buffer_end_ - cursor) < length)
+            return PARSE_BAD_OPTION;
+
+        number += delta;
+        cursor += length;
+    }
+    options_end_ = cursor;
+
+    return number <= MAX_OPTION_NUMBER ? PARSE_OK : PARSE_BAD_OPTION;
+}
+
+/** Skips payload marker, payload itself is accessed directly from buffer **/
+unsigned char CoAPMessageView::extractPayload(unsigned char *&cursor) {
+    if (cursor == buffer_end_)
+        return PARSE_OK;
+
+    ++cursor;
+    return cursor != buffer_end_ ? PARSE_OK : PARSE_EMPTY_PAYLOAD;
+}
+
+/** Base added to extended delta or length, indexed by number of extended bytes **/
+static const unsigned short EXTENDED_BASE[3] = {0, 13, 269};
+
+/** Decodes option header with its extended delta and length, leaving cursor at option value.
+ *  Most options have delta and length below 13, they take single predictable branch. Otherwise number
+ *  of extended bytes is derived from header values and whole header is bounds-checked at once.
+ *  Returns false if header does not fit into buffer, uses reserved value 15 or delta or length
+ *  does not fit into 16 bits (2-byte extended form goes up to 65804, which would wrap on AVR).
+ *  Cursor has to point before buffer_end. **/
+bool CoAPMessageView::extractOption(unsigned char *&cursor, const unsigned char *buffer_end,
+                                    unsigned int &delta, unsigned int &length) {
+    unsigned char header_delta = (unsigned char) ((*cursor & MASK_DELTA) >> OFFSET_DELTA);
+    unsigned char header_length = (unsigned char) (*cursor & MASK_LENGTH);
+
+    if (header_delta < 13 && header_length < 13) {
+        delta = header_delta;
+        length = header_length;
+        ++cursor;
+        return true;
+    }
+
+    unsigned int delta_size = (unsigned int) (header_delta >= 13) + (header_delta >= 14);
+    unsigned int length_size = (unsigned int) (header_length >= 13) + (header_length >= 14);
+
+    if (header_delta == 15 || header_length == 15
+        || (unsigned int) (buffer_end - cursor) < 1 + delta_size + length_size)
+        return false;
+
+    unsigned long extended_delta = extendedValue(cursor + 1, header_delta, delta_size);
+    unsigned long extended_length = extendedValue(cursor + 1 + delta_size, header_length, length_size);
+    if (extended_delta > MAX_OPTION_NUMBER || extended_length > MAX_OPTION_NUMBER)
+        return false;
+
+    delta = (unsigned int) extended_delta;
+    length = (unsigned int) extended_length;
+    cursor += 1 + delta_size + length_size;
+
+    return true;
+}
+
+/** Returns delta or length given by 4-bit header value and following extended bytes **/
+unsigned long CoAPMessageView::extendedValue(const unsigned char *cursor, unsigned char header_value, unsigned int size) {
+    unsigned long value = size == 0 ? header_value
+                        : size == 1 ? cursor[0]
+                        : ((unsigned long) cursor[0] << OFFSET_EXTENDABLE) | cursor[1];
+
+    return value + EXTENDED_BASE[size];
+}
+
+unsigned short CoAPMessageView::getVer() const {
+    return header_.Ver;
+}
+
+unsigned short CoAPMessageView::getT() const {
+    return header_.T;
+}
+
+unsigned short CoAPMessageView::getTKL() const {
+    return header_.TKL;
+}
+
+unsigned short CoAPMessageView::getCode() const {
+    return header_.Code;
+}
+
+unsigned short CoAPMessageView::getMessageId() const {
+    return header_.MessageId;
+}
+
+ByteView CoAPMessageView::getToken() const {
+    return ByteView(options_begin_ - header_.TKL, header_.TKL);
+}
+
+/** Returns payload without payload marker, empty if message has none **/
+ByteView CoAPMessageView::getPayload() const {
+    if (options_end_ == buffer_end_)
+        return ByteView();
+
+    return ByteView(options_end_ + 1, (unsigned int) (buffer_end_ - options_end_ - 1));
+}
+
+CoAPMessageView::OptionIterator CoAPMessageView::beginOptions() const {
+    return OptionIterator(options_begin_, options_end_);
+}
+
+CoAPMessageView::OptionIterator CoAPMessageView::endOptions() const {
+    return OptionIterator(options_end_, options_end_);
+}
+
+/** Returns first option with given number or endOptions() if there is none **/
+CoAPMessageView::OptionIterator CoAPMessageView::findOption(unsigned int number) const {
+    return findOption(number, beginOptions());
+}
+
+/** Returns first option with given number starting from given iterator or endOptions() if there is none.
+ *  Options are sorted so the search stops at first option with greater number. **/
+CoAPMessageView::OptionIterator CoAPMessageView::findOption(unsigned int number, OptionIterator from) const {
+    OptionIterator end = endOptions();
+
+    for (; from != end; ++from) {
+        if (from->getNumber() == number)
+            return from;
+        if (from->getNumber() > number)
+            break;
+    }
+
+    return end;
+}
+
+/** Returns beginning of the buffer that view points at **/
+unsigned char *CoAPMessageView::getBuffer() const {
+    return buffer_begin_;
+}
+
+/** Returns length of the whole message **/
+unsigned int CoAPMessageView::getSize() const {
+    return (unsigned int) (buffer_end_ - buffer_begin_);
+}
+
+/** In debug mode prints contents of message using SPI or std::cout, depending on platform **/
+void CoAPMessageView::print() const {
+    PRINTLN("---CoAP message---");
+    PRINT("Version: ");
+    PRINTLN(TO_STRING(header_.Ver));
+    PRINT("Type: ");
+    PRINTLN(TO_STRING(header_.T));
+    PRINT("Token length: ");
+    PRINTLN(TO_STRING(header_.TKL));
+    PRINT("Code: ");
+    PRINTLN(TO_STRING(header_.Code));
+    PRINT("Message ID: ");
+    PRINTLN(TO_STRING(header_.MessageId));
+
+    OptionIterator iterator = beginOptions();
+    OptionIterator end = endOptions();
+    if (iterator != end) {
+        PRINT("Options:\n");
+        for (; iterator != end; ++iterator) {
+            iterator->print();
+        }
+    }
+
+    ByteView payload = getPayload();
+    if (payload.size() != 0) {
+        PRINT("Payload: \n\t");
+        PRINTLN(CoAPOption::toString(payload.begin(), payload.size()));
+    }
+
+    PRINTLN("");
+}
@@ -0,0 +1,117 @@
+#ifndef COAPLIB_COAPMESSAGEVIEW_H
+#define COAPLIB_COAPMESSAGEVIEW_H
+
+#include "ArrayView.hpp"
+#include "CoAPOption.h"
+
+// Results of parsing a message. Header fields are valid for errors from PARSE_BAD_TOKEN on,
+// token also for errors from PARSE_BAD_OPTION on:
+#define PARSE_OK 0
+#define PARSE_TOO_SHORT 1
+#define PARSE_BAD_VERSION 2
+#define PARSE_BAD_TOKEN 3
+#define PARSE_BAD_OPTION 4
+#define PARSE_EMPTY_PAYLOAD 5
+
+// Biggest option number, options are 16-bit:
+#define MAX_OPTION_NUMBER 0xFFFF
+
+/**
+ * Read-only option pointing at its value inside receive buffer
+ */
+class CoAPOptionView {
+private:
+    unsigned int number_;
+    ByteView value_;
+
+public:
+    CoAPOptionView();
+    CoAPOptionView(unsigned int number, const ByteView &value);
+
+    unsigned int getNumber() const;
+    const ByteView &getValue() const;
+
+    void print() const;
+    const String toString() const;
+    const Block2 toBlock2() const;
+};
+
+/**
+ * Read-only CoAP message parsed in place: header fields are decoded,
+ * token, options and payload are only pointed at inside caller's buffer.
+ * Buffer has to outlive the view. Every read is bounds-checked, so malformed messages are rejected
+ * without allocating anything and parse error tells why.
+ */
+class CoAPMessageView {
+public:
+    /** Walks through options stored in buffer, decoding one option at a time **/
+    class OptionIterator {
+    private:
+        unsigned char* current_;
+        unsigned char* cursor_;
+        unsigned char* options_end_;
+        CoAPOptionView option_;
+
+    public:
+        OptionIterator();
+        OptionIterator(unsigned char* cursor, unsigned char* options_end);
+
+        OptionIterator &operator++();
+        const CoAPOptionView &operator*() const;
+        const CoAPOptionView *operator->() const;
+        bool operator==(const OptionIterator &iterator) const;
+        bool operator!=(const OptionIterator &iterator) const;
+    };
+
+private:
+    struct Header {
+        unsigned short Ver : 2;
+        unsigned short T : 2;
+        unsigned short TKL : 4;
+        unsigned short Code : 8;
+        unsigned short MessageId : 16;
+    } header_;
+
+    unsigned char* buffer_begin_;
+    unsigned char* options_begin_;
+    unsigned char* options_end_;
+    unsigned char* buffer_end_;
+    unsigned char error_;
+
+    unsigned char extractHeader(unsigned char* &cursor);
+    unsigned char extractToken(unsigned char* &cursor);
+    unsigned char extractOptions(unsigned char* &cursor);
+    unsigned char extractPayload(unsigned char* &cursor);
+
+    static unsigned long extendedValue(const unsigned char* cursor, unsigned char header_value, unsigned int size);
+
+public:
+    CoAPMessageView();
+
+    static bool extractOption(unsigned char* &cursor, const unsigned char* buffer_end,
+                              unsigned int &delta, unsigned int &length);
+
+    bool parse(unsigned char* buffer_begin, unsigned int num);
+    unsigned char getError() const;
+
+    unsigned short getVer() const;
+    unsigned short getT() const;
+    unsigned short getTKL() const;
+    unsigned short getCode() const;
+    unsigned short getMessageId() const;
+
+    ByteView getToken() const;
+    ByteView getPayload() const;
+
+    OptionIterator beginOptions() const;
+    OptionIterator endOptions() const;
+    OptionIterator findOption(unsigned int number) const;
+    OptionIterator findOption(unsigned int number, OptionIterator from) const;
+
+    unsigned char *getBuffer() const;
+    unsigned int getSize() const;
+
+    void print() const;
+};
+
+#endif //COAPLIB_COAPMESSAGEVIEW_H
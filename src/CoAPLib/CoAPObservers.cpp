@@ -0,0 +1,91 @@
+#include "CoAPObservers.h"
+
+CoAPObservers::CoAPObservers(unsigned int capacity) :
+        capacity_(capacity),
+        size_(0),
+        sequence_(0),
+        value_(0),
+        has_value_(false) {
+    observers_ = new Observer[capacity_];
+}
+
+CoAPObservers::~CoAPObservers() {
+    delete[] observers_;
+}
+
+/** Returns position of observer identified by given endpoint and token, -1 if there is none **/
+int CoAPObservers::locate(const CoAPEndpoint &endpoint, const TokenArray &token) const {
+    for (unsigned int i = 0; i < size_; ++i) {
+        const Observer &observer = observers_[i];
+
+        if (observer.endpoint == endpoint
+            && ByteView(observer.token.begin(), observer.token.size()) == ByteView(token.begin(), token.size()))
+            return (int) i;
+    }
+    return -1;
+}
+
+/** Removes observer at given position, keeping the rest in order of registration **/
+void CoAPObservers::erase(unsigned int position) {
+    for (unsigned int i = position + 1; i < size_; ++i) {
+        observers_[i - 1] = static_cast<Observer &&>(observers_[i]);
+    }
+    --size_;
+}
+
+/** Registers observer, registering it again makes it the newest one. When list is full the oldest observer is evicted **/
+void CoAPObservers::add(const CoAPEndpoint &endpoint, const TokenArray &token) {
+    if (capacity_ == 0)
+        return;
+
+    int position = locate(endpoint, token);
+    if (position >= 0)
+        erase((unsigned int) position);
+    else if (size_ == capacity_)
+        erase(0);
+
+    observers_[size_].endpoint = endpoint;
+    observers_[size_].token = token;
+    ++size_;
+}
+
+/** Removes observer, returns false if it was not registered **/
+bool CoAPObservers::remove(const CoAPEndpoint &endpoint, const TokenArray &token) {
+    int position = locate(endpoint, token);
+    if (position < 0)
+        return false;
+
+    erase((unsigned int) position);
+    return true;
+}
+
+/** Tells if observer is registered **/
+bool CoAPObservers::contains(const CoAPEndpoint &endpoint, const TokenArray &token) const {
+    return locate(endpoint, token) >= 0;
+}
+
+/** Remembers new value of resource, returns true and advances sequence number if it has changed **/
+bool CoAPObservers::update(unsigned long value) {
+    if (has_value_ && value_ == value)
+        return false;
+
+    value_ = value;
+    has_value_ = true;
+    sequence_ = (sequence_ + 1) & OBSERVE_SEQUENCE_MASK;
+    return true;
+}
+
+/** Returns sequence number of the latest notification, 24 bits long **/
+unsigned long CoAPObservers::getSequence() const {
+    return sequence_;
+}
+
+/** Returns observer at given position, the oldest one is first **/
+const Observer &CoAPObservers::operator[](unsigned int index) const {
+    return observers_[index];
+}
+
+/** Returns number of observers **/
+unsigned int CoAPObservers::size() const {
+    return size_;
+}
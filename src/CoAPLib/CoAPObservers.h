@@ -0,0 +1,54 @@
+#ifndef COAPLIB_COAPOBSERVERS_H
+#define COAPLIB_COAPOBSERVERS_H
+
+#include "CoAPEndpoint.h"
+#include "CoAPMessage.h"
+#include "../Environment.h"
+
+#define OBSERVE_REGISTER 0
+#define OBSERVE_DEREGISTER 1
+#define OBSERVE_SEQUENCE_MASK 0xFFFFFFUL
+
+/**
+ * Client which wants to be notified about changes of resource
+ */
+struct Observer {
+    CoAPEndpoint endpoint;
+    TokenArray token;
+};
+
+/**
+ * Bounded list of observers of single resource (RFC 7641), along with last notified value
+ * and sequence number of notifications. Observers are kept in order of registration,
+ * so when list is full the oldest one is evicted.
+ */
+class CoAPObservers {
+private:
+    Observer* observers_;
+    unsigned int capacity_;
+    unsigned int size_;
+    unsigned long sequence_;
+    unsigned long value_;
+    bool has_value_;
+
+    int locate(const CoAPEndpoint &endpoint, const TokenArray &token) const;
+    void erase(unsigned int position);
+
+    CoAPObservers(const CoAPObservers &observers);
+    CoAPObservers &operator=(const CoAPObservers &observers);
+public:
+    CoAPObservers(unsigned int capacity);
+    ~CoAPObservers();
+
+    void add(const CoAPEndpoint &endpoint, const TokenArray &token);
+    bool remove(const CoAPEndpoint &endpoint, const TokenArray &token);
+    bool contains(const CoAPEndpoint &endpoint, const TokenArray &token) const;
+
+    bool update(unsigned long value);
+    unsigned long getSequence() const;
+
+    const Observer &operator[](unsigned int index) const;
+    unsigned int size() const;
+};
+
+#endif //COAPLIB_COAPOBSERVERS_H
@@ -1,38 +1,47 @@
 #include "CoAPOption.h"
+#include "CoAPMessageView.h"
 
 CoAPOption::CoAPOption() : number_(0), value_() {}
 
 /** Creates Block2 option **/
-CoAPOption::CoAPOption(const Block2 &block2) : number_(OPTION_BLOCK2) {
-//    switch (block2) {
-//        case 1:
-        unsigned char value = (unsigned char) ((block2.num << 4) | ((block2.m << 3) & 0x08) | (block2.szx - 4));
-         value_.pushBack(value);
-//            break;
-//        case 2:
-//            // TODO
-//            break;
-//        case 3:
-//            // TODO
-//            break;
-//        default:
-//            // TODO
-//            break;
+CoAPOption::CoAPOption(const Block2 &block2) : CoAPOption(OPTION_BLOCK2, block2) {}
+
+/** Creates Block1 or Block2 option, value takes 1, 2 or 3 bytes depending on block number **/
+CoAPOption::CoAPOption(unsigned int number, const Block2 &block) : number_(number) {
+    unsigned long value = ((unsigned long) block.num << 4) | ((block.m << 3) & 0x08) | ((block.szx - 4) & 0x07);
+
+    if (block.num >= 4096)
+        value_.pushBack((unsigned char) (value >> 16));
+    if (block.num >= 16)
+        value_.pushBack((unsigned char) (value >> 8));
+    value_.pushBack((unsigned char) value);
 }
 
 /** Creates Option with given number and value **/
-CoAPOption::CoAPOption(unsigned int number, String value) : CoAPOption() {
-    ByteArray value_bytes(value.length());
-    for (int i = 0; i < value.length(); ++i) {
-        value_bytes.pushBack((const unsigned char &) value[i]);
-    }
-
-    number_ = number;
-    value_ = value_bytes;
+CoAPOption::CoAPOption(unsigned int number, String value) : number_(number), value_() {
+    value_.deserialize((const unsigned char *) value.c_str(), value.length());
 }
 
 CoAPOption::CoAPOption(unsigned int number, ByteArray value) : number_(number), value_(value) {}
 
+/** Creates option with copy of value pointed at by view **/
+CoAPOption::CoAPOption(unsigned int number, const ByteView &value) : number_(number), value_() {
+    value_.deserialize(value.begin(), value.size());
+}
+
+/** Returns number of bytes taken by options written into char array, options have to be sorted by number **/
+unsigned int CoAPOption::serializedSize(const OptionArray &options) {
+    unsigned int size = 0;
+    unsigned int previous_number = 0;
+
+    for (unsigned int i = 0; i < options.size(); ++i) {
+        size += options[i].serializedSize(options[i].getNumber() - previous_number);
+        previous_number = options[i].getNumber();
+    }
+
+    return size;
+}
+
 /** Writes options from array into unsigned char array **/
 void CoAPOption::serialize(unsigned char *&cursor, const OptionArray &options) {
     if (options.size() > 0) {
@@ -46,20 +55,36 @@ void CoAPOption::serialize(unsigned char *&cursor, const OptionArray &options) {
     }
 }
 
-/** Writes options from unsigned char array into OptionArray */
-void CoAPOption::deserialize(unsigned char *&cursor, unsigned char *buffer_end, OptionArray &options)  {
-    unsigned int delta_sum = 0;
+/** Reads options from unsigned char array into OptionArray, stopping behind payload marker.
+ *  Every option is bounds-checked before its value is copied. Returns false if option is malformed,
+ *  options read before it are kept. **/
+bool CoAPOption::deserialize(unsigned char *&cursor, unsigned char *buffer_end, OptionArray &options)  {
+    unsigned long number = 0;
+    unsigned int delta = 0;
+    unsigned int length = 0;
 
     while (cursor != buffer_end && *cursor != PAYLOAD_MARKER) {
-        CoAPOption option;
-        option.deserialize(cursor, buffer_end, delta_sum);
-        options.pushBack(option);
+        if (!CoAPMessageView::extractOption(cursor, buffer_end, delta, length)
+            || (unsigned int) (buffer_end - cursor) < length)
+            return false;
+
+        number += delta;
+        if (number > MAX_OPTION_NUMBER)
+            return false;
 
-        delta_sum = option.getNumber();
+        options.pushBack(CoAPOption((unsigned int) number, ByteView(cursor, length)));
+        cursor += length;
     }
 
     if (cursor != buffer_end)
         ++cursor;
+
+    return true;
+}
+
+/** Returns number of bytes taken by option written with given delta: header, extended delta and length, value **/
+unsigned int CoAPOption::serializedSize(unsigned int delta) const {
+    return 1 + extendableSize(delta) + extendableSize(value_.size()) + value_.size();
 }
 
 void CoAPOption::serialize(unsigned char* &cursor, unsigned int delta) const {
@@ -67,6 +92,11 @@ void CoAPOption::serialize(unsigned char* &cursor, unsigned int delta) const {
     insert(cursor, value_);
 }
 
+/** Writes only option header with extended delta and length, value is left to the caller **/
+void CoAPOption::serializeHeader(unsigned char* &cursor, unsigned int delta) const {
+    insert(cursor, delta, value_.size());
+}
+
 /** Takes care of setting proper option delta **/
 void CoAPOption::insert(unsigned char* &cursor, unsigned int delta, unsigned int length) const {
     unsigned char header_delta = 0;
@@ -80,6 +110,16 @@ void CoAPOption::insert(unsigned char* &cursor, unsigned int delta, unsigned int
     insertExtendableValue(cursor, header_length, length);
 }
 
+/** Returns number of extended bytes needed to write delta or length with given value **/
+unsigned int CoAPOption::extendableSize(unsigned int extendable_value) {
+    if (extendable_value < 13)
+        return 0;
+    else if (extendable_value < 269)
+        return 1;
+    else
+        return 2;
+}
+
 void CoAPOption::prepareExtendable(unsigned char &header_value, unsigned int &extendable_value) const {
     if (extendable_value < 13) {
         header_value = (unsigned char) extendable_value;
@@ -115,67 +155,16 @@ void CoAPOption::insertExtendableValue(unsigned char* &cursor, unsigned char hea
     ++cursor;
 }
 
-void CoAPOption::insert(unsigned char* &cursor, const ByteArray &bytes) const {
+void CoAPOption::insert(unsigned char* &cursor, const OptionValue &bytes) const {
     bytes.serialize(cursor);
     cursor += bytes.size();
 }
 
-/** Creates single option form part of the char array **/
-void CoAPOption::deserialize(unsigned char* &cursor, unsigned char* &buffer_end, unsigned int delta_sum) {
-    unsigned int delta = 0;
-    unsigned int length = 0;
-    
-    extractExtendables(cursor, delta, length);
-    extractValue(cursor, length);
-    number_ = delta_sum + delta;
-}
-
-void CoAPOption::extractExtendables(unsigned char *&cursor, unsigned int &delta, unsigned int &length) {
-    unsigned char header_delta = 0;
-    unsigned char header_length = 0;
-
-    extractHeaderValues(cursor, header_delta, header_length);
-    extractExtendableValue(cursor, header_delta, delta);
-    extractExtendableValue(cursor, header_length, length);
-}
-
-void CoAPOption::extractHeaderValues(unsigned char* &cursor, unsigned char &header_delta, unsigned char &header_length) const {
-    header_delta = (*cursor & MASK_DELTA) >> OFFSET_DELTA;
-    header_length = *cursor & MASK_LENGTH;
-    ++cursor;
-}
-
-void CoAPOption::extractExtendableValue(unsigned char *&cursor, unsigned char header_value, unsigned int &extendable_value) {
-    if (header_value < 13) {
-        extendable_value = header_value;
-    }
-    else if (header_value == 13) {
-        extendable_value += 13;
-    }
-    else if (header_value == 14) {
-        extendable_value += 269;
-    }
-}
-
-
-void CoAPOption::extractValue(unsigned char *&cursor, unsigned int num) {
-    value_.deserialize(cursor, num);
-    cursor += num;
-}
-
-CoAPOption &CoAPOption::operator=(const CoAPOption &option) {
-    if(&option != this) {
-        number_ = option.number_;
-        value_ = option.value_;
-    }
-    return *this;
-}
-
 unsigned int CoAPOption::getNumber() const {
     return number_;
 }
 
-const ByteArray &CoAPOption::getValue() const {
+const OptionValue &CoAPOption::getValue() const {
     return value_;
 }
 
@@ -185,6 +174,7 @@ void CoAPOption::print() const {
     PRINT(": ");
 
     switch (number_) {
+        case OPTION_BLOCK1:
         case OPTION_BLOCK2:
             toBlock2().print();
             break;
@@ -197,34 +187,36 @@ void CoAPOption::print() const {
 }
 
 const String CoAPOption::toString() const {
+    return toString(value_.begin(), value_.size());
+}
+
+const Block2 CoAPOption::toBlock2() const {
+    return toBlock2(value_.begin(), value_.size());
+}
+
+/** Converts raw option value into String **/
+const String CoAPOption::toString(const unsigned char *value, unsigned int length) {
     String s;
 
-    for(int i = 0; i < value_.size(); ++i){
-        s += char(value_[i]);
+    for(int i = 0; i < length; ++i){
+        s += char(value[i]);
     }
 
     return s;
 }
 
-const Block2 CoAPOption::toBlock2() const {
-    Block2 result;
-
-    switch (value_.size()) {
-        case 1:
-            result.num = value_[0] >> 4;
-            result.m = (unsigned int) ((value_[0] >> 3) & 0x01);
-            result.szx = (unsigned int) (value_[0] & 0x07) + 4;
-            break;
-        case 2:
-            // TODO
-            break;
-        case 3:
-            // TODO
-            break;
-        default:
-            // TODO
-            break;
+/** Decodes raw Block1 or Block2 option value, empty value means first 16-byte block.
+ *  Values longer than 3 bytes are invalid, only their last 3 bytes are decoded.
+ *  Reserved SZX 7 is decoded as RESERVED_BLOCK_SZX, so that caller can reject it **/
+const Block2 CoAPOption::toBlock2(const unsigned char *value, unsigned int length) {
+    unsigned long bytes = 0;
+    for (unsigned int i = length > 3 ? length - 3 : 0; i < length; ++i) {
+        bytes = (bytes << 8) | value[i];
     }
 
+    Block2 result;
+    result.num = bytes >> 4;
+    result.m = (bytes >> 3) & 0x01;
+    result.szx = (bytes & 0x07) + 4;
     return result;
 }
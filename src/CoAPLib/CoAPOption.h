@@ -2,15 +2,24 @@
 #define OPTION_H
 
 #include "Array.hpp"
+#include "ArrayView.hpp"
+#include "InlineArray.hpp"
 #include "CoAPConstants.h"
 
+// SZX 7 is reserved (RFC 7959), it is decoded as szx 11 and has to be rejected:
+#define RESERVED_BLOCK_SZX 11
+
+// Number of bits of block number:
+#define BLOCK_NUM_BITS 20
+
 /**
- * This struct describes Block2 option
+ * This struct describes Block1 and Block2 options. Unlike SZX sent in option,
+ * szx is binary logarithm of block size (from 4 for 16 bytes to 10 for 1024 bytes)
  */
 struct Block2 {
-    unsigned int num : 20;
-    unsigned int m : 1;
-    unsigned int szx : 3;
+    unsigned long num : BLOCK_NUM_BITS;
+    unsigned long m : 1;
+    unsigned long szx : 4;
 
     void print() const {
         PRINT(num);
@@ -36,41 +45,44 @@ struct Block2 {
  */
 class CoAPOption;
 typedef Array<CoAPOption> OptionArray;
+typedef InlineArray<unsigned char, OPTION_INLINE_LENGTH> OptionValue;
 
 class CoAPOption {
     unsigned int number_;
-    ByteArray value_;
+    OptionValue value_;
 
     void insert(unsigned char* &cursor, unsigned int delta, unsigned int length) const;
-    void insert(unsigned char* &cursor, const ByteArray &bytes) const;
-    void extractExtendables(unsigned char* &cursor, unsigned int &delta, unsigned int &length);
-    void extractValue(unsigned char* &cursor, unsigned int num);
+    void insert(unsigned char* &cursor, const OptionValue &bytes) const;
 
+    static unsigned int extendableSize(unsigned int extendable_value);
     void prepareExtendable(unsigned char &header_value, unsigned int &extendable_value) const;
     void insertHeaderValues(unsigned char* &cursor, unsigned char &header_delta, unsigned char &header_length) const;
     void insertExtendableValue(unsigned char* &cursor, unsigned char header_value, unsigned int extendable_value) const;
-    void extractHeaderValues(unsigned char* &cursor, unsigned char &header_delta, unsigned char &header_length) const;
-    void extractExtendableValue(unsigned char* &cursor, unsigned char header_value, unsigned int &extendable_value);
 
 public:
     CoAPOption();
     CoAPOption(const Block2 &block2);
+    CoAPOption(unsigned int number, const Block2 &block);
     CoAPOption(unsigned int number, String value);
     CoAPOption(unsigned int number, ByteArray value);
+    CoAPOption(unsigned int number, const ByteView &value);
 
+    static unsigned int serializedSize(const OptionArray &options);
     static void serialize(unsigned char *&cursor, const OptionArray &options);
-    static void deserialize(unsigned char *&cursor, unsigned char *buffer_end, OptionArray &options);
+    static bool deserialize(unsigned char *&cursor, unsigned char *buffer_end, OptionArray &options);
+    unsigned int serializedSize(unsigned int delta) const;
     void serialize(unsigned char* &cursor, unsigned int delta) const;
-    void deserialize(unsigned char* &cursor, unsigned char* &buffer_end, unsigned int delta_sum);
-
-    CoAPOption &operator=(const CoAPOption & option);
+    void serializeHeader(unsigned char* &cursor, unsigned int delta) const;
 
     unsigned int getNumber() const;
-    const ByteArray &getValue() const;
+    const OptionValue &getValue() const;
 
     void print() const;
     const String toString() const;
     const Block2 toBlock2() const;
+
+    static const String toString(const unsigned char *value, unsigned int length);
+    static const Block2 toBlock2(const unsigned char *value, unsigned int length);
 };
 
 #endif //OPTION_H
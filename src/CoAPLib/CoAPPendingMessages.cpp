@@ -0,0 +1,173 @@
+#include "CoAPPendingMessages.h"
+
+unsigned short PendingMessage::getT() const {
+    return type;
+}
+
+unsigned short PendingMessage::getCode() const {
+    return code;
+}
+
+unsigned short PendingMessage::getMessageId() const {
+    return message_id;
+}
+
+const TokenArray &PendingMessage::getToken() const {
+    return token;
+}
+
+void PendingMessage::print() const {
+    PRINTLN("---Pending message---");
+    PRINT("Radio ID: ");
+    PRINTLN(radio_id);
+    PRINT("Message ID: ");
+    PRINTLN(message_id);
+    PRINT("Type: ");
+    PRINTLN(type);
+    PRINT("Code: ");
+    PRINTLN(code);
+    PRINT("Timestamp: ");
+    PRINTLN(timestamp);
+    PRINTLN("");
+}
+
+/** Creates table able to hold given number of messages.
+ *  Index has at least twice as many slots as there are messages, rounded up to power of two. **/
+CoAPPendingMessages::CoAPPendingMessages(unsigned int capacity) :
+        capacity_(capacity),
+        index_capacity_(1),
+        size_(0),
+        high_water_mark_(0) {
+    while (index_capacity_ < capacity_ * 2) {
+        index_capacity_ *= 2;
+    }
+
+    messages_ = new PendingMessage[capacity_];
+    used_ = new bool[capacity_];
+    free_handles_ = new unsigned short[capacity_];
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        used_[i] = false;
+        free_handles_[i] = (unsigned short) (capacity_ - 1 - i);
+    }
+
+    index_ = new unsigned short[index_capacity_];
+    for (unsigned int i = 0; i < index_capacity_; ++i) {
+        index_[i] = (unsigned short) NO_PENDING_MESSAGE;
+    }
+}
+
+CoAPPendingMessages::~CoAPPendingMessages() {
+    delete[] messages_;
+    delete[] used_;
+    delete[] free_handles_;
+    delete[] index_;
+}
+
+/** Returns index slot at which search for message with given radio ID starts **/
+unsigned int CoAPPendingMessages::home(unsigned short radio_id) const {
+    // Multiplying by odd constant permutes IDs, so consecutive IDs do not form long clusters
+    return (unsigned int) ((unsigned short) (radio_id * 40503u)) & (index_capacity_ - 1);
+}
+
+unsigned int CoAPPendingMessages::next(unsigned int slot) const {
+    return (slot + 1) & (index_capacity_ - 1);
+}
+
+/** Returns index slot pointing at message with given radio ID or -1 if there is none **/
+int CoAPPendingMessages::locate(unsigned short radio_id) const {
+    for (unsigned int slot = home(radio_id); index_[slot] != (unsigned short) NO_PENDING_MESSAGE; slot = next(slot)) {
+        if (messages_[index_[slot]].radio_id == radio_id)
+            return (int) slot;
+    }
+
+    return -1;
+}
+
+/** Adds message to the table, returns its handle or NO_PENDING_MESSAGE if table is full **/
+int CoAPPendingMessages::insert(const PendingMessage &message) {
+    if (size_ == capacity_)
+        return NO_PENDING_MESSAGE;
+
+    unsigned short handle = free_handles_[capacity_ - 1 - size_];
+    messages_[handle] = message;
+    used_[handle] = true;
+
+    unsigned int slot = home(message.radio_id);
+    while (index_[slot] != (unsigned short) NO_PENDING_MESSAGE) {
+        slot = next(slot);
+    }
+    index_[slot] = handle;
+
+    if (++size_ > high_water_mark_)
+        high_water_mark_ = size_;
+
+    return handle;
+}
+
+/** Returns handle of message with given radio ID or NO_PENDING_MESSAGE **/
+int CoAPPendingMessages::find(unsigned short radio_id) const {
+    int slot = locate(radio_id);
+    return slot < 0 ? NO_PENDING_MESSAGE : index_[slot];
+}
+
+/** Moves message with given radio ID out of the table, returns false if there was none **/
+bool CoAPPendingMessages::take(unsigned short radio_id, PendingMessage &message) {
+    int handle = find(radio_id);
+    if (handle == NO_PENDING_MESSAGE)
+        return false;
+
+    message = static_cast<PendingMessage &&>(messages_[handle]);
+    remove(handle);
+    return true;
+}
+
+/** Returns message with given handle or nullptr if handle is not in use **/
+const PendingMessage *CoAPPendingMessages::at(int handle) const {
+    if (handle < 0 || (unsigned int) handle >= capacity_ || !used_[handle])
+        return nullptr;
+
+    return &messages_[handle];
+}
+
+/** Removes message with given handle. Index entries following it are moved back
+ *  if they would not be found otherwise. **/
+void CoAPPendingMessages::remove(int handle) {
+    if (at(handle) == nullptr)
+        return;
+
+    unsigned int mask = index_capacity_ - 1;
+    unsigned int hole = home(messages_[handle].radio_id);
+    while (index_[hole] != (unsigned short) handle) {
+        hole = next(hole);
+    }
+
+    for (unsigned int current = next(hole); index_[current] != (unsigned short) NO_PENDING_MESSAGE; current = next(current)) {
+        unsigned int current_home = home(messages_[index_[current]].radio_id);
+
+        // Entry can fill the hole only if the hole lies between its home slot and its current slot
+        if (((current - current_home) & mask) >= ((current - hole) & mask)) {
+            index_[hole] = index_[current];
+            hole = current;
+        }
+    }
+    index_[hole] = (unsigned short) NO_PENDING_MESSAGE;
+
+    used_[handle] = false;
+    --size_;
+    free_handles_[capacity_ - 1 - size_] = (unsigned short) handle;
+}
+
+/** Returns number of pending messages **/
+unsigned int CoAPPendingMessages::size() const {
+    return size_;
+}
+
+/** Returns max number of pending messages **/
+unsigned int CoAPPendingMessages::capacity() const {
+    return capacity_;
+}
+
+/** Returns the biggest number of messages that were pending at the same time **/
+unsigned int CoAPPendingMessages::getHighWaterMark() const {
+    return high_water_mark_;
+}
@@ -0,0 +1,77 @@
+#ifndef COAPLIB_COAPPENDINGMESSAGES_H
+#define COAPLIB_COAPPENDINGMESSAGES_H
+
+#include "ArrayView.hpp"
+#include "CoAPEndpoint.h"
+#include "CoAPMessage.h"
+#include "CoAPResources.h"
+#include "../Environment.h"
+
+#define NO_PENDING_MESSAGE -1
+
+/**
+ * Request waiting for an answer, holds only what is needed to build the response
+ */
+struct PendingMessage {
+    unsigned short radio_id;
+    unsigned short message_id;
+    unsigned char type;
+    unsigned char code;
+    TokenArray token;
+    CoAPEndpoint endpoint;
+    unsigned long timestamp;
+    Node* resource;
+    bool blockwise;
+    Block2 block1;
+
+    unsigned short getT() const;
+    unsigned short getCode() const;
+    unsigned short getMessageId() const;
+    const TokenArray &getToken() const;
+
+    void print() const;
+};
+
+/**
+ * Fixed-capacity table of pending messages keyed by radio ID, which gateway assigns to every radio request
+ * and radio reply carries back. Client's message ID, token and endpoint are kept only to build the response,
+ * so requests of different clients with the same message ID do not get mixed up.
+ * Messages are kept in a pool and never move, so their handles stay valid until removal
+ * and can be referenced from outside (eg. by timers). Handles are found through an
+ * open-addressing index hashed by radio ID. Removal shifts following index entries back, so there are
+ * no tombstones and insert, lookup and removal stay O(1) on average.
+ */
+class CoAPPendingMessages {
+private:
+    PendingMessage* messages_;
+    bool* used_;
+    unsigned short* free_handles_;
+    unsigned short* index_;
+    unsigned int capacity_;
+    unsigned int index_capacity_;
+    unsigned int size_;
+    unsigned int high_water_mark_;
+
+    unsigned int home(unsigned short radio_id) const;
+    unsigned int next(unsigned int slot) const;
+    int locate(unsigned short radio_id) const;
+
+    CoAPPendingMessages(const CoAPPendingMessages &pending_messages);
+    CoAPPendingMessages &operator=(const CoAPPendingMessages &pending_messages);
+public:
+    CoAPPendingMessages(unsigned int capacity);
+    ~CoAPPendingMessages();
+
+    int insert(const PendingMessage &message);
+    int find(unsigned short radio_id) const;
+    bool take(unsigned short radio_id, PendingMessage &message);
+
+    const PendingMessage *at(int handle) const;
+    void remove(int handle);
+
+    unsigned int size() const;
+    unsigned int capacity() const;
+    unsigned int getHighWaterMark() const;
+};
+
+#endif //COAPLIB_COAPPENDINGMESSAGES_H
@@ -0,0 +1,94 @@
+#include "CoAPQueues.h"
+
+/** Creates inbound and outbound queues of given capacities for each transport **/
+CoAPQueues::CoAPQueues(unsigned int coap_capacity, unsigned int radio_capacity) :
+        coap_in_(coap_capacity),
+        coap_out_(coap_capacity),
+        radio_in_(radio_capacity),
+        radio_out_(radio_capacity) {}
+
+/** Called by UDP side. Queues copy of received datagram for handler, returns false if it was dropped **/
+bool CoAPQueues::receive(const unsigned char *buffer, unsigned int size, const CoAPEndpoint &endpoint) {
+    CoAPDatagram datagram;
+    datagram.endpoint = endpoint;
+    datagram.data.deserialize(buffer, size);
+    return coap_in_.push(static_cast<CoAPDatagram &&>(datagram));
+}
+
+/** Called by radio side. Queues received message for handler, returns false if it was dropped **/
+bool CoAPQueues::receive(const RadioMessage &message) {
+    return radio_in_.push(message);
+}
+
+/** Called by UDP side. Takes next datagram which should be sent, returns false if there is none **/
+bool CoAPQueues::takeDatagram(CoAPDatagram &datagram) {
+    return coap_out_.pop(datagram);
+}
+
+/** Called by radio side. Takes next message which should be sent, returns false if there is none **/
+bool CoAPQueues::takeRadioMessage(RadioMessage &message) {
+    return radio_out_.pop(message);
+}
+
+/** Called by handler side. Passes received messages to handler, radio replies first, because requests
+ *  waiting for them may time out soon. Returns number of handled messages. **/
+unsigned int CoAPQueues::dispatch(CoAPHandler &handler, unsigned int max_messages) {
+    unsigned int handled = 0;
+    RadioMessage radioMessage;
+    CoAPDatagram datagram;
+
+    while (handled < max_messages && radio_in_.pop(radioMessage)) {
+        handler.handleMessage(radioMessage);
+        ++handled;
+    }
+
+    while (handled < max_messages && coap_in_.pop(datagram)) {
+        CoAPMessageView message;
+        if (message.parse(datagram.data.begin(), datagram.data.size()))
+            handler.handleMessage(message, datagram.endpoint);
+        else
+            handler.handleMalformed(message, datagram.endpoint);
+        ++handled;
+    }
+
+    return handled;
+}
+
+/** Queues message for the only client **/
+void CoAPQueues::operator()(const CoAPMessage &message) {
+    (*this)(message, CoAPEndpoint());
+}
+
+/** Queues serialized message for UDP side **/
+void CoAPQueues::operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+    CoAPDatagram datagram;
+    datagram.endpoint = endpoint;
+    datagram.data.resize(message.serializedSize());
+    message.serialize(datagram.data.begin(), datagram.data.size());
+    coap_out_.push(static_cast<CoAPDatagram &&>(datagram));
+}
+
+/** Queues message for radio side **/
+void CoAPQueues::operator()(const RadioMessage &message) {
+    radio_out_.push(message);
+}
+
+/** Returns queue of received datagrams, eg. to check how many of them were dropped **/
+const RingBuffer<CoAPDatagram> &CoAPQueues::getCoAPInbound() const {
+    return coap_in_;
+}
+
+/** Returns queue of datagrams waiting to be sent **/
+const RingBuffer<CoAPDatagram> &CoAPQueues::getCoAPOutbound() const {
+    return coap_out_;
+}
+
+/** Returns queue of received radio messages **/
+const RingBuffer<RadioMessage> &CoAPQueues::getRadioInbound() const {
+    return radio_in_;
+}
+
+/** Returns queue of radio messages waiting to be sent **/
+const RingBuffer<RadioMessage> &CoAPQueues::getRadioOutbound() const {
+    return radio_out_;
+}
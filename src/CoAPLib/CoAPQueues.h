@@ -0,0 +1,58 @@
+#ifndef COAPLIB_COAPQUEUES_H
+#define COAPLIB_COAPQUEUES_H
+
+#include "CoAPEndpoint.h"
+#include "CoAPHandler.h"
+#include "CoAPMessageListener.h"
+#include "RingBuffer.hpp"
+#include "../Environment.h"
+#include "../RadioLib.h"
+
+/**
+ * Serialized CoAP message along with endpoint it comes from or goes to
+ */
+struct CoAPDatagram {
+    CoAPEndpoint endpoint;
+    ByteArray data;
+};
+
+/**
+ * Bounded lock-free queues between CoAPHandler and transports, so each transport can be driven by its own
+ * thread and slow radio write does not hold up UDP and vice versa. On AVR only radio side can run in interrupt,
+ * datagrams are copied into allocated memory, so UDP side has to be called from main loop.
+ * Every queue has exactly one producer and one consumer:
+ *  - UDP side pushes received datagrams (receive) and pops datagrams to send (takeDatagram),
+ *  - radio side pushes received messages (receive) and pops messages to send (takeRadioMessage),
+ *  - handler side drains received messages (dispatch) and, being listener of handler, pushes messages to send.
+ * Messages which do not fit are dropped and counted by their queue.
+ */
+class CoAPQueues : public CoAPMessageListener, public RadioMessageListener {
+private:
+    RingBuffer<CoAPDatagram> coap_in_;
+    RingBuffer<CoAPDatagram> coap_out_;
+    RingBuffer<RadioMessage> radio_in_;
+    RingBuffer<RadioMessage> radio_out_;
+
+    CoAPQueues(const CoAPQueues &queues);
+    CoAPQueues &operator=(const CoAPQueues &queues);
+public:
+    CoAPQueues(unsigned int coap_capacity = COAP_QUEUE_CAPACITY, unsigned int radio_capacity = RADIO_QUEUE_CAPACITY);
+
+    bool receive(const unsigned char *buffer, unsigned int size, const CoAPEndpoint &endpoint = CoAPEndpoint());
+    bool receive(const RadioMessage &message);
+    bool takeDatagram(CoAPDatagram &datagram);
+    bool takeRadioMessage(RadioMessage &message);
+
+    unsigned int dispatch(CoAPHandler &handler, unsigned int max_messages = ~0u);
+
+    void operator()(const CoAPMessage &message) override;
+    void operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) override;
+    void operator()(const RadioMessage &message) override;
+
+    const RingBuffer<CoAPDatagram> &getCoAPInbound() const;
+    const RingBuffer<CoAPDatagram> &getCoAPOutbound() const;
+    const RingBuffer<RadioMessage> &getRadioInbound() const;
+    const RingBuffer<RadioMessage> &getRadioOutbound() const;
+};
+
+#endif //COAPLIB_COAPQUEUES_H
@@ -0,0 +1,53 @@
+#include "CoAPResourceHandler.h"
+
+CoAPResourceHandler::CoAPResourceHandler(unsigned char flags) : flags_(flags) {}
+
+CoAPResourceHandler::~CoAPResourceHandler() {}
+
+/** Passes request to method matching its code **/
+unsigned short CoAPResourceHandler::handle(const CoAPMessageView &request, CoAPMessage &response) {
+    switch (request.getCode()) {
+        case CODE_GET:
+            return get(request, response);
+        case CODE_POST:
+            return post(request, response);
+        case CODE_PUT:
+            return put(request, response);
+        case CODE_DELETE:
+            return remove(request, response);
+        default:
+            return CODE_METHOD_NOT_ALLOWED;
+    }
+}
+
+unsigned short CoAPResourceHandler::get(const CoAPMessageView &request, CoAPMessage &response) {
+    return CODE_METHOD_NOT_ALLOWED;
+}
+
+unsigned short CoAPResourceHandler::post(const CoAPMessageView &request, CoAPMessage &response) {
+    return CODE_METHOD_NOT_ALLOWED;
+}
+
+unsigned short CoAPResourceHandler::put(const CoAPMessageView &request, CoAPMessage &response) {
+    return CODE_METHOD_NOT_ALLOWED;
+}
+
+unsigned short CoAPResourceHandler::remove(const CoAPMessageView &request, CoAPMessage &response) {
+    return CODE_METHOD_NOT_ALLOWED;
+}
+
+/** Points at representation kept by handler, which is served to GET after get has set options of response.
+ *  Only requested block of it is copied into response, so it has to stay valid until response is sent.
+ *  Returns false if get sets the whole payload itself. **/
+bool CoAPResourceHandler::getRepresentation(const CoAPMessageView &request, ByteView &representation) {
+    return false;
+}
+
+unsigned char CoAPResourceHandler::getFlags() const {
+    return flags_;
+}
+
+/** Tells if clients can register as observers of resource **/
+bool CoAPResourceHandler::isObservable() const {
+    return (flags_ & RESOURCE_OBSERVABLE) != 0;
+}
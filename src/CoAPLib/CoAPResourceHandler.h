@@ -0,0 +1,36 @@
+#ifndef COAPLIB_COAPRESOURCEHANDLER_H
+#define COAPLIB_COAPRESOURCEHANDLER_H
+
+#include "ArrayView.hpp"
+#include "CoAPMessage.h"
+#include "CoAPMessageView.h"
+
+#define RESOURCE_OBSERVABLE 0x01
+
+/**
+ * Part of callback used to serve requests to resource. Handler is attached to node of resource tree,
+ * so request is passed to it right after routing. Every method gets response already addressed to
+ * the client, fills its options and payload and returns response code. Methods which are not
+ * overridden answer with 4.05 Method Not Allowed. Body of POST or PUT sent in blocks (Block1)
+ * is reassembled first, so handler is called once with the whole body.
+ */
+class CoAPResourceHandler {
+private:
+    unsigned char flags_;
+public:
+    CoAPResourceHandler(unsigned char flags = 0);
+    virtual ~CoAPResourceHandler();
+
+    unsigned short handle(const CoAPMessageView &request, CoAPMessage &response);
+
+    virtual unsigned short get(const CoAPMessageView &request, CoAPMessage &response);
+    virtual unsigned short post(const CoAPMessageView &request, CoAPMessage &response);
+    virtual unsigned short put(const CoAPMessageView &request, CoAPMessage &response);
+    virtual unsigned short remove(const CoAPMessageView &request, CoAPMessage &response);
+    virtual bool getRepresentation(const CoAPMessageView &request, ByteView &representation);
+
+    unsigned char getFlags() const;
+    bool isObservable() const;
+};
+
+#endif //COAPLIB_COAPRESOURCEHANDLER_H
@@ -1,6 +1,15 @@
 #include "CoAPResources.h"
 
-Node::Node(const String &key) : key(key), value(nullptr) {}
+Node::Node() :
+        hash(0),
+        id(0),
+        value(nullptr),
+        parent(nullptr),
+        first_child(nullptr),
+        last_child(nullptr),
+        next_sibling(nullptr),
+        handler(nullptr),
+        observers(nullptr) {}
 
 const String &Node::getKey() const {
     return key;
@@ -10,22 +19,66 @@ unsigned short *Node::getValue() const {
     return value;
 }
 
+/** Returns resource type (rt attribute in link format), empty if it was not given **/
+const String &Node::getType() const {
+    return type;
+}
+
+Node *Node::getParent() const {
+    return parent;
+}
+
+/** Returns the first child inserted into node, nullptr if node is a leaf **/
+Node *Node::getFirstChild() const {
+    return first_child;
+}
+
+/** Returns child of the same parent inserted after this one **/
+Node *Node::getNextSibling() const {
+    return next_sibling;
+}
+
 void Node::setValue(unsigned short *value) {
     Node::value = value;
 }
 
-Array<Node *> &Node::getNodes() {
-    return nodes;
+/** Returns handler serving requests to resource, nullptr if there is none **/
+CoAPResourceHandler *Node::getHandler() const {
+    return handler;
+}
+
+/** Sets handler serving requests to resource, node does not take ownership of it **/
+void Node::setHandler(CoAPResourceHandler *handler) {
+    Node::handler = handler;
+}
+
+/** Returns observers of resource, nullptr if nobody has ever observed it **/
+CoAPObservers *Node::getObservers() const {
+    return observers;
+}
+
+/** Registers observer of resource, list of observers is created with first registration **/
+void Node::addObserver(const CoAPEndpoint &endpoint, const TokenArray &token) {
+    if (observers == nullptr)
+        observers = new CoAPObservers(OBSERVERS_CAPACITY);
+
+    observers->add(endpoint, token);
 }
 
 Node::~Node() {
-    if (value != nullptr);
-        delete value;
+    delete value;
+    delete observers;
 }
 
 /** Creates resource tree and adds three main branches: well-known, local and remote**/
-CoAPResources::CoAPResources() {
-    root = new Node(".");
+CoAPResources::CoAPResources() : size_(0), index_capacity_(16) {
+    index_ = new Node*[index_capacity_];
+    for (unsigned int i = 0; i < index_capacity_; ++i) {
+        index_[i] = nullptr;
+    }
+
+    root = allocate();
+    root->key = ".";
 
     Array<String> coreResource;
     coreResource.pushBack(RESOURCE_WELL_KNOWN);
@@ -43,131 +96,166 @@ CoAPResources::CoAPResources() {
 }
 
 CoAPResources::~CoAPResources() {
-    destroy();
+    for (unsigned int i = 0; i < chunks_.size(); ++i) {
+        delete[] chunks_[i];
+    }
+    delete[] index_;
 }
 
-void CoAPResources::destroy() {
-    destroy(root);
+/** Takes next free node from the last chunk, allocating new chunk if it is full **/
+Node *CoAPResources::allocate() {
+    if (size_ % RESOURCE_NODES_PER_CHUNK == 0)
+        chunks_.pushBack(new Node[RESOURCE_NODES_PER_CHUNK]);
+
+    Node *node = &chunks_[chunks_.size() - 1][size_ % RESOURCE_NODES_PER_CHUNK];
+    node->id = size_++;
+    return node;
 }
 
-void CoAPResources::destroy(Node *leaf) {
-    if(leaf != nullptr) {
-        for (int i = 0; i < leaf->getNodes().size(); ++i) {
-            destroy(leaf->getNodes()[i]);
-        }
-        delete leaf;
+/** Returns FNV-1a hash of given key **/
+unsigned long CoAPResources::hashOf(const ByteView &key) {
+    unsigned long hash = 2166136261UL;
+    for (unsigned int i = 0; i < key.size(); ++i) {
+        hash = (hash ^ key[i]) * 16777619UL;
     }
+    return hash;
 }
 
-/** Inserts path to resource and value at final leaf of resource into resource tree  **/
-void CoAPResources::insert(String *begin, const String *end, Node *leaf, unsigned short *value) {
-    Node* node = nullptr;
-    for (int i = 0; i < leaf->getNodes().size(); ++i) {
-        if (leaf->getNodes()[i]->getKey() == *begin) {
-            node = leaf->getNodes()[i];
-            break;
-        }
-    }
+ByteView CoAPResources::toByteView(const String &key) {
+    return ByteView((const unsigned char *) key.c_str(), key.length());
+}
 
-    if (node == nullptr) {
-        node = new Node(*begin);
-        leaf->getNodes().pushBack(node);
+/** Returns index slot at which search for child of given parent starts **/
+unsigned int CoAPResources::home(const Node *parent, unsigned long hash) const {
+    return (unsigned int) ((hash ^ (parent->id * 40503UL)) & (index_capacity_ - 1));
+}
 
-        DEBUG_PRINT("Created node: ");
-        DEBUG_PRINTLN(node->getKey());
+/** Puts node into the first free slot following its home slot **/
+void CoAPResources::index(Node *node) {
+    unsigned int slot = home(node->parent, node->hash);
+    while (index_[slot] != nullptr) {
+        slot = (slot + 1) & (index_capacity_ - 1);
     }
+    index_[slot] = node;
+}
 
-    if (begin + 1 != end) {
-        DEBUG_PRINT("Moving into: ");
-        DEBUG_PRINTLN(node->getKey());
-        insert(++begin, end, node, value);
+/** Doubles the index and puts all nodes except root into it again **/
+void CoAPResources::grow() {
+    delete[] index_;
+    index_capacity_ *= 2;
+    index_ = new Node*[index_capacity_];
+    for (unsigned int i = 0; i < index_capacity_; ++i) {
+        index_[i] = nullptr;
+    }
+
+    for (unsigned int i = 1; i < size_; ++i) {
+        index(&chunks_[i / RESOURCE_NODES_PER_CHUNK][i % RESOURCE_NODES_PER_CHUNK]);
     }
-    else
-        node->setValue(value);
 }
 
-/** Searches for resource with path given using String array iterators **/
-Node *CoAPResources::search(String *begin, const String *end, Node *leaf) {
-    Node* node = nullptr;
+/** Returns child of given node with given key, creating it if there is none **/
+Node *CoAPResources::insert(Node *parent, const ByteView &key) {
+    Node *node = findChild(parent, key);
+    if (node != nullptr)
+        return node;
+
+    // Index is kept at most half full, so probe sequences stay short
+    if ((size_ + 1) * 2 > index_capacity_)
+        grow();
+
+    node = allocate();
+    node->key = CoAPOption::toString(key.begin(), key.size());
+    node->hash = hashOf(key);
+    node->parent = parent;
+    if (parent->last_child != nullptr)
+        parent->last_child->next_sibling = node;
+    else
+        parent->first_child = node;
+    parent->last_child = node;
+    index(node);
+
+    DEBUG_PRINT("Created node: ");
+    DEBUG_PRINTLN(node->getKey());
 
-    DEBUG_PRINT("Looking for: ");
-    DEBUG_PRINTLN(*begin);
+    return node;
+}
 
-    if(leaf != nullptr) {
-        for (int i = 0; i < leaf->getNodes().size(); ++i) {
-            DEBUG_PRINT("Is ");
-            DEBUG_PRINT(leaf->getNodes()[i]->getKey());
-            DEBUG_PRINT(" a match? ");
+/** Inserts path to resource and value at final leaf of resource into resource tree, returns that leaf **/
+Node *CoAPResources::insert(const Array<String> &keys, unsigned short *value, const String &type) {
+    Node *node = root;
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+        node = insert(node, toByteView(keys[i]));
+    }
+    node->setValue(value);
+    node->type = type;
+    links_.invalidate();
+    return node;
+}
 
-            if (leaf->getNodes()[i]->getKey() == *begin) {
-                DEBUG_PRINTLN("Yes!");
-                node = leaf->getNodes()[i];
-                break;
-            }
+/** Searches for resource with path given using String array **/
+Node *CoAPResources::search(const Array<String> &keys) const {
+    Node *node = root;
+    for (unsigned int i = 0; i < keys.size() && node != nullptr; ++i) {
+        node = findChild(node, toByteView(keys[i]));
+    }
+    return node;
+}
 
-            DEBUG_PRINTLN("No!");
-        }
+/** Returns root of the tree, its children are the main branches **/
+Node *CoAPResources::getRoot() const {
+    return root;
+}
 
+/** Returns child of given node with given key or nullptr if there is none **/
+Node *CoAPResources::findChild(const Node *parent, const ByteView &key) const {
+    unsigned long hash = hashOf(key);
 
-        if (node != nullptr) {
-            DEBUG_PRINT("Found node: ");
-            DEBUG_PRINTLN(node->getKey());
-        }
-    }
-    else {
-        DEBUG_PRINT("Not found: ");
-        DEBUG_PRINTLN(*begin);
+    for (unsigned int slot = home(parent, hash); index_[slot] != nullptr; slot = (slot + 1) & (index_capacity_ - 1)) {
+        Node *node = index_[slot];
 
-        return nullptr;
+        if (node->parent == parent && node->hash == hash && toByteView(node->key) == key)
+            return node;
     }
 
-    if (begin + 1 != end) {
-        return search(++begin, end, node);
-    }
-    else return node;
+    return nullptr;
 }
 
-/** Inserts path to resource and value at final leaf of resource into resource tree  **/
-void CoAPResources::insert(const Array<String> &keys, unsigned short *value) {
-    insert(keys.begin(), keys.end(), root, value);
+/** Returns number of nodes in the tree, including root **/
+unsigned int CoAPResources::size() const {
+    return size_;
 }
 
-/** Searches for resource with path given using String array **/
-Node *CoAPResources::search(const Array<String> &keys) {
-    return search(keys.begin(), keys.end(), root);
+/** Returns link format document describing leaves of the tree (except well-known ones).
+ *  Document is built only if tree has changed since last call. **/
+const CoAPLinkFormat &CoAPResources::getLinkFormat() const {
+    if (!links_.isValid()) {
+        links_.clear();
+        for (Node *node = root->first_child; node != nullptr; node = node->next_sibling) {
+            if (node->key != RESOURCE_WELL_KNOWN)
+                addLinks(links_, node, String("/") + node->key);
+        }
+    }
+    return links_;
 }
 
 /** Converts resource tree into string in Link Format **/
 String CoAPResources::toLinkFormat() const {
-    String core_format;
-
-    core_format += "<";
-    for (int i = 1; i < root->getNodes().size(); ++i) {
-        getUriPaths(core_format, root->getNodes()[i]);
-    }
-
-    return core_format.substr(0, core_format.length() - 2);
+    ByteView document = getLinkFormat().getDocument();
+    return CoAPOption::toString(document.begin(), document.size());
 }
 
-/** Writes Uri paths of given Node into given string **/
-void CoAPResources::getUriPaths(String &result, Node *child) const {
-    Node* node = nullptr;
-
-    for (int i = 0; i < child->getNodes().size(); ++i) {
-        result += "/";
-        result += child->getKey();
-        node = child->getNodes()[i];
-        getUriPaths(result, node);
+/** Adds links to given node or to all leaves below it **/
+void CoAPResources::addLinks(CoAPLinkFormat &links, const Node *node, const String &path) const {
+    if (node->first_child == nullptr) {
+        links.addLink(path);
+        if (node->type.length() > 0)
+            links.addAttribute("rt", node->type, true);
+        if (node->value != nullptr)
+            links.addAttribute("value", TO_STRING(*node->value), false);
+        return;
     }
 
-    if (node == nullptr) {
-        result += "/";
-        result += child->getKey();
-        result += ">";
-        if (child->getValue() != nullptr) {
-            result += ";value=";
-            result += TO_STRING(*child->getValue());
-        }
-        result += ",<";
+    for (Node *child = node->first_child; child != nullptr; child = child->next_sibling) {
+        addLinks(links, child, path + String("/") + child->key);
     }
 }
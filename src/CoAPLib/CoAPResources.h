@@ -2,48 +2,91 @@
 #define COAPLIB_COAPRESOURCES_H
 
 #include "Array.hpp"
+#include "ArrayView.hpp"
 #include "CoAPConstants.h"
+#include "CoAPLinkFormat.h"
+#include "CoAPObservers.h"
+#include "CoAPResourceHandler.h"
 #include "../Environment.h"
 
 /**
- * Represents single node in resource tree
+ * Represents single node in resource tree. Children are linked in order of insertion,
+ * lookup by key goes through hash index of the tree. Requests to node are served by its handler,
+ * or forwarded through radio if node has value (number of radio resource).
  */
 class Node {
 private:
     String key;
+    unsigned long hash;
+    unsigned int id;
     unsigned short* value;
-    Array<Node*> nodes;
+    String type;
+    Node* parent;
+    Node* first_child;
+    Node* last_child;
+    Node* next_sibling;
+    CoAPResourceHandler* handler;
+    CoAPObservers* observers;
 
+    friend class CoAPResources;
 public:
-    Node(const String &key);
+    Node();
     ~Node();
 
     const String &getKey() const;
     unsigned short *getValue() const;
-    Array<Node *> &getNodes();
+    const String &getType() const;
+    Node *getParent() const;
+    Node *getFirstChild() const;
+    Node *getNextSibling() const;
+    CoAPResourceHandler *getHandler() const;
+    CoAPObservers *getObservers() const;
 
     void setValue(unsigned short *value);
+    void setHandler(CoAPResourceHandler *handler);
+    void addObserver(const CoAPEndpoint &endpoint, const TokenArray &token);
 };
 
 /**
- * Resource tree used to describe resources available from server
+ * Resource tree used to describe resources available from server.
+ * Nodes are allocated in chunks and never move, so pointers to them stay valid for lifetime of the tree.
+ * Child of a node is found through open-addressing index hashed by parent and key,
+ * so lookup cost does not grow with number of siblings.
  */
 class CoAPResources {
 private:
     Node *root;
+    Array<Node*> chunks_;
+    unsigned int size_;
+    Node** index_;
+    unsigned int index_capacity_;
 
-    void destroy();
-    void destroy(Node *leaf);
-    void insert(String *begin, const String *end, Node *leaf, unsigned short *value);
-    Node *search(String *begin, const String *end, Node *leaf);
-    void getUriPaths(String &result, Node *child) const;
+    Node *allocate();
+    unsigned int home(const Node *parent, unsigned long hash) const;
+    void index(Node *node);
+    void grow();
+    Node *insert(Node *parent, const ByteView &key);
+    mutable CoAPLinkFormat links_;
+
+    void addLinks(CoAPLinkFormat &links, const Node *node, const String &path) const;
+
+    static unsigned long hashOf(const ByteView &key);
+    static ByteView toByteView(const String &key);
+
+    CoAPResources(const CoAPResources &resources);
+    CoAPResources &operator=(const CoAPResources &resources);
 public:
     CoAPResources();
     ~CoAPResources();
 
-    void insert(const Array<String> &keys, unsigned short *value);
-    Node *search(const Array<String> &keys);
+    Node *insert(const Array<String> &keys, unsigned short *value, const String &type = String());
+    Node *search(const Array<String> &keys) const;
+    Node *getRoot() const;
+    Node *findChild(const Node *parent, const ByteView &key) const;
+
+    unsigned int size() const;
 
+    const CoAPLinkFormat &getLinkFormat() const;
     String toLinkFormat() const;
 };
 
@@ -0,0 +1,89 @@
+#include "CoAPResponseCache.h"
+
+/** Creates cache able to keep values of given number of resources for max_age seconds **/
+CoAPResponseCache::CoAPResponseCache(const CoAPClock &clock, unsigned int capacity, unsigned long max_age) :
+        clock_(&clock),
+        capacity_(capacity),
+        size_(0),
+        max_age_(max_age) {
+    values_ = new CachedValue[capacity_];
+}
+
+CoAPResponseCache::~CoAPResponseCache() {
+    delete[] values_;
+}
+
+/** Returns position of value of given resource, -1 if it is not cached **/
+int CoAPResponseCache::locate(unsigned short resource) const {
+    for (unsigned int i = 0; i < size_; ++i) {
+        if (values_[i].resource == resource)
+            return (int) i;
+    }
+    return -1;
+}
+
+/** Returns fresh value of given resource along with number of seconds it will stay fresh,
+ *  false if value is not cached or is stale **/
+bool CoAPResponseCache::find(unsigned short resource, unsigned long &value, unsigned long &max_age) const {
+    int position = locate(resource);
+    if (position < 0)
+        return false;
+
+    unsigned long age = clock_->now() - values_[position].timestamp;
+    if (age >= max_age_ * 1000)
+        return false;
+
+    value = values_[position].value;
+    max_age = (max_age_ * 1000 - age) / 1000;
+    return true;
+}
+
+/** Puts value of given resource into cache, replacing the oldest value if cache is full **/
+void CoAPResponseCache::store(unsigned short resource, unsigned long value) {
+    if (max_age_ == 0 || capacity_ == 0)
+        return;
+
+    unsigned long now = clock_->now();
+    int position = locate(resource);
+
+    if (position < 0 && size_ < capacity_) {
+        position = size_++;
+    }
+    else if (position < 0) {
+        position = 0;
+        for (unsigned int i = 1; i < size_; ++i) {
+            if (now - values_[i].timestamp > now - values_[position].timestamp)
+                position = i;
+        }
+    }
+
+    values_[position].resource = resource;
+    values_[position].value = value;
+    values_[position].timestamp = now;
+}
+
+/** Removes value of given resource, eg. when it was changed by PUT request **/
+void CoAPResponseCache::invalidate(unsigned short resource) {
+    int position = locate(resource);
+    if (position < 0)
+        return;
+
+    values_[position] = values_[--size_];
+}
+
+/** Returns number of seconds values stay fresh **/
+unsigned long CoAPResponseCache::getMaxAge() const {
+    return max_age_;
+}
+
+/** Sets number of seconds values stay fresh, 0 disables caching **/
+void CoAPResponseCache::setMaxAge(unsigned long max_age) {
+    max_age_ = max_age;
+    if (max_age_ == 0)
+        size_ = 0;
+}
+
+/** Returns number of cached values **/
+unsigned int CoAPResponseCache::size() const {
+    return size_;
+}
@@ -0,0 +1,47 @@
+#ifndef COAPLIB_COAPRESPONSECACHE_H
+#define COAPLIB_COAPRESPONSECACHE_H
+
+#include "CoAPClock.h"
+#include "CoAPConstants.h"
+#include "../Environment.h"
+
+/**
+ * Value of remote resource received through radio
+ */
+struct CachedValue {
+    unsigned short resource;
+    unsigned long value;
+    unsigned long timestamp;
+};
+
+/**
+ * Keeps last value of each remote resource for Max-Age seconds, so GET requests can be answered
+ * without radio round-trip. When cache is full the oldest value is replaced.
+ * Max-Age equal to 0 disables caching.
+ */
+class CoAPResponseCache {
+private:
+    const CoAPClock* clock_;
+    CachedValue* values_;
+    unsigned int capacity_;
+    unsigned int size_;
+    unsigned long max_age_;
+
+    int locate(unsigned short resource) const;
+
+    CoAPResponseCache(const CoAPResponseCache &cache);
+    CoAPResponseCache &operator=(const CoAPResponseCache &cache);
+public:
+    CoAPResponseCache(const CoAPClock &clock, unsigned int capacity, unsigned long max_age = DEFAULT_MAX_AGE);
+    ~CoAPResponseCache();
+
+    bool find(unsigned short resource, unsigned long &value, unsigned long &max_age) const;
+    void store(unsigned short resource, unsigned long value);
+    void invalidate(unsigned short resource);
+
+    unsigned long getMaxAge() const;
+    void setMaxAge(unsigned long max_age);
+    unsigned int size() const;
+};
+
+#endif //COAPLIB_COAPRESPONSECACHE_H
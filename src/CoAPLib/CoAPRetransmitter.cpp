@@ -0,0 +1,136 @@
+#include "CoAPRetransmitter.h"
+
+/** Creates retransmitter able to track given number of messages, seed initializes randomization of timeouts.
+ *  With seed 0 randomization is seeded on first use, see initialTimeout. **/
+CoAPRetransmitter::CoAPRetransmitter(const CoAPClock &clock, unsigned int capacity, unsigned long seed) :
+        clock_(&clock),
+        capacity_(capacity),
+        size_(0),
+        random_state_(seed),
+        timers_(capacity) {
+    transmissions_ = new CoAPTransmission[capacity_];
+    used_ = new bool[capacity_];
+    free_handles_ = new unsigned short[capacity_];
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        used_[i] = false;
+        free_handles_[i] = (unsigned short) (capacity_ - 1 - i);
+    }
+}
+
+CoAPRetransmitter::~CoAPRetransmitter() {
+    delete[] transmissions_;
+    delete[] used_;
+    delete[] free_handles_;
+}
+
+/** Returns random timeout between ACK_TIMEOUT and ACK_TIMEOUT * ACK_RANDOM_FACTOR for message sent to given endpoint.
+ *  Generator which was not seeded is seeded with time of the first confirmable message and its receiver, not at
+ *  construction, which on AVR happens during static initialization, when every gateway reads the same time. **/
+unsigned long CoAPRetransmitter::initialTimeout(const CoAPEndpoint &endpoint) {
+    if (random_state_ == 0) {
+        random_state_ = (clock_->now() ^ (endpoint.address * 2654435761UL) ^ ((unsigned long) endpoint.port << 16))
+                        & 0xFFFFFFFFUL;
+        if (random_state_ == 0)
+            random_state_ = 1;
+    }
+
+    // xorshift generator, good enough to spread retransmissions of many clients in time
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= (random_state_ & 0xFFFFFFFFUL) >> 17;
+    random_state_ ^= random_state_ << 5;
+    random_state_ &= 0xFFFFFFFFUL;
+
+    const unsigned long spread = (unsigned long) ACK_TIMEOUT * (ACK_RANDOM_FACTOR_PERCENT - 100) / 100;
+    return ACK_TIMEOUT + random_state_ % (spread + 1);
+}
+
+/** Tells if another confirmable message can be sent to given endpoint without exceeding NSTART **/
+bool CoAPRetransmitter::canSend(const CoAPEndpoint &endpoint) const {
+    if (size_ == capacity_)
+        return false;
+
+    unsigned int in_flight = 0;
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        if (used_[i] && transmissions_[i].endpoint == endpoint && ++in_flight >= NSTART)
+            return false;
+    }
+    return true;
+}
+
+/** Starts tracking message which has just been sent for the first time.
+ *  Returns its handle or NO_TRANSMISSION if it can not be sent now **/
+int CoAPRetransmitter::track(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+    if (!canSend(endpoint))
+        return NO_TRANSMISSION;
+
+    unsigned short handle = free_handles_[capacity_ - 1 - size_];
+    CoAPTransmission &transmission = transmissions_[handle];
+    transmission.message = message;
+    transmission.endpoint = endpoint;
+    transmission.first_sent = clock_->now();
+    transmission.timeout = initialTimeout(endpoint);
+    transmission.retransmissions = 0;
+    used_[handle] = true;
+    ++size_;
+
+    timers_.schedule(handle, transmission.first_sent + transmission.timeout);
+    return handle;
+}
+
+/** Returns handle of message with given ID sent to given endpoint, NO_TRANSMISSION if there is none **/
+int CoAPRetransmitter::find(unsigned short message_id, const CoAPEndpoint &endpoint) const {
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        if (used_[i] && transmissions_[i].message.getMessageId() == message_id
+            && transmissions_[i].endpoint == endpoint)
+            return (int) i;
+    }
+    return NO_TRANSMISSION;
+}
+
+/** Returns message with given handle or nullptr if handle is not in use **/
+const CoAPTransmission *CoAPRetransmitter::at(int handle) const {
+    if (handle < 0 || (unsigned int) handle >= capacity_ || !used_[handle])
+        return nullptr;
+
+    return &transmissions_[handle];
+}
+
+/** Stops tracking message, eg. when it was acknowledged or given up **/
+void CoAPRetransmitter::release(int handle) {
+    if (at(handle) == nullptr)
+        return;
+
+    timers_.cancel(handle);
+    transmissions_[handle].message = CoAPMessage();
+    used_[handle] = false;
+    --size_;
+    free_handles_[capacity_ - 1 - size_] = (unsigned short) handle;
+}
+
+/** Returns message whose timeout has expired. If it has retransmissions left, retransmit is set,
+ *  message is scheduled again with doubled timeout and should be sent once more.
+ *  Otherwise message is given up and should be released. **/
+bool CoAPRetransmitter::popDue(int &handle, bool &retransmit) {
+    unsigned long now = clock_->now();
+    if (!timers_.popExpired(now, handle))
+        return false;
+
+    CoAPTransmission &transmission = transmissions_[handle];
+    retransmit = transmission.retransmissions < MAX_RETRANSMIT;
+    if (retransmit) {
+        ++transmission.retransmissions;
+        transmission.timeout *= 2;
+        timers_.schedule(handle, now + transmission.timeout);
+    }
+    return true;
+}
+
+/** Returns time of the next retransmission or give up, false if no message is waiting **/
+bool CoAPRetransmitter::nextDeadline(unsigned long &deadline) const {
+    return timers_.nextDeadline(deadline);
+}
+
+/** Returns number of messages waiting for acknowledgement **/
+unsigned int CoAPRetransmitter::size() const {
+    return size_;
+}
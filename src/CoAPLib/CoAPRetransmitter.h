@@ -0,0 +1,60 @@
+#ifndef COAPLIB_COAPRETRANSMITTER_H
+#define COAPLIB_COAPRETRANSMITTER_H
+
+#include "CoAPClock.h"
+#include "CoAPEndpoint.h"
+#include "CoAPMessage.h"
+#include "CoAPTimers.h"
+#include "../Environment.h"
+
+#define NO_TRANSMISSION -1
+
+/**
+ * Confirmable message waiting for acknowledgement
+ */
+struct CoAPTransmission {
+    CoAPMessage message;
+    CoAPEndpoint endpoint;
+    unsigned long first_sent;
+    unsigned long timeout;
+    unsigned char retransmissions;
+};
+
+/**
+ * Keeps confirmable messages until they are acknowledged and tells when they have to be sent again
+ * (RFC 7252, section 4.2). First timeout is randomly chosen between ACK_TIMEOUT and
+ * ACK_TIMEOUT * ACK_RANDOM_FACTOR and it doubles after every retransmission. After MAX_RETRANSMIT
+ * retransmissions message is given up. No more than NSTART messages can wait for one endpoint.
+ */
+class CoAPRetransmitter {
+private:
+    const CoAPClock* clock_;
+    CoAPTransmission* transmissions_;
+    bool* used_;
+    unsigned short* free_handles_;
+    unsigned int capacity_;
+    unsigned int size_;
+    unsigned long random_state_;
+    CoAPTimers timers_;
+
+    unsigned long initialTimeout(const CoAPEndpoint &endpoint);
+
+    CoAPRetransmitter(const CoAPRetransmitter &retransmitter);
+    CoAPRetransmitter &operator=(const CoAPRetransmitter &retransmitter);
+public:
+    CoAPRetransmitter(const CoAPClock &clock, unsigned int capacity, unsigned long seed = 0);
+    ~CoAPRetransmitter();
+
+    bool canSend(const CoAPEndpoint &endpoint) const;
+    int track(const CoAPMessage &message, const CoAPEndpoint &endpoint);
+    int find(unsigned short message_id, const CoAPEndpoint &endpoint) const;
+    const CoAPTransmission *at(int handle) const;
+    void release(int handle);
+
+    bool popDue(int &handle, bool &retransmit);
+    bool nextDeadline(unsigned long &deadline) const;
+
+    unsigned int size() const;
+};
+
+#endif //COAPLIB_COAPRETRANSMITTER_H
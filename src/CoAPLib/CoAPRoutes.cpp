@@ -0,0 +1,57 @@
+#include "CoAPRoutes.h"
+
+const StaticRoute CoAPRoutes::routes_[ROUTES_COUNT] = {
+        {RESOURCE_WELL_KNOWN, RESOURCE_CORE, nullptr, NO_RADIO_RESOURCE},
+        {RESOURCE_LOCAL, RESOURCE_RTT, RESOURCE_TYPE_METRIC, NO_RADIO_RESOURCE},
+        {RESOURCE_LOCAL, RESOURCE_JITTER, RESOURCE_TYPE_METRIC, NO_RADIO_RESOURCE},
+        {RESOURCE_LOCAL, RESOURCE_TIMED_OUT, RESOURCE_TYPE_METRIC, NO_RADIO_RESOURCE},
+        {RESOURCE_REMOTE, RESOURCE_LAMP, RESOURCE_TYPE_RADIO, RADIO_LAMP},
+        {RESOURCE_REMOTE, RESOURCE_SPEAKER, RESOURCE_TYPE_RADIO, RADIO_SPEAKER}
+};
+
+/** Continues hash of path with given segment **/
+unsigned long CoAPRoutes::hash(const ByteView &segment, unsigned long value) {
+    for (unsigned int i = 0; i < segment.size(); ++i) {
+        value = (value ^ segment[i]) * 16777619UL;
+    }
+    return value;
+}
+
+/** Returns built-in route with path made of given two segments, NO_ROUTE if there is none **/
+StaticRouteId CoAPRoutes::find(const ByteView &branch, const ByteView &key) {
+    StaticRouteId route;
+
+    switch (hash(key, (hash(branch, hash("")) ^ '/') * 16777619UL)) {
+        case hash(RESOURCE_WELL_KNOWN "/" RESOURCE_CORE):
+            route = ROUTE_CORE;
+            break;
+        case hash(RESOURCE_LOCAL "/" RESOURCE_RTT):
+            route = ROUTE_RTT;
+            break;
+        case hash(RESOURCE_LOCAL "/" RESOURCE_JITTER):
+            route = ROUTE_JITTER;
+            break;
+        case hash(RESOURCE_LOCAL "/" RESOURCE_TIMED_OUT):
+            route = ROUTE_TIMED_OUT;
+            break;
+        case hash(RESOURCE_REMOTE "/" RESOURCE_LAMP):
+            route = ROUTE_LAMP;
+            break;
+        case hash(RESOURCE_REMOTE "/" RESOURCE_SPEAKER):
+            route = ROUTE_SPEAKER;
+            break;
+        default:
+            return NO_ROUTE;
+    }
+
+    // Different path can have the same hash, so matched route is compared with it
+    if (branch == routes_[route].branch && key == routes_[route].key)
+        return route;
+
+    return NO_ROUTE;
+}
+
+/** Returns path and radio mapping of given built-in route **/
+const StaticRoute &CoAPRoutes::at(StaticRouteId route) {
+    return routes_[route];
+}
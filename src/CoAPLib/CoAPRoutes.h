@@ -0,0 +1,55 @@
+#ifndef COAPLIB_COAPROUTES_H
+#define COAPLIB_COAPROUTES_H
+
+#include "ArrayView.hpp"
+#include "CoAPConstants.h"
+#include "../Environment.h"
+#include "../RadioLib/RadioConstants.h"
+
+#define NO_RADIO_RESOURCE -1
+
+/**
+ * Built-in resources, known at compile time
+ */
+enum StaticRouteId {
+    ROUTE_CORE,
+    ROUTE_RTT,
+    ROUTE_JITTER,
+    ROUTE_TIMED_OUT,
+    ROUTE_LAMP,
+    ROUTE_SPEAKER,
+    ROUTES_COUNT,
+    NO_ROUTE = ROUTES_COUNT
+};
+
+/**
+ * Path and type of built-in resource and number of radio resource it is mapped to (NO_RADIO_RESOURCE for local ones)
+ */
+struct StaticRoute {
+    const char* branch;
+    const char* key;
+    const char* type;
+    short radio_resource;
+};
+
+/**
+ * Compile-time route table of built-in resources. Path is matched by switch on its hash, which is computed
+ * for every route by compiler (two routes with the same hash would not compile), so lookup needs
+ * neither heap nor resource tree.
+ */
+class CoAPRoutes {
+private:
+    static const StaticRoute routes_[ROUTES_COUNT];
+
+    static unsigned long hash(const ByteView &segment, unsigned long value);
+public:
+    /** Returns FNV-1a hash of given path, segments are separated with '/' **/
+    static constexpr unsigned long hash(const char *path, unsigned long value = 2166136261UL) {
+        return *path == '\0' ? value : hash(path + 1, (value ^ (unsigned char) *path) * 16777619UL);
+    }
+
+    static StaticRouteId find(const ByteView &branch, const ByteView &key);
+    static const StaticRoute &at(StaticRouteId route);
+};
+
+#endif //COAPLIB_COAPROUTES_H
@@ -0,0 +1,143 @@
+#include "CoAPShardedServer.h"
+
+#if defined(__linux__)
+
+/** Returns number of bits needed to tell given number of shards apart **/
+static constexpr unsigned int shardBits(unsigned int shards, unsigned int bits = 0) {
+    return (1u << bits) >= shards ? bits : shardBits(shards, bits + 1);
+}
+
+// Radio IDs left to every shard have to outnumber its pending requests, otherwise free ID could not be found
+static_assert((0x10000UL >> shardBits(SHARDS_MAX_COUNT)) > PENDING_MESSAGES_CAPACITY,
+              "SHARDS_MAX_COUNT leaves too few radio IDs for PENDING_MESSAGES_CAPACITY pending requests");
+
+CoAPShardedServer::Shard::Shard(RadioMessageListener &radioMessageListener) :
+        server(),
+        handler(server, radioMessageListener) {
+    server.setHandler(handler);
+}
+
+/** Creates given number of shards (at least one and at most SHARDS_MAX_COUNT),
+ *  sockets are opened and threads started by start **/
+CoAPShardedServer::CoAPShardedServer(unsigned int shards, RadioMessageListener &radioMessageListener) :
+        size_(shards == 0 ? 1 : shards > SHARDS_MAX_COUNT ? SHARDS_MAX_COUNT : shards),
+        shard_bits_((unsigned char) shardBits(size_)),
+        running_(false) {
+    shards_ = new Shard*[size_];
+    for (unsigned int i = 0; i < size_; ++i) {
+        shards_[i] = new Shard(radioMessageListener);
+        shards_[i]->handler.setRadioIdPrefix((unsigned short) i, shard_bits_);
+    }
+}
+
+CoAPShardedServer::~CoAPShardedServer() {
+    stop();
+
+    for (unsigned int i = 0; i < size_; ++i) {
+        delete shards_[i];
+    }
+    delete[] shards_;
+}
+
+/** Binds sockets of all shards to given port (0 picks any free one) and address (in network byte order)
+ *  and starts worker threads. Returns false if any socket could not be opened, sockets already bound are closed then. **/
+bool CoAPShardedServer::start(unsigned short port, unsigned long address) {
+    stop();
+
+    for (unsigned int i = 0; i < size_; ++i) {
+        if (!shards_[i]->server.bind(port, address, true)) {
+            for (unsigned int j = 0; j < i; ++j) {
+                shards_[j]->server.close();
+            }
+            return false;
+        }
+
+        // Shards have to share port picked for the first of them
+        port = shards_[i]->server.getPort();
+    }
+
+    __atomic_store_n(&running_, true, __ATOMIC_RELEASE);
+    for (unsigned int i = 0; i < size_; ++i) {
+        shards_[i]->thread = std::thread(&CoAPShardedServer::serve, this, std::ref(*shards_[i]));
+    }
+    return true;
+}
+
+/** Stops worker threads and waits until they finish **/
+void CoAPShardedServer::stop() {
+    __atomic_store_n(&running_, false, __ATOMIC_RELEASE);
+
+    for (unsigned int i = 0; i < size_; ++i) {
+        if (shards_[i]->thread.joinable())
+            shards_[i]->thread.join();
+    }
+}
+
+/** Main loop of worker thread. Waiting for datagrams is done without lock,
+ *  so radio replies can be handled by the shard in the meantime. **/
+void CoAPShardedServer::serve(Shard &shard) {
+    while (__atomic_load_n(&running_, __ATOMIC_ACQUIRE)) {
+        int timeout;
+        {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            timeout = shard.server.getTimeout(UDP_MAX_WAIT);
+        }
+
+        if (shard.server.wait(timeout) < 0)
+            return;
+
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.server.poll(0);
+        shard.server.serviceTimers();
+    }
+}
+
+/** Returns port to which shards are bound, 0 if they are not **/
+unsigned short CoAPShardedServer::getPort() const {
+    return shards_[0]->server.getPort();
+}
+
+/** Returns number of shards **/
+unsigned int CoAPShardedServer::size() const {
+    return size_;
+}
+
+/** Passes radio reply to shard which waits for it, index of the shard is in the highest bits of radio ID **/
+void CoAPShardedServer::handleMessage(RadioMessage &radioMessage) {
+    unsigned int shard = shard_bits_ == 0 ? 0 : (unsigned int) (radioMessage.message_id >> (16 - shard_bits_));
+    if (shard >= size_)
+        return;
+
+    std::lock_guard<std::mutex> guard(shards_[shard]->lock);
+    shards_[shard]->handler.handleMessage(radioMessage);
+    shards_[shard]->server.flush();
+}
+
+/** Registers remote resource in every shard. Server takes ownership of given value,
+ *  every shard gets its own copy of it, so shards never share or delete the same value. **/
+void CoAPShardedServer::registerResource(const Array<String> &uri_path, unsigned short *value, const String &type) {
+    for (unsigned int i = 0; i < size_; ++i) {
+        std::lock_guard<std::mutex> guard(shards_[i]->lock);
+        shards_[i]->handler.registerResource(uri_path, value != nullptr ? new unsigned short(*value) : nullptr, type);
+    }
+    delete value;
+}
+
+/** Registers resource served by given handler in every shard **/
+void CoAPShardedServer::registerResource(const Array<String> &uri_path, CoAPResourceHandler &handler,
+                                         const String &type) {
+    for (unsigned int i = 0; i < size_; ++i) {
+        std::lock_guard<std::mutex> guard(shards_[i]->lock);
+        shards_[i]->handler.registerResource(uri_path, handler, type);
+    }
+}
+
+/** Sets max age of cached remote values in every shard **/
+void CoAPShardedServer::setMaxAge(unsigned long seconds) {
+    for (unsigned int i = 0; i < size_; ++i) {
+        std::lock_guard<std::mutex> guard(shards_[i]->lock);
+        shards_[i]->handler.setMaxAge(seconds);
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef COAPLIB_COAPSHARDEDSERVER_H
+#define COAPLIB_COAPSHARDEDSERVER_H
+
+#if defined(__linux__)
+
+#include <mutex>
+#include <thread>
+
+#include "CoAPHandler.h"
+#include "CoAPUdpServer.h"
+#include "../Environment.h"
+#include "../RadioLib.h"
+
+// Max number of shards, index of shard is kept in the highest bits of radio IDs it assigns,
+// so there have to be enough bits left for PENDING_MESSAGES_CAPACITY requests of every shard:
+#ifndef SHARDS_MAX_COUNT
+    #define SHARDS_MAX_COUNT 32
+#endif
+
+/**
+ * Runs CoAPHandler on several cores. Every shard is a worker thread owning its own handler and UDP socket,
+ * all sockets are bound to the same port with SO_REUSEPORT, so kernel hashes every client address to one
+ * of them. Client always talks to the same shard, so its pending requests, observations and deduplication
+ * state never have to be shared. Metrics (RTT, jitter, timeouts) are kept per shard.
+ * Every shard puts its index into the highest bits of radio IDs, so radio reply goes straight to its shard.
+ *
+ * Registered resources are copied into every shard, each copy is changed only under lock of its shard.
+ * Resource handlers are shared, so they have to be thread-safe, the same applies to radio listener,
+ * which is called from worker threads.
+ */
+class CoAPShardedServer {
+private:
+    struct Shard {
+        CoAPUdpServer server;
+        CoAPHandler handler;
+        std::mutex lock;
+        std::thread thread;
+
+        Shard(RadioMessageListener &radioMessageListener);
+    };
+
+    Shard** shards_;
+    unsigned int size_;
+    unsigned char shard_bits_;
+    bool running_;
+
+    void serve(Shard &shard);
+
+    CoAPShardedServer(const CoAPShardedServer &server);
+    CoAPShardedServer &operator=(const CoAPShardedServer &server);
+public:
+    CoAPShardedServer(unsigned int shards, RadioMessageListener &radioMessageListener);
+    ~CoAPShardedServer();
+
+    bool start(unsigned short port, unsigned long address = INADDR_ANY);
+    void stop();
+    unsigned short getPort() const;
+    unsigned int size() const;
+
+    void handleMessage(RadioMessage &radioMessage);
+    void registerResource(const Array<String> &uri_path, unsigned short *value, const String &type = String());
+    void registerResource(const Array<String> &uri_path, CoAPResourceHandler &handler,
+                          const String &type = String());
+    void setMaxAge(unsigned long seconds);
+};
+
+#endif
+
+#endif //COAPLIB_COAPSHARDEDSERVER_H
@@ -0,0 +1,126 @@
+#include "CoAPTimers.h"
+
+/** Creates heap for handles from 0 to capacity - 1 **/
+CoAPTimers::CoAPTimers(unsigned int capacity) :
+        capacity_(capacity),
+        size_(0) {
+    heap_ = new unsigned short[capacity_];
+    deadlines_ = new unsigned long[capacity_];
+    positions_ = new int[capacity_];
+    for (unsigned int i = 0; i < capacity_; ++i) {
+        positions_[i] = NO_TIMER;
+    }
+}
+
+CoAPTimers::~CoAPTimers() {
+    delete[] heap_;
+    delete[] deadlines_;
+    delete[] positions_;
+}
+
+/** Tells if timer at first heap position expires before timer at second one **/
+bool CoAPTimers::isEarlier(unsigned int first, unsigned int second) const {
+    return (long) (deadlines_[heap_[first]] - deadlines_[heap_[second]]) < 0;
+}
+
+void CoAPTimers::swap(unsigned int first, unsigned int second) {
+    unsigned short handle = heap_[first];
+    heap_[first] = heap_[second];
+    heap_[second] = handle;
+
+    positions_[heap_[first]] = first;
+    positions_[heap_[second]] = second;
+}
+
+void CoAPTimers::siftUp(unsigned int position) {
+    while (position > 0) {
+        unsigned int parent = (position - 1) / 2;
+        if (!isEarlier(position, parent))
+            return;
+
+        swap(position, parent);
+        position = parent;
+    }
+}
+
+void CoAPTimers::siftDown(unsigned int position) {
+    while (true) {
+        unsigned int earliest = position;
+        unsigned int left = 2 * position + 1;
+        unsigned int right = left + 1;
+
+        if (left < size_ && isEarlier(left, earliest))
+            earliest = left;
+        if (right < size_ && isEarlier(right, earliest))
+            earliest = right;
+        if (earliest == position)
+            return;
+
+        swap(position, earliest);
+        position = earliest;
+    }
+}
+
+/** Replaces timer at given position with the last one and restores heap order **/
+void CoAPTimers::removeAt(unsigned int position) {
+    positions_[heap_[position]] = NO_TIMER;
+    --size_;
+
+    if (position == size_)
+        return;
+
+    heap_[position] = heap_[size_];
+    positions_[heap_[position]] = position;
+    siftUp(position);
+    siftDown(position);
+}
+
+/** Sets timer of given handle to expire at given time, replacing previous deadline if there was one **/
+void CoAPTimers::schedule(int handle, unsigned long deadline) {
+    if (handle < 0 || (unsigned int) handle >= capacity_)
+        return;
+
+    deadlines_[handle] = deadline;
+
+    if (positions_[handle] == NO_TIMER) {
+        heap_[size_] = (unsigned short) handle;
+        positions_[handle] = size_;
+        siftUp(size_++);
+    }
+    else {
+        siftUp((unsigned int) positions_[handle]);
+        siftDown((unsigned int) positions_[handle]);
+    }
+}
+
+/** Removes timer of given handle, does nothing if it is not scheduled **/
+void CoAPTimers::cancel(int handle) {
+    if (handle < 0 || (unsigned int) handle >= capacity_ || positions_[handle] == NO_TIMER)
+        return;
+
+    removeAt((unsigned int) positions_[handle]);
+}
+
+/** Removes earliest timer if it has expired at given time and returns its handle **/
+bool CoAPTimers::popExpired(unsigned long now, int &handle) {
+    if (size_ == 0 || (long) (now - deadlines_[heap_[0]]) < 0)
+        return false;
+
+    handle = heap_[0];
+    removeAt(0);
+    return true;
+}
+
+/** Returns earliest deadline, false if there are no timers **/
+bool CoAPTimers::nextDeadline(unsigned long &deadline) const {
+    if (size_ == 0)
+        return false;
+
+    deadline = deadlines_[heap_[0]];
+    return true;
+}
+
+/** Returns number of scheduled timers **/
+unsigned int CoAPTimers::size() const {
+    return size_;
+}
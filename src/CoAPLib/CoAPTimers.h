@@ -0,0 +1,42 @@
+#ifndef COAPLIB_COAPTIMERS_H
+#define COAPLIB_COAPTIMERS_H
+
+#include "../Environment.h"
+
+#define NO_TIMER -1
+
+/**
+ * Fixed-capacity min-heap of deadlines, each one bound to handle of pending message.
+ * Earliest deadline is always on top, so expiring timers costs O(log n) per expired timer
+ * instead of scanning every pending message. Deadlines are compared in a way that survives
+ * overflow of millis().
+ */
+class CoAPTimers {
+private:
+    unsigned short* heap_;
+    unsigned long* deadlines_;
+    int* positions_;
+    unsigned int capacity_;
+    unsigned int size_;
+
+    bool isEarlier(unsigned int first, unsigned int second) const;
+    void swap(unsigned int first, unsigned int second);
+    void siftUp(unsigned int position);
+    void siftDown(unsigned int position);
+    void removeAt(unsigned int position);
+
+    CoAPTimers(const CoAPTimers &timers);
+    CoAPTimers &operator=(const CoAPTimers &timers);
+public:
+    CoAPTimers(unsigned int capacity);
+    ~CoAPTimers();
+
+    void schedule(int handle, unsigned long deadline);
+    void cancel(int handle);
+    bool popExpired(unsigned long now, int &handle);
+    bool nextDeadline(unsigned long &deadline) const;
+
+    unsigned int size() const;
+};
+
+#endif //COAPLIB_COAPTIMERS_H
@@ -0,0 +1,362 @@
+#include "CoAPUdpServer.h"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+/** Prepares buffers for batches of datagrams, socket is opened by bind **/
+CoAPUdpServer::CoAPUdpServer() :
+        socket_(-1),
+        epoll_(-1),
+        handler_(nullptr),
+        peer_(),
+        queued_(0),
+        oversized_(0),
+        truncated_(0),
+        unsent_(0) {
+    receive_buffers_ = new unsigned char[UDP_BATCH_SIZE * UDP_BUFFER_SIZE];
+    receive_addresses_ = new sockaddr_in[UDP_BATCH_SIZE];
+    receive_vectors_ = new iovec[UDP_BATCH_SIZE];
+    receive_messages_ = new mmsghdr[UDP_BATCH_SIZE];
+
+    send_buffers_ = new unsigned char[UDP_BATCH_SIZE * UDP_BUFFER_SIZE];
+    send_addresses_ = new sockaddr_in[UDP_BATCH_SIZE];
+    send_vectors_ = new iovec[UDP_BATCH_SIZE];
+    send_messages_ = new mmsghdr[UDP_BATCH_SIZE];
+
+    memset(receive_messages_, 0, UDP_BATCH_SIZE * sizeof(mmsghdr));
+    memset(send_messages_, 0, UDP_BATCH_SIZE * sizeof(mmsghdr));
+    for (unsigned int i = 0; i < UDP_BATCH_SIZE; ++i) {
+        receive_vectors_[i].iov_base = receive_buffers_ + i * UDP_BUFFER_SIZE;
+        receive_vectors_[i].iov_len = UDP_BUFFER_SIZE;
+        receive_messages_[i].msg_hdr.msg_iov = &receive_vectors_[i];
+        receive_messages_[i].msg_hdr.msg_iovlen = 1;
+        receive_messages_[i].msg_hdr.msg_name = &receive_addresses_[i];
+
+        send_vectors_[i].iov_base = send_buffers_ + i * UDP_BUFFER_SIZE;
+        send_messages_[i].msg_hdr.msg_iov = &send_vectors_[i];
+        send_messages_[i].msg_hdr.msg_iovlen = 1;
+        send_messages_[i].msg_hdr.msg_name = &send_addresses_[i];
+        send_messages_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+}
+
+CoAPUdpServer::~CoAPUdpServer() {
+    close();
+
+    delete[] receive_buffers_;
+    delete[] receive_addresses_;
+    delete[] receive_vectors_;
+    delete[] receive_messages_;
+
+    delete[] send_buffers_;
+    delete[] send_addresses_;
+    delete[] send_vectors_;
+    delete[] send_messages_;
+}
+
+/** Closes socket, nothing is received until it is bound again **/
+void CoAPUdpServer::close() {
+    if (epoll_ >= 0)
+        ::close(epoll_);
+    if (socket_ >= 0)
+        ::close(socket_);
+
+    epoll_ = -1;
+    socket_ = -1;
+}
+
+/** Sets handler which will get received messages **/
+void CoAPUdpServer::setHandler(CoAPHandler &handler) {
+    handler_ = &handler;
+}
+
+/** Opens non-blocking socket bound to given port (0 picks any free one) and address (in network byte order).
+ *  With reuse_port several servers can bind the same port, kernel spreads clients between them by address.
+ *  Returns false if socket could not be opened. **/
+bool CoAPUdpServer::bind(unsigned short port, unsigned long address, bool reuse_port) {
+    close();
+
+    socket_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (socket_ < 0)
+        return false;
+
+    int enable = 1;
+    if (reuse_port && setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        close();
+        return false;
+    }
+
+    sockaddr_in local = toAddress(CoAPEndpoint(address, port));
+    epoll_ = epoll_create1(0);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = socket_;
+
+    if (::bind(socket_, (const sockaddr *) &local, sizeof(local)) < 0
+        || epoll_ < 0 || epoll_ctl(epoll_, EPOLL_CTL_ADD, socket_, &event) < 0) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/** Returns port to which socket is bound, 0 if it is not **/
+unsigned short CoAPUdpServer::getPort() const {
+    sockaddr_in local;
+    socklen_t length = sizeof(local);
+
+    if (socket_ < 0 || getsockname(socket_, (sockaddr *) &local, &length) < 0)
+        return 0;
+
+    return ntohs(local.sin_port);
+}
+
+/** Waits up to given number of milliseconds (-1 means forever) for datagrams without receiving them.
+ *  Returns 1 if there are datagrams to receive, 0 if there are none, -1 if socket is not usable. **/
+int CoAPUdpServer::wait(int timeout) {
+    if (epoll_ < 0)
+        return -1;
+
+    epoll_event event;
+    int ready = epoll_wait(epoll_, &event, 1, timeout);
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+
+    return ready > 0 ? 1 : 0;
+}
+
+/** Waits up to given number of milliseconds (-1 means forever) for datagrams and handles all which
+ *  have arrived. Returns number of handled datagrams or -1 if socket is not usable. **/
+int CoAPUdpServer::poll(int timeout) {
+    int ready = wait(timeout);
+    if (ready < 0)
+        return -1;
+
+    unsigned int handled = 0;
+    if (ready > 0) {
+        unsigned int received;
+        do {
+            received = receive();
+            handled += received;
+        } while (received == UDP_BATCH_SIZE);
+    }
+
+    flush();
+    return (int) handled;
+}
+
+/** Receives single batch of datagrams and passes them to handler, returns their number **/
+unsigned int CoAPUdpServer::receive() {
+    for (unsigned int i = 0; i < UDP_BATCH_SIZE; ++i) {
+        receive_messages_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    int received = recvmmsg(socket_, receive_messages_, UDP_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (received <= 0)
+        return 0;
+
+    for (int i = 0; i < received; ++i) {
+        CoAPMessageView message;
+        peer_ = toEndpoint(receive_addresses_[i]);
+
+        // Datagram bigger than buffer has lost its end, it would be handled as different message
+        if (receive_messages_[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            DEBUG_PRINTLN("DATAGRAM TOO BIG, DROPPED");
+            ++truncated_;
+            continue;
+        }
+
+        // Malformed requests are rejected, datagrams which are not CoAP messages at all are silently ignored
+        if (handler_ == nullptr)
+            continue;
+        if (message.parse((unsigned char *) receive_vectors_[i].iov_base, receive_messages_[i].msg_len))
+            handler_->handleMessage(message, peer_);
+        else
+            handler_->handleMalformed(message, peer_);
+    }
+
+    return (unsigned int) received;
+}
+
+/** Serves requests until running becomes false, also expires pending requests and retransmits
+ *  confirmable messages on time **/
+void CoAPUdpServer::run(const volatile bool &running) {
+    while (running) {
+        if (poll(getTimeout(UDP_MAX_WAIT)) < 0)
+            return;
+
+        serviceTimers();
+    }
+}
+
+/** Returns number of milliseconds left until handler has to expire or retransmit something,
+ *  measured by clock of the handler, but no more than given maximum **/
+int CoAPUdpServer::getTimeout(int max_timeout) const {
+    unsigned long deadline;
+
+    if (handler_ == nullptr || !handler_->getNextDeadline(deadline))
+        return max_timeout;
+
+    long left = (long) (deadline - handler_->getClock().now());
+    return left < 0 ? 0 : (left < max_timeout ? (int) left : max_timeout);
+}
+
+/** Expires pending requests and retransmits confirmable messages which are due, sending right away **/
+void CoAPUdpServer::serviceTimers() {
+    if (handler_ == nullptr)
+        return;
+
+    handler_->deleteTimedOut();
+    handler_->retransmit();
+    flush();
+}
+
+/** Queues message to be sent to endpoint of the last received datagram **/
+void CoAPUdpServer::operator()(const CoAPMessage &message) {
+    (*this)(message, peer_);
+}
+
+/** Queues message to be sent to given endpoint, queue is flushed when it is full **/
+void CoAPUdpServer::operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+    if (message.getPayload().size() >= UDP_GATHER_THRESHOLD && sendGathered(message, endpoint))
+        return;
+
+    if (queued_ == UDP_BATCH_SIZE)
+        flush();
+    if (queued_ == UDP_BATCH_SIZE) {
+        DEBUG_PRINTLN("SEND QUEUE FULL, DROPPED");
+        ++unsent_;
+        return;
+    }
+
+    unsigned int size = message.serialize(send_buffers_ + queued_ * UDP_BUFFER_SIZE, UDP_BUFFER_SIZE);
+    if (size == 0) {
+        DEBUG_PRINTLN("MESSAGE TOO BIG, DROPPED");
+        ++oversized_;
+        return;
+    }
+
+    send_vectors_[queued_].iov_len = size;
+    send_addresses_[queued_] = toAddress(endpoint);
+    ++queued_;
+}
+
+/** Sends all queued messages, returns false if some of them could not be sent.
+ *  Messages which socket can not take now (its buffer is full) stay queued for the next flush,
+ *  message which can not be sent at all is dropped, so it does not hold back the following ones. **/
+bool CoAPUdpServer::flush() {
+    unsigned int sent = 0;
+    bool all_sent = true;
+
+    while (sent < queued_) {
+        int result = sendmmsg(socket_, send_messages_ + sent, queued_ - sent, 0);
+        if (result >= 0) {
+            sent += (unsigned int) result;
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+
+        all_sent = false;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+
+        DEBUG_PRINTLN("MESSAGE NOT SENT, DROPPED");
+        ++unsent_;
+        ++sent;
+    }
+
+    unsigned int left = queued_ - sent;
+    for (unsigned int i = 0; i < left; ++i) {
+        memcpy(send_buffers_ + i * UDP_BUFFER_SIZE, send_buffers_ + (sent + i) * UDP_BUFFER_SIZE,
+               send_vectors_[sent + i].iov_len);
+        send_vectors_[i].iov_len = send_vectors_[sent + i].iov_len;
+        send_addresses_[i] = send_addresses_[sent + i];
+    }
+    queued_ = left;
+
+    return all_sent;
+}
+
+/** Sends message with single sendmsg, payload and long option values are referenced in place.
+ *  Queued messages are flushed first, so messages leave in order. Returns false if message
+ *  has too many segments or socket can not take it now, then it has to be copied into send buffer. **/
+bool CoAPUdpServer::sendGathered(const CoAPMessage &message, const CoAPEndpoint &endpoint) {
+    unsigned char scratch[UDP_SCRATCH_SIZE];
+    ByteView segments[UDP_MAX_SEGMENTS];
+    unsigned int count = message.serialize(scratch, UDP_SCRATCH_SIZE, segments, UDP_MAX_SEGMENTS);
+    if (count == 0)
+        return false;
+
+    iovec vectors[UDP_MAX_SEGMENTS];
+    unsigned int size = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        vectors[i].iov_base = (void *) segments[i].begin();
+        vectors[i].iov_len = segments[i].size();
+        size += segments[i].size();
+    }
+
+    if (size > UDP_BUFFER_SIZE) {
+        DEBUG_PRINTLN("MESSAGE TOO BIG, DROPPED");
+        ++oversized_;
+        return true;
+    }
+
+    flush();
+    if (queued_ > 0)
+        return false;
+
+    sockaddr_in address = toAddress(endpoint);
+    msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_name = &address;
+    header.msg_namelen = sizeof(address);
+    header.msg_iov = vectors;
+    header.msg_iovlen = count;
+
+    while (sendmsg(socket_, &header, 0) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return false;
+        if (errno != EINTR) {
+            DEBUG_PRINTLN("MESSAGE NOT SENT, DROPPED");
+            ++unsent_;
+            break;
+        }
+    }
+    return true;
+}
+
+/** Returns number of messages dropped, because they did not fit into send buffer **/
+unsigned long CoAPUdpServer::getOversized() const {
+    return oversized_;
+}
+
+/** Returns number of messages dropped, because socket could not send them or send queue stayed full **/
+unsigned long CoAPUdpServer::getUnsent() const {
+    return unsent_;
+}
+
+/** Returns number of received datagrams dropped, because they did not fit into receive buffer **/
+unsigned long CoAPUdpServer::getTruncated() const {
+    return truncated_;
+}
+
+CoAPEndpoint CoAPUdpServer::toEndpoint(const sockaddr_in &address) {
+    return CoAPEndpoint(address.sin_addr.s_addr, ntohs(address.sin_port));
+}
+
+sockaddr_in CoAPUdpServer::toAddress(const CoAPEndpoint &endpoint) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = (in_addr_t) endpoint.address;
+    address.sin_port = htons(endpoint.port);
+    return address;
+}
+
+#endif
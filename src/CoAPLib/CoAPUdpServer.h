@@ -0,0 +1,113 @@
+#ifndef COAPLIB_COAPUDPSERVER_H
+#define COAPLIB_COAPUDPSERVER_H
+
+#if defined(__linux__)
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "CoAPEndpoint.h"
+#include "CoAPHandler.h"
+#include "CoAPMessageListener.h"
+#include "../Environment.h"
+
+// Max number of datagrams received or sent with single system call:
+#ifndef UDP_BATCH_SIZE
+    #define UDP_BATCH_SIZE 32
+#endif
+
+// Max number of milliseconds for which run waits for datagrams, when handler has nothing due:
+#ifndef UDP_MAX_WAIT
+    #define UDP_MAX_WAIT 100
+#endif
+
+// Size of single datagram buffer, 1152 bytes is the biggest CoAP message recommended by RFC 7252:
+#ifndef UDP_BUFFER_SIZE
+    #define UDP_BUFFER_SIZE 1152
+#endif
+
+// Messages with payload at least this long are sent at once with sendmsg, without copying the payload:
+#ifndef UDP_GATHER_THRESHOLD
+    #define UDP_GATHER_THRESHOLD 256
+#endif
+
+// Size of scratch buffer for headers and max number of segments of message sent without copying:
+#ifndef UDP_SCRATCH_SIZE
+    #define UDP_SCRATCH_SIZE 256
+    #define UDP_MAX_SEGMENTS 16
+#endif
+
+/**
+ * UDP transport for CoAPHandler on Linux. Datagrams are received in batches with recvmmsg into a pool
+ * of buffers and parsed in place, responses are queued and sent in batches with sendmmsg.
+ * Server is the CoAPMessageListener of its handler, so it has to be created first and given to handler:
+ *
+ *     CoAPUdpServer server;
+ *     CoAPHandler handler(server, onRadioMessageToSend);
+ *     server.setHandler(handler);
+ *     server.bind(5683);
+ *
+ * Messages with large payload (eg. link-format documents or blocks) are not copied into the send buffers,
+ * queued messages are flushed and such message is sent at once from header scratch and its own payload.
+ *
+ * Datagrams bigger than UDP_BUFFER_SIZE are dropped, as only their beginning could be received.
+ *
+ * Every datagram is handled along with endpoint it came from, so responses, late radio replies
+ * and notifications are sent to the right client.
+ */
+class CoAPUdpServer : public CoAPMessageListener {
+private:
+    int socket_;
+    int epoll_;
+    CoAPHandler* handler_;
+    CoAPEndpoint peer_;
+
+    unsigned char* receive_buffers_;
+    sockaddr_in* receive_addresses_;
+    iovec* receive_vectors_;
+    mmsghdr* receive_messages_;
+
+    unsigned char* send_buffers_;
+    sockaddr_in* send_addresses_;
+    iovec* send_vectors_;
+    mmsghdr* send_messages_;
+    unsigned int queued_;
+    unsigned long oversized_;
+    unsigned long truncated_;
+    unsigned long unsent_;
+
+    unsigned int receive();
+    bool sendGathered(const CoAPMessage &message, const CoAPEndpoint &endpoint);
+
+    static CoAPEndpoint toEndpoint(const sockaddr_in &address);
+    static sockaddr_in toAddress(const CoAPEndpoint &endpoint);
+
+    CoAPUdpServer(const CoAPUdpServer &server);
+    CoAPUdpServer &operator=(const CoAPUdpServer &server);
+public:
+    CoAPUdpServer();
+    ~CoAPUdpServer();
+
+    void setHandler(CoAPHandler &handler);
+    bool bind(unsigned short port, unsigned long address = INADDR_ANY, bool reuse_port = false);
+    void close();
+    unsigned short getPort() const;
+
+    int wait(int timeout);
+    int poll(int timeout);
+    void run(const volatile bool &running);
+    int getTimeout(int max_timeout) const;
+    void serviceTimers();
+
+    void operator()(const CoAPMessage &message) override;
+    void operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) override;
+    bool flush();
+
+    unsigned long getOversized() const;
+    unsigned long getTruncated() const;
+    unsigned long getUnsent() const;
+};
+
+#endif
+
+#endif //COAPLIB_COAPUDPSERVER_H
@@ -0,0 +1,37 @@
+#ifndef COAPLIB_COAPVALUERESOURCE_HPP
+#define COAPLIB_COAPVALUERESOURCE_HPP
+
+#include "CoAPResourceHandler.h"
+
+/**
+ * Read-only resource serving current value of given variable as text/plain, used for local metrics
+ */
+template <typename T>
+class CoAPValueResource : public CoAPResourceHandler {
+private:
+    const T* value_;
+public:
+    CoAPValueResource(const T &value, unsigned char flags = RESOURCE_OBSERVABLE);
+
+    unsigned short get(const CoAPMessageView &request, CoAPMessage &response) override;
+};
+
+template <typename T>
+CoAPValueResource<T>::CoAPValueResource(const T &value, unsigned char flags) :
+        CoAPResourceHandler(flags),
+        value_(&value) {}
+
+template <typename T>
+unsigned short CoAPValueResource<T>::get(const CoAPMessageView &request, CoAPMessage &response) {
+    String value = TO_STRING(*value_);
+    ByteArray payload(value.length());
+    payload.deserialize((const unsigned char *) value.c_str(), value.length());
+
+    ByteArray content_format;
+    content_format.pushBack(CONTENT_TEXT_PLAIN);
+    response.addOption(CoAPOption(OPTION_CONTENT_FORMAT, content_format));
+    response.setPayload(payload);
+    return CODE_CONTENT;
+}
+
+#endif //COAPLIB_COAPVALUERESOURCE_HPP
@@ -0,0 +1,220 @@
+#ifndef INLINEARRAY_H
+#define INLINEARRAY_H
+
+#include "Array.hpp"
+
+/**This class works like Array, but keeps up to N elements inside itself.
+ * Memory is allocated only when array outgrows N elements, which avoids
+ * heap allocation for short values like tokens or most of option values. **/
+template <typename T, unsigned int N>
+class InlineArray {
+private:
+    unsigned int size_;
+    unsigned int capacity_;
+    T* array_begin_;
+    T inline_begin_[N];
+
+    void release();
+public:
+    InlineArray();
+    InlineArray(unsigned int capacity);
+    InlineArray(const Array<T> & array);
+    InlineArray(const InlineArray & array);
+    InlineArray(InlineArray && array);
+
+    ~InlineArray();
+
+    void serialize(unsigned char *cursor) const;
+    void deserialize(const unsigned char *cursor, unsigned int num);
+
+    void pushBack(const T &value);
+    void reserve(unsigned int new_capacity);
+
+    InlineArray &operator=(const InlineArray & array);
+    InlineArray &operator=(InlineArray && array);
+    const T &operator[] (int index) const;
+
+    unsigned int size() const;
+    unsigned int capacity() const;
+    bool isInline() const;
+
+    T *begin() const;
+    T *end() const;
+};
+
+template <typename T, unsigned int N>
+InlineArray<T, N>::InlineArray() : size_(0), capacity_(N), array_begin_(inline_begin_) {}
+
+/**Creates array able to hold given number of elements, memory is allocated only if it is more than N**/
+template <typename T, unsigned int N>
+InlineArray<T, N>::InlineArray(unsigned int capacity) : InlineArray() {
+    reserve(capacity);
+}
+
+/**Creates copy of elements stored in Array**/
+template <typename T, unsigned int N>
+InlineArray<T, N>::InlineArray(const Array<T> &array) : InlineArray() {
+    reserve(array.size());
+    ArrayElements<T>::copy(array_begin_, array.begin(), array.size());
+    size_ = array.size();
+}
+
+/**Creates copy of another InlineArray**/
+template <typename T, unsigned int N>
+InlineArray<T, N>::InlineArray(const InlineArray &array) : InlineArray() {
+    reserve(array.size_);
+    ArrayElements<T>::copy(array_begin_, array.array_begin_, array.size_);
+    size_ = array.size_;
+}
+
+/**Takes over memory of another InlineArray, inline elements have to be moved one by one**/
+template <typename T, unsigned int N>
+InlineArray<T, N>::InlineArray(InlineArray &&array) : InlineArray() {
+    *this = static_cast<InlineArray &&>(array);
+}
+
+template <typename T, unsigned int N>
+InlineArray<T, N>::~InlineArray() {
+    release();
+}
+
+/** Frees allocated memory if elements do not fit into inline storage **/
+template <typename T, unsigned int N>
+void InlineArray<T, N>::release() {
+    if (array_begin_ != inline_begin_)
+        delete[] array_begin_;
+
+    array_begin_ = inline_begin_;
+    capacity_ = N;
+}
+
+/** Adds given element at the end of the array, spilling to allocated memory if it does not fit **/
+template <typename T, unsigned int N>
+void InlineArray<T, N>::pushBack(const T &value) {
+    if (size_ == capacity_) {
+        reserve(capacity_ * 2);
+    }
+    array_begin_[size_] = value;
+    ++size_;
+}
+
+/** Moves elements to inline storage if given capacity fits into it, otherwise to new allocated array **/
+template <typename T, unsigned int N>
+void InlineArray<T, N>::reserve(unsigned int new_capacity) {
+    if (new_capacity < size_)
+        new_capacity = size_;
+
+    if (new_capacity <= N) {
+        if (array_begin_ != inline_begin_) {
+            ArrayElements<T>::move(inline_begin_, array_begin_, size_);
+            release();
+        }
+        return;
+    }
+
+    if (new_capacity == capacity_)
+        return;
+
+    T* new_array_begin = new T[new_capacity];
+    ArrayElements<T>::move(new_array_begin, array_begin_, size_);
+    if (array_begin_ != inline_begin_)
+        delete[] array_begin_;
+
+    array_begin_ = new_array_begin;
+    capacity_ = new_capacity;
+}
+
+/**Copies into array content of another array **/
+template <typename T, unsigned int N>
+InlineArray<T, N> &InlineArray<T, N>::operator=(const InlineArray<T, N> &array) {
+    if(&array != this) {
+        size_ = 0;
+        if (capacity_ < array.size_ || (array.size_ <= N && !isInline()))
+            reserve(array.size_);
+
+        ArrayElements<T>::copy(array_begin_, array.array_begin_, array.size_);
+        size_ = array.size_;
+    }
+    return *this;
+}
+
+/**Takes over allocated memory of another array or moves its inline elements **/
+template <typename T, unsigned int N>
+InlineArray<T, N> &InlineArray<T, N>::operator=(InlineArray<T, N> &&array) {
+    if(&array != this) {
+        release();
+
+        if (array.isInline()) {
+            ArrayElements<T>::move(inline_begin_, array.inline_begin_, array.size_);
+        }
+        else {
+            array_begin_ = array.array_begin_;
+            capacity_ = array.capacity_;
+            array.array_begin_ = array.inline_begin_;
+            array.capacity_ = N;
+        }
+
+        size_ = array.size_;
+        array.size_ = 0;
+    }
+    return *this;
+}
+
+/** Returns element at given index**/
+template <typename T, unsigned int N>
+const T &InlineArray<T, N>::operator[](int index) const {
+    return array_begin_[index];
+}
+
+/** Returns number of valid elements in the array **/
+template <typename T, unsigned int N>
+unsigned int InlineArray<T, N>::size() const {
+    return size_;
+}
+
+/** Returns the capacity of an array, never less than N **/
+template <typename T, unsigned int N>
+unsigned int InlineArray<T, N>::capacity() const {
+    return capacity_;
+}
+
+/** Tells if elements are kept in inline storage **/
+template <typename T, unsigned int N>
+bool InlineArray<T, N>::isInline() const {
+    return array_begin_ == inline_begin_;
+}
+
+/** Returns pointer to the first element of the array **/
+template <typename T, unsigned int N>
+T *InlineArray<T, N>::begin() const {
+    return array_begin_;
+}
+
+/** Returns pointer to the element after the last valid element of an array **/
+template <typename T, unsigned int N>
+T *InlineArray<T, N>::end() const {
+    return array_begin_ + size_;
+}
+
+/**Copies contetnt of Array into simple char array **/
+template <typename T, unsigned int N>
+void InlineArray<T, N>::serialize(unsigned char *cursor) const {
+    if (size_ > 0)
+        memcpy(cursor, array_begin_, size_);
+}
+
+/**Copies content of char array into our Array, using inline storage if it fits **/
+template <typename T, unsigned int N>
+void InlineArray<T, N>::deserialize(const unsigned char *cursor, unsigned int num) {
+    size_ = 0;
+    if (num <= N)
+        release();
+    else if (capacity_ < num)
+        reserve(num);
+
+    size_ = num;
+    if (num > 0)
+        memcpy(array_begin_, cursor, num);
+}
+
+#endif //INLINEARRAY_H
@@ -0,0 +1,162 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include "../Environment.h"
+
+// Positions and counters in ring buffer have to be read and written atomically, on AVR only single byte is
+// (so number of dropped elements wraps at 256 there)
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+    typedef unsigned char RingIndex;
+    typedef unsigned char RingCounter;
+#else
+    typedef unsigned int RingIndex;
+    typedef unsigned long RingCounter;
+#endif
+
+/**This class is bounded queue for exactly one producer and one consumer, which can run in different
+ * threads without locks. Producer owns tail, consumer owns head, both count without wrapping at capacity,
+ * which is rounded up to power of two.
+ * Elements which do not fit are dropped and counted, so producer can tell it is pushing too fast.
+ * On AVR producer or consumer can be interrupt handler only if copying T neither allocates nor frees
+ * memory, eg. RingBuffer<RadioMessage>. **/
+template <typename T>
+class RingBuffer {
+private:
+    T* elements_;
+    RingIndex capacity_;
+    RingIndex head_;
+    RingIndex tail_;
+    RingCounter dropped_;
+    RingIndex high_water_mark_;
+
+    bool reserve(RingIndex &tail);
+    void publish(RingIndex tail);
+
+    RingBuffer(const RingBuffer &buffer);
+    RingBuffer &operator=(const RingBuffer &buffer);
+public:
+    RingBuffer(unsigned int capacity);
+    ~RingBuffer();
+
+    bool push(const T &value);
+    bool push(T &&value);
+    bool pop(T &value);
+
+    unsigned int size() const;
+    unsigned int capacity() const;
+    bool isEmpty() const;
+    unsigned long getDropped() const;
+    unsigned int getHighWaterMark() const;
+};
+
+/**Creates queue able to hold at least given number of elements, no more than half of RingIndex range**/
+template <typename T>
+RingBuffer<T>::RingBuffer(unsigned int capacity) :
+        capacity_(1),
+        head_(0),
+        tail_(0),
+        dropped_(0),
+        high_water_mark_(0) {
+    const RingIndex max_capacity = (RingIndex) (((RingIndex) ~0u >> 1) + 1);
+
+    while (capacity_ < capacity && capacity_ < max_capacity) {
+        capacity_ = (RingIndex) (capacity_ * 2);
+    }
+    elements_ = new T[capacity_];
+}
+
+template <typename T>
+RingBuffer<T>::~RingBuffer() {
+    delete[] elements_;
+}
+
+/** Called by producer. Finds slot for new element, counts it as dropped if queue is full **/
+template <typename T>
+bool RingBuffer<T>::reserve(RingIndex &tail) {
+    tail = tail_;
+
+    if ((RingIndex) (tail - __atomic_load_n(&head_, __ATOMIC_ACQUIRE)) == capacity_) {
+        __atomic_store_n(&dropped_, (RingCounter) (dropped_ + 1), __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+/** Called by producer. Makes element written at given position visible to consumer **/
+template <typename T>
+void RingBuffer<T>::publish(RingIndex tail) {
+    RingIndex size = (RingIndex) (tail + 1 - __atomic_load_n(&head_, __ATOMIC_RELAXED));
+
+    if (size > high_water_mark_)
+        __atomic_store_n(&high_water_mark_, size, __ATOMIC_RELAXED);
+    __atomic_store_n(&tail_, (RingIndex) (tail + 1), __ATOMIC_RELEASE);
+}
+
+/** Copies element at the end of queue, returns false (and drops it) if queue is full. Producer only. **/
+template <typename T>
+bool RingBuffer<T>::push(const T &value) {
+    RingIndex tail;
+    if (!reserve(tail))
+        return false;
+
+    elements_[tail & (capacity_ - 1)] = value;
+    publish(tail);
+    return true;
+}
+
+/** Moves element at the end of queue, returns false (and drops it) if queue is full. Producer only. **/
+template <typename T>
+bool RingBuffer<T>::push(T &&value) {
+    RingIndex tail;
+    if (!reserve(tail))
+        return false;
+
+    elements_[tail & (capacity_ - 1)] = static_cast<T &&>(value);
+    publish(tail);
+    return true;
+}
+
+/** Moves out the first element of queue, returns false if queue is empty. Consumer only. **/
+template <typename T>
+bool RingBuffer<T>::pop(T &value) {
+    RingIndex head = head_;
+
+    if (head == __atomic_load_n(&tail_, __ATOMIC_ACQUIRE))
+        return false;
+
+    value = static_cast<T &&>(elements_[head & (capacity_ - 1)]);
+    __atomic_store_n(&head_, (RingIndex) (head + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+/** Returns number of elements in queue, it may be already outdated if called by neither producer nor consumer **/
+template <typename T>
+unsigned int RingBuffer<T>::size() const {
+    return (RingIndex) (__atomic_load_n(&tail_, __ATOMIC_ACQUIRE) - __atomic_load_n(&head_, __ATOMIC_ACQUIRE));
+}
+
+/** Returns max number of elements in queue **/
+template <typename T>
+unsigned int RingBuffer<T>::capacity() const {
+    return capacity_;
+}
+
+/** Tells if there is nothing to pop **/
+template <typename T>
+bool RingBuffer<T>::isEmpty() const {
+    return size() == 0;
+}
+
+/** Returns number of elements dropped because queue was full **/
+template <typename T>
+unsigned long RingBuffer<T>::getDropped() const {
+    return __atomic_load_n(&dropped_, __ATOMIC_RELAXED);
+}
+
+/** Returns the biggest number of elements that were in queue at the same time **/
+template <typename T>
+unsigned int RingBuffer<T>::getHighWaterMark() const {
+    return __atomic_load_n(&high_water_mark_, __ATOMIC_RELAXED);
+}
+
+#endif //RINGBUFFER_H
@@ -1,8 +1,12 @@
 #ifndef ENVIRONMENT_H
 #define ENVIRONMENT_H
 
+#ifndef DEBUG
 #define DEBUG 0
+#endif
+#ifndef LIGHT_DEBUG
 #define LIGHT_DEBUG 1
+#endif
 
 #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
     #include <Arduino.h>
@@ -1,7 +1,9 @@
 #ifndef COAPLIB_RADIOLIB_H
 #define COAPLIB_RADIOLIB_H
 
+#include "RadioLib/RadioBatcher.hpp"
 #include "RadioLib/RadioConstants.h"
+#include "RadioLib/RadioFrameListener.hpp"
 #include "RadioLib/RadioMessage.hpp"
 #include "RadioLib/RadioMessageListener.hpp"
 #include "Environment.h"
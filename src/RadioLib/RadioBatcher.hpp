@@ -0,0 +1,152 @@
+#ifndef COAPLIB_RADIOBATCHER_HPP
+#define COAPLIB_RADIOBATCHER_HPP
+
+#include "RadioConstants.h"
+#include "RadioFrameListener.hpp"
+#include "RadioMessage.hpp"
+#include "RadioMessageListener.hpp"
+#include "../CoAPLib/CoAPClock.h"
+#include "../Environment.h"
+
+/**
+ * Coalesces radio messages sent to one node into frames, so per-frame overhead of radio is paid once
+ * for several messages. Frame is just encoded radio messages put one after another, so frame with single
+ * message is the same as radio message sent on its own. Frame is sent when next message would not fit
+ * or when its first message has waited for the batch window, which is checked by poll.
+ */
+class RadioBatcher : public RadioMessageListener {
+private:
+    RadioFrameListener* frameListener_;
+    const CoAPClock* clock_;
+    unsigned char format_;
+    unsigned char frame_[RADIO_FRAME_SIZE];
+    unsigned int size_;
+    unsigned int count_;
+    unsigned long window_;
+    unsigned long first_added_;
+    unsigned long frames_sent_;
+    unsigned long messages_sent_;
+    unsigned long messages_dropped_;
+
+    static const CoAPClock &systemClock() {
+        static CoAPClock clock;
+        return clock;
+    }
+
+    RadioBatcher(const RadioBatcher &batcher);
+    RadioBatcher &operator=(const RadioBatcher &batcher);
+public:
+    /** Creates batcher passing full frames to given listener, window is given in milliseconds **/
+    RadioBatcher(RadioFrameListener &frameListener, unsigned long window = RADIO_BATCH_WINDOW,
+                 unsigned char format = RADIO_FORMAT) :
+            RadioBatcher(frameListener, systemClock(), window, format) {}
+
+    /** Creates batcher which measures window with given clock **/
+    RadioBatcher(RadioFrameListener &frameListener, const CoAPClock &clock, unsigned long window,
+                 unsigned char format = RADIO_FORMAT) :
+            frameListener_(&frameListener),
+            clock_(&clock),
+            format_(format),
+            size_(0),
+            count_(0),
+            window_(window),
+            first_added_(0),
+            frames_sent_(0),
+            messages_sent_(0),
+            messages_dropped_(0) {}
+
+    /** Adds message to current frame, frame is sent first if message does not fit into it.
+     *  Message which can not be encoded in format of batcher (eg. too big value for legacy node) is dropped
+     *  without sending frame early. **/
+    void operator()(const RadioMessage &message) override {
+        unsigned char encoded[RADIO_MESSAGE_MAX_SIZE];
+        unsigned int encoded_size = message.encode(encoded, sizeof(encoded), format_);
+
+        if (encoded_size == 0 || encoded_size > RADIO_FRAME_SIZE) {
+            ++messages_dropped_;
+            DEBUG_PRINTLN("RADIO MESSAGE DROPPED, CAN NOT BE ENCODED");
+            return;
+        }
+
+        if (encoded_size > RADIO_FRAME_SIZE - size_)
+            flush();
+
+        if (count_ == 0)
+            first_added_ = clock_->now();
+
+        memcpy(frame_ + size_, encoded, encoded_size);
+        size_ += encoded_size;
+        ++count_;
+        ++messages_sent_;
+    }
+
+    /** Sends current frame if its first message has waited for the whole window **/
+    void poll() {
+        if (count_ > 0 && clock_->now() - first_added_ >= window_)
+            flush();
+    }
+
+    /** Sends current frame, if there is anything in it **/
+    void flush() {
+        if (count_ == 0)
+            return;
+
+        unsigned int size = size_;
+        size_ = 0;
+        count_ = 0;
+        ++frames_sent_;
+        (*frameListener_)(frame_, size);
+    }
+
+    /** Returns time until which frame can wait, false if there is nothing to send **/
+    bool getNextDeadline(unsigned long &deadline) const {
+        if (count_ == 0)
+            return false;
+
+        deadline = first_added_ + window_;
+        return true;
+    }
+
+    /** Returns number of messages waiting in current frame **/
+    unsigned int size() const {
+        return count_;
+    }
+
+    /** Returns number of frames sent so far **/
+    unsigned long getFramesSent() const {
+        return frames_sent_;
+    }
+
+    /** Returns number of messages sent so far, divided by number of frames it tells how well they are batched **/
+    unsigned long getMessagesSent() const {
+        return messages_sent_;
+    }
+
+    /** Returns number of messages which could not be encoded in format of batcher **/
+    unsigned long getMessagesDropped() const {
+        return messages_dropped_;
+    }
+
+    /** Splits received frame into radio messages and passes each of them to handler (eg. CoAPHandler).
+     *  Decoding stops at the first malformed or incomplete message. Returns number of handled messages. **/
+    template <typename Handler>
+    static unsigned int split(const unsigned char *frame, unsigned int size, Handler &handler,
+                              unsigned char format = RADIO_FORMAT) {
+        unsigned int count = 0;
+        unsigned int position = 0;
+
+        while (position < size) {
+            RadioMessage message;
+            unsigned int decoded = message.decode(frame + position, size - position, format);
+            if (decoded == 0)
+                break;
+
+            position += decoded;
+            handler.handleMessage(message);
+            ++count;
+        }
+        return count;
+    }
+};
+
+#endif //COAPLIB_RADIOBATCHER_HPP
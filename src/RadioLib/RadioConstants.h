@@ -7,5 +7,34 @@
 #define RADIO_LAMP 0
 #define RADIO_SPEAKER 1
 
+// Radio message formats:
+#define RADIO_FORMAT_LEGACY 0   // 4 bytes: message ID, 1-bit method, 1-bit resource, 14-bit value
+#define RADIO_FORMAT_V1 1       // version and method byte, message ID, varint resource, varint value
+
+#ifndef RADIO_FORMAT
+    #define RADIO_FORMAT RADIO_FORMAT_V1
+#endif
+
+// Max value carried by radio message, varint of V1 format is limited to 32 bits:
+#define RADIO_MAX_VALUE 0xFFFFFFFFUL
+
+// Max value and resource carried by legacy frame, which has 14 bits for value and 1 bit for resource:
+#define RADIO_LEGACY_MAX_VALUE 0x3FFFUL
+#define RADIO_LEGACY_MAX_RESOURCE 1
+
+// Encoded message sizes:
+#define RADIO_LEGACY_MESSAGE_SIZE 4
+#define RADIO_MESSAGE_MAX_SIZE 11
+
+// Max size of radio frame, nRF24L01 payload is 32 bytes:
+#ifndef RADIO_FRAME_SIZE
+    #define RADIO_FRAME_SIZE 32
+#endif
+
+// Number of milliseconds for which radio messages are held to be sent together in one frame:
+#ifndef RADIO_BATCH_WINDOW
+    #define RADIO_BATCH_WINDOW 2
+#endif
+
 
 #endif //COAPLIB_CONSTANTS_H
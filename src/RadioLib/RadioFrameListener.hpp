@@ -0,0 +1,9 @@
+#ifndef COAPLIB_RADIOFRAMELISTENER_HPP
+#define COAPLIB_RADIOFRAMELISTENER_HPP
+
+/** Part of callback used to pass radio frame (one or more radio messages) from library to "ino" **/
+struct RadioFrameListener {
+    virtual void operator()(const unsigned char *frame, unsigned int size) = 0;
+};
+
+#endif //COAPLIB_RADIOFRAMELISTENER_HPP
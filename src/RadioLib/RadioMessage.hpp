@@ -1,15 +1,128 @@
 #ifndef COAPLIB_RADIOMESSAGE_HPP
 #define COAPLIB_RADIOMESSAGE_HPP
 
+#include "RadioConstants.h"
 #include "../Environment.h"
+
 /**
- * Radio message structure defined to perform automatic serialization in radio module
+ * Radio message structure, encoded explicitly byte by byte, so its layout on air does not depend
+ * on compiler and platform. Format RADIO_FORMAT_V1 (all numbers big-endian):
+ *
+ *     | version:4 | code:4 | message ID:16 | resource: varint | value: varint |
+ *
+ * Varint keeps 7 bits in each byte, lowest first, highest bit tells that another byte follows.
+ * Format RADIO_FORMAT_LEGACY is the 4-byte little-endian frame sent by older nodes, which can carry
+ * only two methods, two resources and values up to 16383.
  */
 struct RadioMessage {
-    unsigned short message_id : 16;
-    unsigned short code : 1; //0 - RADIO_PUT, 1 - RADIO_GET
-    unsigned short resource : 1; //0 - Lamp, 1 - Speaker
-    unsigned short value : 14;
+    unsigned short message_id = 0;
+    unsigned char code = 0;          // RADIO_PUT or RADIO_GET
+    unsigned short resource = 0;     // eg. RADIO_LAMP
+    unsigned long value = 0;
+
+    /** Tells if message can be expressed in given format **/
+    bool fits(unsigned char format = RADIO_FORMAT) const {
+        if (format == RADIO_FORMAT_LEGACY)
+            return code <= 1 && resource <= RADIO_LEGACY_MAX_RESOURCE && value <= RADIO_LEGACY_MAX_VALUE;
+
+        return code <= 0x0F && value <= RADIO_MAX_VALUE;
+    }
+
+    /** Writes message in given format into buffer, returns number of written bytes
+     *  or 0 if buffer is too small or message can not be expressed in that format **/
+    unsigned int encode(unsigned char *buffer, unsigned int capacity, unsigned char format = RADIO_FORMAT) const {
+        if (!fits(format))
+            return 0;
+
+        if (format == RADIO_FORMAT_LEGACY) {
+            if (capacity < RADIO_LEGACY_MESSAGE_SIZE)
+                return 0;
+
+            unsigned int word = code | ((unsigned int) resource << 1) | ((unsigned int) value << 2);
+            buffer[0] = (unsigned char) (message_id & 0xFF);
+            buffer[1] = (unsigned char) (message_id >> 8);
+            buffer[2] = (unsigned char) (word & 0xFF);
+            buffer[3] = (unsigned char) (word >> 8);
+            return RADIO_LEGACY_MESSAGE_SIZE;
+        }
+
+        if (capacity < 3)
+            return 0;
+
+        buffer[0] = (unsigned char) ((RADIO_FORMAT_V1 << 4) | code);
+        buffer[1] = (unsigned char) (message_id >> 8);
+        buffer[2] = (unsigned char) (message_id & 0xFF);
+
+        unsigned int size = 3;
+        if (!encodeVarint(resource, buffer, capacity, size) || !encodeVarint(value, buffer, capacity, size))
+            return 0;
+        return size;
+    }
+
+    /** Reads message in given format from buffer, returns number of read bytes
+     *  or 0 if buffer does not start with complete and valid message **/
+    unsigned int decode(const unsigned char *buffer, unsigned int size, unsigned char format = RADIO_FORMAT) {
+        if (format == RADIO_FORMAT_LEGACY) {
+            if (size < RADIO_LEGACY_MESSAGE_SIZE)
+                return 0;
+
+            unsigned int word = buffer[2] | ((unsigned int) buffer[3] << 8);
+            message_id = (unsigned short) (buffer[0] | ((unsigned int) buffer[1] << 8));
+            code = (unsigned char) (word & 0x01);
+            resource = (unsigned short) ((word >> 1) & 0x01);
+            value = word >> 2;
+            return RADIO_LEGACY_MESSAGE_SIZE;
+        }
+
+        if (size < 3 || (buffer[0] >> 4) != RADIO_FORMAT_V1)
+            return 0;
+
+        unsigned long decoded_resource;
+        unsigned long decoded_value;
+        unsigned int position = 3;
+        if (!decodeVarint(buffer, size, position, decoded_resource) || decoded_resource > 0xFFFF
+            || !decodeVarint(buffer, size, position, decoded_value))
+            return 0;
+
+        code = (unsigned char) (buffer[0] & 0x0F);
+        message_id = (unsigned short) (((unsigned int) buffer[1] << 8) | buffer[2]);
+        resource = (unsigned short) decoded_resource;
+        value = decoded_value;
+        return position;
+    }
+
+    /** Appends number as varint at given position, moving it past written bytes **/
+    static bool encodeVarint(unsigned long number, unsigned char *buffer, unsigned int capacity, unsigned int &position) {
+        do {
+            if (position == capacity)
+                return false;
+
+            unsigned char byte = (unsigned char) (number & 0x7F);
+            number >>= 7;
+            buffer[position++] = number > 0 ? (unsigned char) (byte | 0x80) : byte;
+        } while (number > 0);
+        return true;
+    }
+
+    /** Reads varint at given position, moving it past read bytes. Numbers longer than 32 bits
+     *  and overlong encodings (trailing zero groups) are rejected, so every number has one encoding **/
+    static bool decodeVarint(const unsigned char *buffer, unsigned int size, unsigned int &position,
+                             unsigned long &number) {
+        number = 0;
+        for (unsigned int shift = 0; shift < 35; shift += 7) {
+            if (position == size)
+                return false;
+
+            unsigned char byte = buffer[position++];
+            if (shift == 28 && (byte & 0x70) != 0)
+                return false;
+
+            number |= (unsigned long) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return byte != 0 || shift == 0;
+        }
+        return false;
+    }
 
     void print() const {
         PRINTLN("---Radio message---");
@@ -166,14 +166,167 @@ beginTest
         array.pushBack(CoAPOption(3, "3rd"));
         array.pushBack(CoAPOption(4, "4th"));
         // now array is {2, 3, 4}
-        assertEqual(array.capacity(), 3);
+        assertEqual(array.capacity(), 4);
         assertEqual(array.size(), 3);
         option = array.pop(1);
         // should be {2, 4}
         assertEqual(option.getNumber(), 3);
         assertEqual(array.begin()->getNumber(), 2);
-        assertEqual(array.capacity(), 3);
+        assertEqual(array.capacity(), 4);
         assertEqual(array.size(), 2);
     }
 
+    test(GeometricGrowth) {
+        ByteArray array;
+        unsigned int reallocations = 0;
+        unsigned int last_capacity = array.capacity();
+
+        for (int i = 0; i < 1000; ++i) {
+            array.pushBack((unsigned char) i);
+            if (array.capacity() != last_capacity) {
+                ++reallocations;
+                last_capacity = array.capacity();
+            }
+        }
+
+        assertEqual(array.size(), 1000);
+        assertEqual(reallocations, 11);
+        for (int i = 0; i < 1000; ++i) {
+            assertEqual(array[i], (unsigned char) i);
+        }
+    }
+
+    test(ShrinkThreshold) {
+        ByteArray array(16);
+        for (int i = 0; i < 16; ++i) {
+            array.pushBack((unsigned char) i);
+        }
+
+        while (array.size() > 5) {
+            array.popBack();
+        }
+        assertEqual(array.capacity(), 16);
+
+        array.popBack();
+        assertEqual(array.capacity(), 8);
+        assertEqual(array.size(), 4);
+        assertEqual(array[3], 3);
+    }
+
+    test(Move) {
+        OptionArray array;
+        array.pushBack(CoAPOption(1, "1st"));
+        array.pushBack(CoAPOption(2, "2nd"));
+        CoAPOption* elements = array.begin();
+
+        OptionArray moved(static_cast<OptionArray &&>(array));
+        assertEqual(moved.begin(), elements);
+        assertEqual(moved.size(), 2);
+        assertEqual(array.size(), 0);
+        assertEqual(array.begin(), nullptr);
+
+        array = static_cast<OptionArray &&>(moved);
+        assertEqual(array.begin(), elements);
+        assertEqual(array[1].getNumber(), 2);
+        assertEqual(moved.size(), 0);
+    }
+
+    test(PushBackNew) {
+        OptionArray array;
+        CoAPOption &option = array.pushBackNew(11, String("lamp"));
+        assertEqual(option.getNumber(), 11);
+        assertEqual(array.size(), 1);
+        assertEqual(array[0].toString(), String("lamp"));
+    }
+
+    test(Erase) {
+        Array<String> array;
+        array.pushBack("a");
+        array.pushBack("b");
+        array.pushBack("c");
+        array.insert("x", 1);
+        array.erase(0);
+
+        assertEqual(array.size(), 3);
+        assertEqual(array[0], String("x"));
+        assertEqual(array[1], String("b"));
+        assertEqual(array[2], String("c"));
+    }
+
+    test(Resize) {
+        ByteArray array(4);
+        unsigned char* elements = array.begin();
+        elements[0] = 7;
+        elements[1] = 8;
+        array.resize(2);
+
+        assertEqual(array.size(), 2);
+        assertEqual(array.begin(), elements);
+        assertEqual(array[1], 8);
+
+        array.resize(10);
+        assertEqual(array.size(), 10);
+        assertEqual(array[0], 7);
+    }
+
+    test(InlineArrayStaysInline) {
+        unsigned char token[] = {1, 2, 3, 4, 5, 6, 7, 8};
+        TokenArray array;
+        array.deserialize(token, 8);
+
+        assertEqual(array.isInline(), true);
+        assertEqual(array.size(), 8);
+        assertEqual(array.capacity(), TOKEN_MAX_LENGTH);
+        assertEqual(array[7], 8);
+
+        CoAPOption option(OPTION_URI_PATH, "speaker");
+        assertEqual(option.getValue().isInline(), true);
+        assertEqual(option.toString(), String("speaker"));
+    }
+
+    test(InlineArraySpills) {
+        InlineArray<unsigned char, 4> array;
+        for (int i = 0; i < 10; ++i) {
+            array.pushBack((unsigned char) i);
+        }
+
+        assertEqual(array.isInline(), false);
+        assertEqual(array.size(), 10);
+        for (int i = 0; i < 10; ++i) {
+            assertEqual(array[i], i);
+        }
+
+        unsigned char bytes[] = {9, 8};
+        array.deserialize(bytes, 2);
+        assertEqual(array.isInline(), true);
+        assertEqual(array.size(), 2);
+        assertEqual(array[1], 8);
+    }
+
+    test(InlineArrayCopyAndMove) {
+        InlineArray<unsigned char, 4> small;
+        small.pushBack(1);
+        InlineArray<unsigned char, 4> large;
+        for (int i = 0; i < 6; ++i) {
+            large.pushBack((unsigned char) i);
+        }
+
+        InlineArray<unsigned char, 4> copy(large);
+        assertEqual(copy.isInline(), false);
+        assertEqual(copy[5], 5);
+        copy = small;
+        assertEqual(copy.isInline(), true);
+        assertEqual(copy.size(), 1);
+
+        unsigned char* elements = large.begin();
+        InlineArray<unsigned char, 4> moved(static_cast<InlineArray<unsigned char, 4> &&>(large));
+        assertEqual(moved.begin(), elements);
+        assertEqual(large.size(), 0);
+        assertEqual(large.isInline(), true);
+
+        moved = static_cast<InlineArray<unsigned char, 4> &&>(small);
+        assertEqual(moved.isInline(), true);
+        assertEqual(moved[0], 1);
+    }
+
 endTest
\ No newline at end of file
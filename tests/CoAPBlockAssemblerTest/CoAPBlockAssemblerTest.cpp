@@ -0,0 +1,93 @@
+#include "Test.hpp"
+
+static ByteView toPayload(const char *value) {
+    return ByteView((const unsigned char *) value, strlen(value));
+}
+
+beginTest
+
+    test(InOrder) {
+        CoAPBlockAssembler assembler(2, 64);
+        CoAPEndpoint endpoint(1, 5683);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+        Block2 last = {1, 0, 4};
+
+        assertEqual(assembler.append(endpoint, nullptr, first, toPayload("0123456789abcdef"), body), CODE_CONTINUE);
+        assertEqual(assembler.size(), 1);
+        assertEqual(assembler.append(endpoint, nullptr, last, toPayload("xyz"), body), CODE_EMPTY);
+        assertEqual(assembler.size(), 0);
+        assertEqual(body.size(), 19);
+        assertEqual(memcmp(body.begin(), "0123456789abcdefxyz", 19), 0);
+    }
+
+    test(OutOfOrder) {
+        CoAPBlockAssembler assembler(2, 64);
+        CoAPEndpoint endpoint(1, 5683);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+        Block2 third = {2, 0, 4};
+        Block2 second = {1, 0, 4};
+
+        assertEqual(assembler.append(endpoint, nullptr, second, toPayload("xyz"), body), CODE_REQUEST_ENTITY_INCOMPLETE);
+        assertEqual(assembler.append(endpoint, nullptr, first, toPayload("0123456789abcdef"), body), CODE_CONTINUE);
+        assertEqual(assembler.append(endpoint, nullptr, third, toPayload("xyz"), body), CODE_REQUEST_ENTITY_INCOMPLETE);
+        assertEqual(assembler.size(), 0);
+    }
+
+    test(WrongBlockSize) {
+        CoAPBlockAssembler assembler(2, 64);
+        CoAPEndpoint endpoint(1, 5683);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+
+        assertEqual(assembler.append(endpoint, nullptr, first, toPayload("short"), body), CODE_REQUEST_ENTITY_INCOMPLETE);
+        assertEqual(assembler.size(), 0);
+    }
+
+    test(TooLarge) {
+        CoAPBlockAssembler assembler(2, 20);
+        CoAPEndpoint endpoint(1, 5683);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+        Block2 second = {1, 1, 4};
+
+        assertEqual(assembler.append(endpoint, nullptr, first, toPayload("0123456789abcdef"), body), CODE_CONTINUE);
+        assertEqual(assembler.append(endpoint, nullptr, second, toPayload("0123456789abcdef"), body),
+                    CODE_REQUEST_ENTITY_TOO_LARGE);
+        assertEqual(assembler.size(), 0);
+    }
+
+    test(SeparateTransfers) {
+        CoAPBlockAssembler assembler(2, 64);
+        CoAPEndpoint first_endpoint(1, 5683);
+        CoAPEndpoint second_endpoint(2, 5683);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+        Block2 last = {1, 0, 4};
+
+        assertEqual(assembler.append(first_endpoint, nullptr, first, toPayload("aaaaaaaaaaaaaaaa"), body), CODE_CONTINUE);
+        assertEqual(assembler.append(second_endpoint, nullptr, first, toPayload("bbbbbbbbbbbbbbbb"), body), CODE_CONTINUE);
+        assertEqual(assembler.size(), 2);
+
+        assertEqual(assembler.append(first_endpoint, nullptr, last, toPayload("a"), body), CODE_EMPTY);
+        assertEqual(body.size(), 17);
+        assertEqual(body[16], 'a');
+        assertEqual(assembler.append(second_endpoint, nullptr, last, toPayload("b"), body), CODE_EMPTY);
+        assertEqual(body[0], 'b');
+    }
+
+    test(OldestDropped) {
+        CoAPBlockAssembler assembler(1, 64);
+        ByteArray body;
+        Block2 first = {0, 1, 4};
+        Block2 last = {1, 0, 4};
+
+        assertEqual(assembler.append(CoAPEndpoint(1, 1), nullptr, first, toPayload("aaaaaaaaaaaaaaaa"), body), CODE_CONTINUE);
+        assertEqual(assembler.append(CoAPEndpoint(2, 1), nullptr, first, toPayload("bbbbbbbbbbbbbbbb"), body), CODE_CONTINUE);
+        assertEqual(assembler.size(), 1);
+        assertEqual(assembler.append(CoAPEndpoint(1, 1), nullptr, last, toPayload("a"), body),
+                    CODE_REQUEST_ENTITY_INCOMPLETE);
+    }
+
+endTest
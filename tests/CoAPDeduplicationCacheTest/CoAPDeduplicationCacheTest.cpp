@@ -0,0 +1,53 @@
+#include "Test.hpp"
+
+static CoAPManualClock manualClock;
+
+beginTest
+
+    test(FindAndAnswer) {
+        manualClock.time = 0;
+        CoAPDeduplicationCache cache(manualClock, 8);
+        assertEqual(cache.find(10, CoAPEndpoint(1, 5683)), NO_RECENT_MESSAGE);
+
+        int handle = cache.insert(10, CoAPEndpoint(1, 5683));
+        assertEqual(cache.find(10, CoAPEndpoint(1, 5683)), handle);
+        assertEqual(cache.find(10, CoAPEndpoint(2, 5683)), NO_RECENT_MESSAGE);
+        assertEqual(cache.at(handle)->answered, false);
+
+        CoAPMessage response;
+        response.setMessageId(10);
+        response.setCode(CODE_CONTENT);
+        cache.answer(10, CoAPEndpoint(1, 5683), response);
+        assertEqual(cache.at(handle)->answered, true);
+        assertEqual(cache.at(handle)->response.getCode(), CODE_CONTENT);
+    }
+
+    test(Lifetime) {
+        manualClock.time = 0;
+        CoAPDeduplicationCache cache(manualClock, 8, 1000);
+        cache.insert(1, CoAPEndpoint());
+        manualClock.time = 500;
+        cache.insert(2, CoAPEndpoint());
+
+        manualClock.time = 999;
+        assertEqual((cache.find(1, CoAPEndpoint()) != NO_RECENT_MESSAGE), true);
+        manualClock.time = 1000;
+        assertEqual(cache.find(1, CoAPEndpoint()), NO_RECENT_MESSAGE);
+        assertEqual((cache.find(2, CoAPEndpoint()) != NO_RECENT_MESSAGE), true);
+        assertEqual(cache.size(), 1);
+    }
+
+    test(EvictsOldest) {
+        manualClock.time = 0;
+        CoAPDeduplicationCache cache(manualClock, 4);
+        for (unsigned short i = 0; i < 10; ++i) {
+            cache.insert(i, CoAPEndpoint());
+        }
+
+        assertEqual(cache.size(), 4);
+        for (unsigned short i = 0; i < 10; ++i) {
+            assertEqual((cache.find(i, CoAPEndpoint()) != NO_RECENT_MESSAGE), (i >= 6));
+        }
+    }
+
+endTest
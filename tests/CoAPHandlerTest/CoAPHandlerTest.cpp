@@ -1,18 +1,113 @@
 #include "Test.hpp"
 
 static CoAPMessage coapMessage;
+static unsigned int coapMessagesSent = 0;
+static CoAPMessage coapNotification;
+static CoAPEndpoint coapEndpoint;
 static RadioMessage radioMessage;
+static unsigned int radioMessagesSent = 0;
 
 static struct OnCoAPMessageToSend : public CoAPMessageListener {
     void operator()(const CoAPMessage &message) override {
         coapMessage = message;
+        ++coapMessagesSent;
+        if (message.getT() == TYPE_NON && message.getCode() == CODE_CONTENT)
+            coapNotification = message;
+    }
+
+    void operator()(const CoAPMessage &message, const CoAPEndpoint &endpoint) override {
+        coapEndpoint = endpoint;
+        (*this)(message);
     }
 } onCoAPMessageToSend;
 
+static CoAPManualClock manualClock;
+
+static TokenArray prepareToken(unsigned char token_byte) {
+    TokenArray token;
+    token.pushBack(token_byte);
+    return token;
+}
+
+#define WELL_KNOWN_CORE "</local/rtt>;rt=\"metric\",</local/jitter>;rt=\"metric\",</local/timed_out>;rt=\"metric\"," \
+                        "</remote/lamp>;rt=\"radio\";value=0,</remote/speaker>;rt=\"radio\";value=1"
+
+static struct SensorResource : public CoAPResourceHandler {
+    unsigned short level = 0;
+
+    SensorResource() : CoAPResourceHandler(RESOURCE_OBSERVABLE) {}
+
+    unsigned short get(const CoAPMessageView &request, CoAPMessage &response) override {
+        ByteArray payload;
+        payload.pushBack((unsigned char) ('0' + level));
+        response.setPayload(payload);
+        return CODE_CONTENT;
+    }
+
+    unsigned short put(const CoAPMessageView &request, CoAPMessage &response) override {
+        if (request.getPayload().size() != 1)
+            return CODE_BAD_REQUEST;
+
+        level = (unsigned short) (request.getPayload()[0] - '0');
+        return CODE_CHANGED;
+    }
+} sensorResource;
+
+static struct NoteResource : public CoAPResourceHandler {
+    ByteArray note;
+    unsigned int puts = 0;
+
+    unsigned short put(const CoAPMessageView &request, CoAPMessage &response) override {
+        note.deserialize(request.getPayload().begin(), request.getPayload().size());
+        ++puts;
+        return CODE_CHANGED;
+    }
+} noteResource;
+
+static CoAPMessage prepareSensorRequest(unsigned short message_id, unsigned short code) {
+    CoAPMessage message;
+    message.setMessageId(message_id);
+    message.setToken(prepareToken(5));
+    message.setCode(code);
+    message.setT(TYPE_CON);
+    message.addOption(CoAPOption(OPTION_URI_PATH, "sensors"));
+    message.addOption(CoAPOption(OPTION_URI_PATH, "level"));
+    return message;
+}
+
+static CoAPMessage prepareWellKnownRequest(unsigned short message_id, const Block2 &block) {
+    CoAPMessage message;
+    message.setMessageId(message_id);
+    message.setCode(CODE_GET);
+    message.setT(TYPE_CON);
+    message.addOption(CoAPOption(OPTION_URI_PATH, ".well-known"));
+    message.addOption(CoAPOption(OPTION_URI_PATH, "core"));
+    message.addOption(CoAPOption(block));
+    return message;
+}
+
+static CoAPMessage prepareBlockwisePut(unsigned short message_id, const Block2 &block, const char *value) {
+    ByteArray content_format;
+    content_format.pushBack(0);
+    ByteArray payload;
+    payload.deserialize((const unsigned char *) value, strlen(value));
+
+    CoAPMessage message;
+    message.setMessageId(message_id);
+    message.setCode(CODE_PUT);
+    message.setT(TYPE_CON);
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+    message.addOption(CoAPOption(OPTION_CONTENT_FORMAT, content_format));
+    message.addOption(CoAPOption(OPTION_BLOCK1, block));
+    message.setPayload(payload);
+    return message;
+}
 
 static struct OnRadioMessageToSend : public RadioMessageListener {
     void operator()(const RadioMessage &message) override {
         radioMessage = message;
+        ++radioMessagesSent;
     }
 } onRadioMessageToSend;
 
@@ -180,6 +275,81 @@ beginTest
         coap_handler.deleteTimedOut();
     }
 
+    test(HandleMessageView) {
+        unsigned int buffer_size = 23;
+        unsigned char buffer[] = {0x40, 0x01, 0x5a, 0xc3, 0xbb, 0x2e, 0x77, 0x65, 0x6c,
+                                  0x6c, 0x2d, 0x6b, 0x6e, 0x6f, 0x77, 0x6e, 0x04, 0x63, 0x6f, 0x72, 0x65, 0xc1, 0x02};
+
+        CoAPMessageView message;
+        assertEqual(message.parse(buffer, buffer_size), true);
+
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.handleMessage(message);
+
+        assertEqual(coapMessage.getT(), TYPE_ACK);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getMessageId(), message.getMessageId());
+        assertEqual(coapMessage.getPayload().size() > 0, true);
+    }
+
+    test(PendingRemoteGet) {
+        CoAPMessage message;
+        message.setMessageId(321);
+        message.setCode(CODE_GET);
+        message.setT(TYPE_CON);
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.handleMessage(message);
+        assertEqual(coapHandler.getPendingMessages().size(), 1);
+
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_LAMP;
+        reply.value = 42;
+        coapHandler.handleMessage(reply);
+
+        assertEqual(coapHandler.getPendingMessages().size(), 0);
+        assertEqual(coapHandler.getPendingMessages().getHighWaterMark(), 1);
+        assertEqual(coapMessage.getMessageId(), 321);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getPayload().size(), 2);
+    }
+
+    test(RemotePutOutOfRange) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        unsigned int radio_sent = radioMessagesSent;
+
+        ByteArray content_format;
+        content_format.pushBack(CONTENT_TEXT_PLAIN);
+        ByteArray max_value;
+        max_value.deserialize((const unsigned char *) "4294967295", 10);
+
+        CoAPMessage put;
+        put.setMessageId(330);
+        put.setCode(CODE_PUT);
+        put.setT(TYPE_CON);
+        put.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        put.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        put.addOption(CoAPOption(OPTION_CONTENT_FORMAT, content_format));
+        put.setPayload(max_value);
+        coapHandler.handleMessage(put);
+        assertEqual(radioMessagesSent, radio_sent + 1);
+        assertEqual(radioMessage.value, 4294967295UL);
+
+        ByteArray too_big;
+        too_big.deserialize((const unsigned char *) "4294967296", 10);
+        put.setPayload(too_big);
+        put.setMessageId(331);
+        coapHandler.handleMessage(put);
+        assertEqual(radioMessagesSent, radio_sent + 1);
+        assertEqual(coapMessage.getMessageId(), 331);
+        assertEqual(coapMessage.getCode(), CODE_BAD_REQUEST);
+        assertEqual(coapHandler.getPendingMessages().size(), 1);
+    }
+
         test(OptionContentFormat) {
         CoAPMessage message;
         message.setMessageId(100);
@@ -209,4 +379,616 @@ beginTest
         coAPHandler.handleMessage(message);
     }
 
-endTest
\ No newline at end of file
+    test(NextDeadline) {
+        CoAPMessage message;
+        message.setMessageId(322);
+        message.setCode(CODE_GET);
+        message.setT(TYPE_CON);
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_SPEAKER));
+
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        unsigned long deadline;
+        assertEqual(coapHandler.getNextDeadline(deadline), false);
+
+        unsigned long before = millis();
+        coapHandler.handleMessage(message);
+        assertEqual(coapHandler.getNextDeadline(deadline), true);
+        assertEqual((deadline - before >= coapHandler.getTimeout()), true);
+
+        coapHandler.deleteTimedOut();
+        assertEqual(coapHandler.getPendingMessages().size(), 1);
+
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_SPEAKER;
+        reply.value = 1;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapHandler.getNextDeadline(deadline), false);
+    }
+
+    test(PingRetransmission) {
+        manualClock.time = 0;
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+
+        coapMessagesSent = 0;
+        coapHandler.sendPing();
+        coapHandler.sendPing();
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getT(), TYPE_CON);
+        unsigned short message_id = coapMessage.getMessageId();
+
+        unsigned long deadline;
+        assertEqual(coapHandler.getNextDeadline(deadline), true);
+        manualClock.time = deadline;
+        coapHandler.retransmit();
+        assertEqual(coapMessagesSent, 2);
+        assertEqual(coapMessage.getMessageId(), message_id);
+
+        unsigned char ack[] = {0x60, 0x00, 0x00, 0x00};
+        ack[2] = (unsigned char) (message_id >> 8);
+        ack[3] = (unsigned char) message_id;
+        CoAPMessageView view;
+        assertEqual(view.parse(ack, 4), true);
+        coapHandler.handleMessage(view);
+
+        assertEqual(coapHandler.getNextDeadline(deadline), false);
+        coapHandler.sendPing();
+        assertEqual(coapMessagesSent, 3);
+    }
+
+    test(PingGivenUp) {
+        manualClock.time = 0;
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+
+        coapMessagesSent = 0;
+        coapHandler.sendPing();
+
+        unsigned long deadline;
+        while (coapHandler.getNextDeadline(deadline)) {
+            manualClock.time = deadline;
+            coapHandler.retransmit();
+        }
+        assertEqual(coapMessagesSent, 1 + MAX_RETRANSMIT);
+    }
+
+    test(DuplicateRequest) {
+        CoAPMessage message;
+        message.setMessageId(500);
+        message.setCode(CODE_GET);
+        message.setT(TYPE_CON);
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        radioMessagesSent = 0;
+        coapMessagesSent = 0;
+        coapHandler.handleMessage(message);
+        coapHandler.handleMessage(message);
+        assertEqual(radioMessagesSent, 1);
+        assertEqual(coapHandler.getPendingMessages().size(), 1);
+
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_LAMP;
+        reply.value = 7;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessagesSent, 1);
+
+        coapMessage = CoAPMessage();
+        coapHandler.handleMessage(message);
+        assertEqual(radioMessagesSent, 1);
+        assertEqual(coapMessagesSent, 2);
+        assertEqual(coapMessage.getMessageId(), 500);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getPayload()[0], '7');
+    }
+
+    test(CachedRemoteGet) {
+        manualClock.time = 0;
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+        coapHandler.setMaxAge(30);
+
+        CoAPMessage message;
+        message.setMessageId(600);
+        message.setCode(CODE_GET);
+        message.setT(TYPE_CON);
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+
+        radioMessagesSent = 0;
+        coapHandler.handleMessage(message);
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_LAMP;
+        reply.value = 1;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getOptions()[1].getNumber(), OPTION_MAX_AGE);
+        assertEqual(coapMessage.getOptions()[1].getValue()[0], 30);
+
+        manualClock.time = 10000;
+        message.setMessageId(601);
+        coapHandler.handleMessage(message);
+        assertEqual(radioMessagesSent, 1);
+        assertEqual(coapMessage.getMessageId(), 601);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getOptions()[1].getValue()[0], 20);
+        assertEqual(coapMessage.getPayload()[0], '1');
+
+        manualClock.time = 30000;
+        message.setMessageId(602);
+        coapHandler.handleMessage(message);
+        assertEqual(radioMessagesSent, 2);
+    }
+
+    test(ObserveRemote) {
+        manualClock.time = 0;
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend, manualClock);
+        coapHandler.setMaxAge(0);
+
+        CoAPMessage observe;
+        observe.setMessageId(700);
+        observe.setToken(prepareToken(7));
+        observe.setCode(CODE_GET);
+        observe.setT(TYPE_CON);
+        observe.addOption(CoAPOption(OPTION_OBSERVE, ByteArray()));
+        observe.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        observe.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_SPEAKER));
+        coapHandler.handleMessage(observe);
+
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_SPEAKER;
+        reply.value = 3;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getMessageId(), 700);
+        assertEqual(coapMessage.getOptions()[0].getNumber(), OPTION_OBSERVE);
+        assertEqual(coapMessage.getOptions()[0].getValue()[0], 1);
+
+        CoAPMessage get;
+        get.setMessageId(701);
+        get.setToken(prepareToken(8));
+        get.setCode(CODE_GET);
+        get.setT(TYPE_CON);
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_SPEAKER));
+        coapHandler.handleMessage(get);
+
+        coapMessagesSent = 0;
+        reply.message_id = radioMessage.message_id;
+        reply.value = 4;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessagesSent, 2);
+
+        get.setMessageId(702);
+        coapHandler.handleMessage(get);
+        reply.message_id = radioMessage.message_id;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessagesSent, 3);
+    }
+
+    test(ObserveNotification) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.setMaxAge(0);
+
+        CoAPMessage observe;
+        observe.setMessageId(710);
+        observe.setToken(prepareToken(9));
+        observe.setCode(CODE_GET);
+        observe.setT(TYPE_CON);
+        observe.addOption(CoAPOption(OPTION_OBSERVE, ByteArray()));
+        observe.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        observe.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        coapHandler.handleMessage(observe);
+
+        CoAPMessage put;
+        put.setMessageId(711);
+        put.setCode(CODE_PUT);
+        put.setT(TYPE_CON);
+        put.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        put.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        coapHandler.handleMessage(put);
+
+        coapMessagesSent = 0;
+        RadioMessage reply;
+        reply.message_id = radioMessage.message_id;
+        reply.code = RADIO_PUT;
+        reply.resource = RADIO_LAMP;
+        reply.value = 1;
+        coapHandler.handleMessage(reply);
+
+        // Notification is sent before response to PUT
+        assertEqual(coapMessagesSent, 2);
+        assertEqual(coapMessage.getMessageId(), 711);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+        assertEqual(coapNotification.getToken()[0], 9);
+        assertEqual(coapNotification.getOptions()[0].getNumber(), OPTION_OBSERVE);
+        assertEqual(coapNotification.getOptions()[0].getValue()[0], 1);
+        assertEqual(coapNotification.getPayload()[0], '1');
+    }
+
+    test(BlockwiseWellKnown) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        String links(WELL_KNOWN_CORE);
+        Block2 second = {1, 0, 4};
+
+        CoAPMessage request1 = prepareWellKnownRequest(800, second);
+        coapHandler.handleMessage(request1);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getPayload().size(), 16);
+        assertEqual(memcmp(coapMessage.getPayload().begin(), links.c_str() + 16, 16), 0);
+        CoAPOption block = coapMessage.getOptions()[coapMessage.getOptions().size() - 1];
+        assertEqual(block.getNumber(), OPTION_BLOCK2);
+        assertEqual(block.toBlock2().num, 1);
+        assertEqual(block.toBlock2().m, 1);
+        assertEqual(block.toBlock2().szx, 4);
+
+        // Client asking for bigger blocks than supported gets smaller ones
+        Block2 first = {0, 0, 10};
+        CoAPMessage request2 = prepareWellKnownRequest(801, first);
+        coapHandler.handleMessage(request2);
+        assertEqual(coapMessage.getPayload().size() <= (1u << MAX_BLOCK_SZX), true);
+
+        Block2 out_of_range = {1000, 0, 4};
+        CoAPMessage request3 = prepareWellKnownRequest(802, out_of_range);
+        coapHandler.handleMessage(request3);
+        assertEqual(coapMessage.getCode(), CODE_BAD_OPTION);
+
+        // Reserved SZX 7 is rejected, not treated as a big block
+        ByteArray reserved;
+        reserved.pushBack(0x07);
+        CoAPMessage reserved_request;
+        reserved_request.setMessageId(803);
+        reserved_request.setCode(CODE_GET);
+        reserved_request.setT(TYPE_CON);
+        reserved_request.addOption(CoAPOption(OPTION_URI_PATH, ".well-known"));
+        reserved_request.addOption(CoAPOption(OPTION_URI_PATH, "core"));
+        reserved_request.addOption(CoAPOption(OPTION_BLOCK2, reserved));
+        coapMessagesSent = 0;
+        coapHandler.handleMessage(reserved_request);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getCode(), CODE_BAD_REQUEST);
+    }
+
+    test(BlockwisePut) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.setMaxAge(0);
+        Block2 first = {0, 1, 4};
+        Block2 last = {1, 0, 4};
+
+        radioMessagesSent = 0;
+        CoAPMessage request4 = prepareBlockwisePut(810, first, "0000000000000002");
+        coapHandler.handleMessage(request4);
+        assertEqual(radioMessagesSent, 0);
+        assertEqual(coapMessage.getCode(), CODE_CONTINUE);
+        assertEqual(coapMessage.getOptions()[0].getNumber(), OPTION_BLOCK1);
+        assertEqual(coapMessage.getOptions()[0].toBlock2().m, 1);
+
+        CoAPMessage request5 = prepareBlockwisePut(811, last, "4");
+        coapHandler.handleMessage(request5);
+        assertEqual(radioMessagesSent, 1);
+        assertEqual(radioMessage.value, 24);
+
+        // Final response echoes the last Block1
+        RadioMessage reply = radioMessage;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+        CoAPOption block1 = coapMessage.getOptions()[coapMessage.getOptions().size() - 1];
+        assertEqual(block1.getNumber(), OPTION_BLOCK1);
+        assertEqual(block1.toBlock2().num, 1);
+        assertEqual(block1.toBlock2().m, 0);
+        assertEqual(block1.toBlock2().szx, 4);
+
+        CoAPMessage request6 = prepareBlockwisePut(812, last, "4");
+        coapHandler.handleMessage(request6);
+        assertEqual(coapMessage.getCode(), CODE_REQUEST_ENTITY_INCOMPLETE);
+
+        Block2 reserved = {0, 0, RESERVED_BLOCK_SZX};
+        CoAPMessage request7 = prepareBlockwisePut(813, reserved, "4");
+        coapHandler.handleMessage(request7);
+        assertEqual(coapMessage.getCode(), CODE_BAD_REQUEST);
+    }
+
+    test(RegisteredResourceOverlay) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.setMaxAge(0);
+        Array<String> heater;
+        heater.pushBack(RESOURCE_REMOTE);
+        heater.pushBack("heater");
+        coapHandler.registerResource(heater, new unsigned short(RADIO_SPEAKER));
+        Array<String> lamp;
+        lamp.pushBack(RESOURCE_REMOTE);
+        lamp.pushBack(RESOURCE_LAMP);
+        coapHandler.registerResource(lamp, new unsigned short(RADIO_SPEAKER));
+
+        CoAPMessage message;
+        message.setMessageId(900);
+        message.setCode(CODE_GET);
+        message.setT(TYPE_CON);
+        message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        message.addOption(CoAPOption(OPTION_URI_PATH, "heater"));
+        coapHandler.handleMessage(message);
+        assertEqual(radioMessage.resource, RADIO_SPEAKER);
+
+        // Registered resource takes precedence over built-in one
+        CoAPMessage lamp_message;
+        lamp_message.setMessageId(901);
+        lamp_message.setCode(CODE_GET);
+        lamp_message.setT(TYPE_CON);
+        lamp_message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        lamp_message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        coapHandler.handleMessage(lamp_message);
+        assertEqual(radioMessage.resource, RADIO_SPEAKER);
+    }
+
+    test(WellKnownCore) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        Block2 first = {0, 0, MAX_BLOCK_SZX};
+
+        CoAPMessage message = prepareWellKnownRequest(910, first);
+        coapHandler.handleMessage(message);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getPayload().size(), strlen(WELL_KNOWN_CORE));
+        assertEqual(memcmp(coapMessage.getPayload().begin(), WELL_KNOWN_CORE, strlen(WELL_KNOWN_CORE)), 0);
+
+        CoAPMessage filtered = prepareWellKnownRequest(911, first);
+        filtered.addOption(CoAPOption(OPTION_URI_QUERY, "rt=radio"));
+        filtered.addOption(CoAPOption(OPTION_URI_QUERY, "href=/remote/s*"));
+        coapHandler.handleMessage(filtered);
+        const char *speaker = "</remote/speaker>;rt=\"radio\";value=1";
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getPayload().size(), strlen(speaker));
+        assertEqual(memcmp(coapMessage.getPayload().begin(), speaker, strlen(speaker)), 0);
+
+        // Registered resource appears in the document
+        Array<String> heater;
+        heater.pushBack(RESOURCE_REMOTE);
+        heater.pushBack("heater");
+        coapHandler.registerResource(heater, new unsigned short(RADIO_SPEAKER), RESOURCE_TYPE_RADIO);
+        CoAPMessage registered = prepareWellKnownRequest(912, first);
+        registered.addOption(CoAPOption(OPTION_URI_QUERY, "href=/remote/heater"));
+        coapHandler.handleMessage(registered);
+        const char *link = "</remote/heater>;rt=\"radio\";value=1";
+        assertEqual(coapMessage.getPayload().size(), strlen(link));
+        assertEqual(memcmp(coapMessage.getPayload().begin(), link, strlen(link)), 0);
+    }
+
+    test(ResourceHandler) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        Array<String> uri_path;
+        uri_path.pushBack("sensors");
+        uri_path.pushBack("level");
+        Node* sensor = coapHandler.registerResource(uri_path, sensorResource);
+
+        CoAPMessage put = prepareSensorRequest(920, CODE_PUT);
+        ByteArray payload;
+        payload.pushBack('3');
+        put.setPayload(payload);
+        radioMessagesSent = 0;
+        coapHandler.handleMessage(put);
+        assertEqual(radioMessagesSent, 0);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+        assertEqual(sensorResource.level, 3);
+
+        CoAPMessage get = prepareSensorRequest(921, CODE_GET);
+        get.addOption(CoAPOption(OPTION_OBSERVE, ByteArray()));
+        coapHandler.handleMessage(get);
+        assertEqual(coapMessage.getCode(), CODE_CONTENT);
+        assertEqual(coapMessage.getOptions()[0].getNumber(), OPTION_OBSERVE);
+        assertEqual(coapMessage.getPayload()[0], '3');
+
+        // Notification carries the same representation as response to GET
+        coapMessagesSent = 0;
+        sensorResource.level = 4;
+        coapHandler.notify(sensor, 4);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapNotification.getToken()[0], 5);
+        assertEqual(coapNotification.getOptions().size(), 1);
+        assertEqual(coapNotification.getOptions()[0].getNumber(), OPTION_OBSERVE);
+        assertEqual(coapNotification.getPayload().size(), 1);
+        assertEqual(coapNotification.getPayload()[0], '4');
+
+        CoAPMessage remove = prepareSensorRequest(922, CODE_DELETE);
+        coapHandler.handleMessage(remove);
+        assertEqual(coapMessage.getCode(), CODE_METHOD_NOT_ALLOWED);
+
+        CoAPMessage bad_put = prepareSensorRequest(923, CODE_PUT);
+        coapHandler.handleMessage(bad_put);
+        assertEqual(coapMessage.getCode(), CODE_BAD_REQUEST);
+    }
+
+    test(ResourceHandlerWithContentFormat) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        Array<String> uri_path;
+        uri_path.pushBack("sensors");
+        uri_path.pushBack("level");
+        coapHandler.registerResource(uri_path, sensorResource);
+
+        ByteArray text_plain;
+        text_plain.pushBack(CONTENT_TEXT_PLAIN);
+        ByteArray json;
+        json.pushBack(50);
+        ByteArray payload;
+        payload.pushBack('6');
+
+        // Content-Format is left to the handler, so every request gets exactly one response from it
+        CoAPMessage post = prepareSensorRequest(930, CODE_POST);
+        post.addOption(CoAPOption(OPTION_CONTENT_FORMAT, text_plain));
+        post.setPayload(payload);
+        coapMessagesSent = 0;
+        coapHandler.handleMessage(post);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getCode(), CODE_METHOD_NOT_ALLOWED);
+
+        CoAPMessage put = prepareSensorRequest(931, CODE_PUT);
+        put.addOption(CoAPOption(OPTION_CONTENT_FORMAT, json));
+        put.setPayload(payload);
+        coapMessagesSent = 0;
+        coapHandler.handleMessage(put);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+        assertEqual(sensorResource.level, 6);
+
+        CoAPMessage text_put = prepareSensorRequest(932, CODE_PUT);
+        text_put.addOption(CoAPOption(OPTION_CONTENT_FORMAT, text_plain));
+        text_put.setPayload(payload);
+        coapMessagesSent = 0;
+        coapHandler.handleMessage(text_put);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+    }
+
+    test(ResourceHandlerBlockwisePut) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        Array<String> uri_path;
+        uri_path.pushBack("notes");
+        uri_path.pushBack("last");
+        coapHandler.registerResource(uri_path, noteResource);
+
+        const char *body = "0123456789abcdef12345";
+        Block2 blocks[] = {{0, 1, 4}, {1, 0, 4}};
+        for (unsigned int i = 0; i < 2; ++i) {
+            CoAPMessage put;
+            put.setMessageId((unsigned short) (940 + i));
+            put.setCode(CODE_PUT);
+            put.setT(TYPE_CON);
+            put.addOption(CoAPOption(OPTION_URI_PATH, "notes"));
+            put.addOption(CoAPOption(OPTION_URI_PATH, "last"));
+            put.addOption(CoAPOption(OPTION_BLOCK1, blocks[i]));
+            ByteArray payload;
+            payload.deserialize((const unsigned char *) body + 16 * i, i == 0 ? 16 : 5);
+            put.setPayload(payload);
+            coapHandler.handleMessage(put);
+        }
+
+        // Handler gets the whole body once, final response echoes the last Block1
+        assertEqual(noteResource.puts, 1);
+        assertEqual(noteResource.note.size(), 21);
+        assertEqual(memcmp(noteResource.note.begin(), body, 21), 0);
+        assertEqual(coapMessage.getCode(), CODE_CHANGED);
+        assertEqual(coapMessage.getOptions()[0].getNumber(), OPTION_BLOCK1);
+        assertEqual(coapMessage.getOptions()[0].toBlock2().num, 1);
+        assertEqual(coapMessage.getOptions()[0].toBlock2().m, 0);
+    }
+
+    test(ConcurrentClients) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.setMaxAge(0);
+        CoAPEndpoint first(0x0100007f, 5683);
+        CoAPEndpoint second(0x0200007f, 5684);
+
+        CoAPMessage get;
+        get.setMessageId(800);
+        get.setToken(prepareToken(1));
+        get.setCode(CODE_GET);
+        get.setT(TYPE_CON);
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+        coapHandler.handleMessage(get, first);
+        unsigned short first_radio_id = radioMessage.message_id;
+
+        // The same message ID from another endpoint is not a duplicate and gets its own radio ID
+        radioMessagesSent = 0;
+        get.setToken(prepareToken(2));
+        coapHandler.handleMessage(get, second);
+        assertEqual(radioMessagesSent, 1);
+        unsigned short second_radio_id = radioMessage.message_id;
+        assertEqual((first_radio_id != second_radio_id), true);
+
+        get.setMessageId(801);
+        coapHandler.handleMessage(get, second);
+        unsigned short third_radio_id = radioMessage.message_id;
+
+        // Replies are matched on radio ID, so each client gets answer to its own request
+        RadioMessage reply;
+        reply.message_id = second_radio_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_LAMP;
+        reply.value = 1;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getMessageId(), 800);
+        assertEqual(coapMessage.getToken()[0], 2);
+        assertEqual((coapEndpoint == second), true);
+
+        reply.message_id = first_radio_id;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getMessageId(), 800);
+        assertEqual(coapMessage.getToken()[0], 1);
+        assertEqual((coapEndpoint == first), true);
+
+        reply.message_id = third_radio_id;
+        coapHandler.handleMessage(reply);
+        assertEqual(coapMessage.getMessageId(), 801);
+        assertEqual((coapEndpoint == second), true);
+        assertEqual(coapHandler.getPendingMessages().size(), 0);
+
+        CoAPMessage ping;
+        ping.setMessageId(802);
+        ping.setCode(CODE_EMPTY);
+        ping.setT(TYPE_CON);
+        coapHandler.handleMessage(ping, second);
+        assertEqual(coapMessage.getT(), TYPE_ACK);
+        assertEqual((coapEndpoint == second), true);
+    }
+
+    test(RadioIdPrefix) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        coapHandler.setMaxAge(0);
+        coapHandler.setRadioIdPrefix(5, 3);
+
+        CoAPMessage get;
+        get.setCode(CODE_GET);
+        get.setT(TYPE_CON);
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+        get.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+
+        for (unsigned short i = 0; i < 4; ++i) {
+            get.setMessageId((unsigned short) (820 + i));
+            coapHandler.handleMessage(get);
+            assertEqual((radioMessage.message_id >> 13), 5);
+        }
+        assertEqual(coapHandler.getPendingMessages().size(), 4);
+    }
+
+    test(MalformedRequest) {
+        CoAPHandler coapHandler(onCoAPMessageToSend, onRadioMessageToSend);
+        CoAPMessageView message;
+
+        // Option header with reserved length 15
+        unsigned char bad_option[] = {0x41, 0x01, 0x03, 0x00, 0x7a, 0xbf, 0x61};
+        assertEqual(message.parse(bad_option, sizeof(bad_option)), false);
+        coapMessagesSent = 0;
+        coapHandler.handleMalformed(message);
+        assertEqual(coapMessagesSent, 1);
+        assertEqual(coapMessage.getT(), TYPE_ACK);
+        assertEqual(coapMessage.getCode(), CODE_BAD_OPTION);
+        assertEqual(coapMessage.getMessageId(), 0x0300);
+        assertEqual(coapMessage.getToken().size(), 1);
+        assertEqual(coapMessage.getToken()[0], 0x7a);
+
+        // Token longer than the rest of the datagram
+        unsigned char bad_token[] = {0x48, 0x01, 0x03, 0x01, 0x7a};
+        assertEqual(message.parse(bad_token, sizeof(bad_token)), false);
+        coapHandler.handleMalformed(message);
+        assertEqual(coapMessagesSent, 2);
+        assertEqual(coapMessage.getCode(), CODE_BAD_REQUEST);
+        assertEqual(coapMessage.getToken().size(), 0);
+
+        // Not confirmable, response or not even CoAP message
+        unsigned char non_request[] = {0x50, 0x01, 0x03, 0x02, 0xbf};
+        unsigned char bad_response[] = {0x60, 0x45, 0x03, 0x03, 0xbf};
+        unsigned char bad_version[] = {0x80, 0x01, 0x03, 0x04};
+        assertEqual(message.parse(non_request, sizeof(non_request)), false);
+        coapHandler.handleMalformed(message);
+        assertEqual(message.parse(bad_response, sizeof(bad_response)), false);
+        coapHandler.handleMalformed(message);
+        assertEqual(message.parse(bad_version, sizeof(bad_version)), false);
+        coapHandler.handleMalformed(message);
+        assertEqual(coapMessagesSent, 2);
+    }
+
+endTest
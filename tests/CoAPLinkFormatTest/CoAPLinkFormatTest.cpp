@@ -0,0 +1,70 @@
+#include "Test.hpp"
+
+static ByteView toView(const char *value) {
+    return ByteView((const unsigned char *) value, strlen(value));
+}
+
+static CoAPLinkFormat prepareLinks() {
+    CoAPLinkFormat links;
+    links.clear();
+    links.addLink("/remote/lamp");
+    links.addAttribute("rt", "radio light", true);
+    links.addAttribute("value", "0", false);
+    links.addLink("/remote/speaker");
+    links.addAttribute("rt", "radio", true);
+    links.addLink("/local/rtt");
+    return links;
+}
+
+static bool filtered(const CoAPLinkFormat &links, const char *query, const char *expected) {
+    Array<ByteView> queries;
+    queries.pushBack(toView(query));
+    ByteArray result;
+    links.filter(queries, result);
+    return ByteView(result.begin(), result.size()) == expected;
+}
+
+beginTest
+
+    test(Document) {
+        CoAPLinkFormat links = prepareLinks();
+
+        assertEqual(links.isValid(), true);
+        assertEqual(links.size(), 3);
+        assertEqual(links.getDocument() == "</remote/lamp>;rt=\"radio light\";value=0,</remote/speaker>;rt=\"radio\",</local/rtt>", true);
+
+        links.invalidate();
+        assertEqual(links.isValid(), false);
+    }
+
+    test(FilterByHref) {
+        CoAPLinkFormat links = prepareLinks();
+
+        assertEqual(filtered(links, "href=/local/rtt", "</local/rtt>"), true);
+        assertEqual(filtered(links, "href=/remote/*", "</remote/lamp>;rt=\"radio light\";value=0,</remote/speaker>;rt=\"radio\""), true);
+        assertEqual(filtered(links, "href=/remote", ""), true);
+    }
+
+    test(FilterByAttribute) {
+        CoAPLinkFormat links = prepareLinks();
+
+        assertEqual(filtered(links, "rt=light", "</remote/lamp>;rt=\"radio light\";value=0"), true);
+        assertEqual(filtered(links, "rt=radio", "</remote/lamp>;rt=\"radio light\";value=0,</remote/speaker>;rt=\"radio\""), true);
+        assertEqual(filtered(links, "rt=rad*", "</remote/lamp>;rt=\"radio light\";value=0,</remote/speaker>;rt=\"radio\""), true);
+        assertEqual(filtered(links, "value=0", "</remote/lamp>;rt=\"radio light\";value=0"), true);
+        assertEqual(filtered(links, "rt=radio light", ""), true);
+        assertEqual(filtered(links, "if=sensor", ""), true);
+        assertEqual(filtered(links, "rt", ""), true);
+    }
+
+    test(AddLinks) {
+        CoAPLinkFormat links;
+        links.clear();
+        links.addLink("/local/jitter");
+        links.addLinks(prepareLinks());
+
+        assertEqual(links.size(), 4);
+        assertEqual(filtered(links, "href=/local/*", "</local/jitter>,</local/rtt>"), true);
+    }
+
+endTest
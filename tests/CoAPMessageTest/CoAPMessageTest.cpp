@@ -4,7 +4,8 @@ static void assertProperlySerialized(const CoAPMessage &message, const unsigned
                                      const unsigned int buffer_size) {
     unsigned char actual_buffer[buffer_size];
     unsigned char* actual_buffer_begin = actual_buffer;
-    message.serialize(actual_buffer_begin);
+    assertEqual(message.serializedSize(), buffer_size);
+    assertEqual(message.serialize(actual_buffer_begin, buffer_size), buffer_size);
 
     for (unsigned int i = 0; i < buffer_size; ++i) {
         assertEqual(buffer[i], actual_buffer[i]);
@@ -123,4 +124,118 @@ test(OptionsAdding) {
     assertEqual(message.getOptions()[3].getValue().size(), fourth.getValue().size());
 }
 
+test(ExtendedOptionDeserialized) {
+    // Delta 28 and length 14 are both written with extended byte
+    unsigned char buffer[4 + 3 + 14 + 2];
+    buffer[0] = 0x40;
+    buffer[1] = 0x01;
+    buffer[2] = 0x12;
+    buffer[3] = 0x34;
+    buffer[4] = 0xdd;
+    buffer[5] = 28 - 13;
+    buffer[6] = 14 - 13;
+    memcpy(buffer + 7, "abcdefghijklmn", 14);
+    buffer[21] = PAYLOAD_MARKER;
+    buffer[22] = '!';
+
+    CoAPMessage message;
+    assertEqual(message.deserialize(buffer, sizeof(buffer)), true);
+    assertEqual(message.getMessageId(), 0x1234);
+    assertEqual(message.getOptions().size(), 1);
+    assertEqual(message.getOptions()[0].getNumber(), 28);
+    assertEqual(message.getOptions()[0].getValue().size(), 14);
+    assertEqual(message.getOptions()[0].getValue()[13], 'n');
+    assertEqual(message.getPayload().size(), 1);
+
+    assertProperlySerialized(message, buffer, sizeof(buffer));
+}
+
+test(MalformedNotDeserialized) {
+    CoAPMessage message;
+
+    unsigned char too_short[] = {0x40, 0x01, 0x00};
+    assertEqual(message.deserialize(too_short, sizeof(too_short)), false);
+
+    unsigned char missing_token[] = {0x48, 0x01, 0x00, 0x01, 0xab};
+    assertEqual(message.deserialize(missing_token, sizeof(missing_token)), false);
+
+    unsigned char option_too_long[] = {0x40, 0x01, 0x00, 0x01, 0xbd, 0xff, 0x61};
+    assertEqual(message.deserialize(option_too_long, sizeof(option_too_long)), false);
+    assertEqual(message.getOptions().size(), 0);
+}
+
+test(SerializedSize) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_GET);
+    message.setMessageId(1);
+    assertEqual(message.serializedSize(), 4);
+
+    ByteArray token;
+    token.pushBack(0xab);
+    token.pushBack(0xcd);
+    message.setToken(ByteView(token.begin(), token.size()));
+    message.addOption(CoAPOption(OPTION_URI_PATH, "a-rather-long-path"));
+    assertEqual(message.serializedSize(), 4 + 2 + 2 + 18);
+
+    ByteArray payload;
+    payload.pushBack('1');
+    message.setPayload(payload);
+    assertEqual(message.serializedSize(), 4 + 2 + 2 + 18 + 1 + 1);
+
+    unsigned char buffer[64];
+    assertEqual(message.serialize(buffer, sizeof(buffer)), message.serializedSize());
+    assertEqual(buffer[message.serializedSize() - 2], PAYLOAD_MARKER);
+}
+
+test(SerializeOverflow) {
+    CoAPMessage message;
+    message.setMessageId(1);
+    message.addOption(CoAPOption(OPTION_URI_PATH, "path"));
+
+    unsigned char buffer[9];
+    memset(buffer, 0, sizeof(buffer));
+    assertEqual(message.serialize(buffer, 8), 0);
+    for (unsigned int i = 0; i < sizeof(buffer); ++i) {
+        assertEqual(buffer[i], 0);
+    }
+    assertEqual(message.serialize(buffer, 9), 9);
+}
+
+test(SerializeSegments) {
+    CoAPMessage message;
+    message.setT(TYPE_ACK);
+    message.setCode(CODE_CONTENT);
+    message.setMessageId(7);
+    message.addOption(CoAPOption(OPTION_URI_PATH, "short"));
+    message.addOption(CoAPOption(OPTION_URI_QUERY, "a-query-value-which-is-long-enough-to-gather"));
+    message.addOption(CoAPOption(OPTION_ACCEPT, "0"));
+    ByteArray payload;
+    for (unsigned int i = 0; i < 100; ++i) {
+        payload.pushBack((unsigned char) i);
+    }
+    message.setPayload(payload);
+
+    unsigned char scratch[32];
+    ByteView segments[8];
+    unsigned int count = message.serialize(scratch, sizeof(scratch), segments, 8);
+    assertEqual(count, 4);
+
+    // Long option value and payload are not copied
+    assertEqual(segments[1].begin(), message.getOptions()[1].getValue().begin());
+    assertEqual(segments[3].begin(), message.getPayload().begin());
+
+    unsigned char expected[256];
+    unsigned int size = message.serialize(expected, sizeof(expected));
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        assertEqual((ByteView(expected + offset, segments[i].size()) == segments[i]), true);
+        offset += segments[i].size();
+    }
+    assertEqual(offset, size);
+
+    assertEqual(message.serialize(scratch, 8, segments, 8), 0);
+    assertEqual(message.serialize(scratch, sizeof(scratch), segments, 3), 0);
+}
+
 endTest
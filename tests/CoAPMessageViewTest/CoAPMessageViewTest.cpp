@@ -0,0 +1,204 @@
+#include "Test.hpp"
+
+beginTest
+
+test(PingMessage) {
+    unsigned int buffer_size = 4;
+    unsigned char buffer[] = {0x40, 0x00, 0x5e, 0xb7};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    assertEqual(message.getVer(), DEFAULT_VERSION);
+    assertEqual(message.getT(), TYPE_CON);
+    assertEqual(message.getTKL(), 0);
+    assertEqual(message.getCode(), CODE_EMPTY);
+    assertEqual(message.getMessageId(), 24247);
+    assertEqual(message.beginOptions() == message.endOptions(), true);
+    assertEqual(message.getPayload().size(), 0);
+}
+
+test(OptionsMessage) {
+    unsigned int buffer_size = 15;
+    unsigned char buffer[] = {0x40, 0x01, 0x24, 0x63, 0xb8, 0x73,
+                0x68, 0x75, 0x74, 0x64, 0x6f, 0x77, 0x6e, 0xc1, 0x02};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    assertEqual(message.getCode(), CODE_GET);
+    assertEqual(message.getMessageId(), 9315);
+
+    CoAPMessageView::OptionIterator iterator = message.beginOptions();
+    assertEqual(iterator->getNumber(), 11);
+    assertEqual(iterator->getValue().size(), 8);
+    assertEqual(iterator->getValue().begin(), buffer + 5);
+    assertEqual(iterator->toString(), String("shutdown"));
+    ++iterator;
+    assertEqual(iterator->getNumber(), 23);
+    assertEqual(iterator->getValue().size(), 1);
+    assertEqual(iterator->toBlock2().szx, 6);
+    ++iterator;
+    assertEqual(iterator == message.endOptions(), true);
+}
+
+test(OptionsAndPayloadMessage) {
+    unsigned int buffer_size = 22;
+    unsigned char buffer[] = {0x60, 0x45, 0x61, 0x91, 0x48, 0xde, 0xea, 0x9a, 0x3e,
+                              0x0e, 0xda, 0xc4, 0x9b, 0x81, 0x28, 0xb1, 0xaa, 0xff,
+                              0x74, 0x3d, 0x30, 0x2c};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    assertEqual(message.getT(), TYPE_ACK);
+    assertEqual(message.getCode(), CODE_CONTENT);
+    assertEqual(message.getMessageId(), 24977);
+    assertEqual(message.findOption(4)->getValue().size(), 8);
+    assertEqual(message.findOption(12)->getValue().size(), 1);
+    assertEqual(message.findOption(23)->getValue().size(), 1);
+    assertEqual(message.findOption(11) == message.endOptions(), true);
+    assertEqual(message.getPayload().size(), 4);
+    assertEqual(message.getPayload().begin(), buffer + 18);
+}
+
+test(Token) {
+    unsigned int buffer_size = 7;
+    unsigned char buffer[] = {0x42, 0x01, 0x00, 0x01, 0xab, 0xcd, 0x60};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    assertEqual(message.getTKL(), 2);
+    assertEqual(message.getToken().size(), 2);
+    assertEqual(message.getToken()[0], 0xab);
+    assertEqual(message.getToken()[1], 0xcd);
+    assertEqual(message.findOption(6)->getValue().size(), 0);
+}
+
+test(RepeatedOptions) {
+    unsigned int buffer_size = 18;
+    unsigned char buffer[] = {0x40, 0x01, 0x00, 0x01, 0xb6, 0x72, 0x65, 0x6d, 0x6f, 0x74,
+                              0x65, 0x04, 0x6c, 0x61, 0x6d, 0x70, 0x11, 0x00};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    CoAPMessageView::OptionIterator iterator = message.findOption(OPTION_URI_PATH);
+    assertEqual(iterator->getValue() == RESOURCE_REMOTE, true);
+    iterator = message.findOption(OPTION_URI_PATH, ++iterator);
+    assertEqual(iterator->getValue() == RESOURCE_LAMP, true);
+    iterator = message.findOption(OPTION_URI_PATH, ++iterator);
+    assertEqual(iterator == message.endOptions(), true);
+    assertEqual(message.findOption(OPTION_CONTENT_FORMAT)->getValue().size(), 1);
+}
+
+test(ExtendedOption) {
+    unsigned int buffer_size = 20;
+    unsigned char buffer[] = {0x40, 0x01, 0x00, 0x01, 0xd3, 0x0f, 0x61, 0x62, 0x63, 0xe8,
+                              0x00, 0x01, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68};
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, buffer_size), true);
+
+    assertEqual(message.beginOptions()->getNumber(), 28);
+    assertEqual(message.beginOptions()->getValue().size(), 3);
+    assertEqual(message.findOption(28 + 270)->getValue().size(), 8);
+}
+
+test(Malformed) {
+    CoAPMessageView message;
+
+    unsigned char too_short[] = {0x40, 0x01, 0x00};
+    assertEqual(message.parse(too_short, 3), false);
+
+    unsigned char bad_version[] = {0x80, 0x01, 0x00, 0x01};
+    assertEqual(message.parse(bad_version, 4), false);
+
+    unsigned char missing_token[] = {0x44, 0x01, 0x00, 0x01, 0xab};
+    assertEqual(message.parse(missing_token, 5), false);
+
+    unsigned char option_too_long[] = {0x40, 0x01, 0x00, 0x01, 0xb4, 0x61};
+    assertEqual(message.parse(option_too_long, 6), false);
+
+    unsigned char reserved_delta[] = {0x40, 0x01, 0x00, 0x01, 0xf1, 0x61};
+    assertEqual(message.parse(reserved_delta, 6), false);
+
+    unsigned char missing_extended_length[] = {0x40, 0x01, 0x00, 0x01, 0xbd};
+    assertEqual(message.parse(missing_extended_length, 5), false);
+
+    unsigned char empty_payload[] = {0x40, 0x01, 0x00, 0x01, PAYLOAD_MARKER};
+    assertEqual(message.parse(empty_payload, 5), false);
+}
+
+test(ParseErrors) {
+    CoAPMessageView message;
+
+    unsigned char ping[] = {0x40, 0x00, 0x00, 0x01};
+    assertEqual(message.parse(ping, 4), true);
+    assertEqual(message.getError(), PARSE_OK);
+
+    assertEqual(message.parse(ping, 3), false);
+    assertEqual(message.getError(), PARSE_TOO_SHORT);
+
+    unsigned char bad_version[] = {0x80, 0x01, 0x00, 0x01};
+    assertEqual(message.parse(bad_version, 4), false);
+    assertEqual(message.getError(), PARSE_BAD_VERSION);
+
+    // Token length 9-15 is reserved, header is still decoded but token is dropped
+    unsigned char long_token[] = {0x49, 0x01, 0x00, 0x02, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    assertEqual(message.parse(long_token, sizeof(long_token)), false);
+    assertEqual(message.getError(), PARSE_BAD_TOKEN);
+    assertEqual(message.getMessageId(), 2);
+    assertEqual(message.getToken().size(), 0);
+
+    unsigned char reserved_length[] = {0x41, 0x01, 0x00, 0x03, 0xab, 0xbf};
+    assertEqual(message.parse(reserved_length, sizeof(reserved_length)), false);
+    assertEqual(message.getError(), PARSE_BAD_OPTION);
+    assertEqual(message.getToken().size(), 1);
+    assertEqual(message.getToken()[0], 0xab);
+
+    unsigned char missing_extended_delta[] = {0x40, 0x01, 0x00, 0x01, 0xe0, 0x01};
+    assertEqual(message.parse(missing_extended_delta, sizeof(missing_extended_delta)), false);
+    assertEqual(message.getError(), PARSE_BAD_OPTION);
+
+    // Two options with delta 65000 make number bigger than 16 bits
+    unsigned char number_overflow[] = {0x40, 0x01, 0x00, 0x01, 0xe0, 0xfc, 0xdb, 0xe0, 0xfc, 0xdb};
+    assertEqual(message.parse(number_overflow, 7), true);
+    assertEqual(message.beginOptions()->getNumber(), 65000);
+    assertEqual(message.parse(number_overflow, sizeof(number_overflow)), false);
+    assertEqual(message.getError(), PARSE_BAD_OPTION);
+
+    // 2-byte extended values above 65535 do not fit into 16 bits
+    unsigned char delta_too_big[] = {0x40, 0x01, 0x00, 0x01, 0xe0, 0xff, 0xff};
+    assertEqual(message.parse(delta_too_big, sizeof(delta_too_big)), false);
+    assertEqual(message.getError(), PARSE_BAD_OPTION);
+
+    unsigned char length_too_big[] = {0x40, 0x01, 0x00, 0x01, 0x0e, 0xfe, 0xf4};
+    assertEqual(message.parse(length_too_big, sizeof(length_too_big)), false);
+    assertEqual(message.getError(), PARSE_BAD_OPTION);
+
+    assertEqual(message.parse(ping, 4), true);
+    assertEqual(message.getError(), PARSE_OK);
+}
+
+test(ExtendedLength) {
+    unsigned char buffer[4 + 3 + 300];
+    memset(buffer, 'x', sizeof(buffer));
+    buffer[0] = 0x40;
+    buffer[1] = 0x01;
+    buffer[2] = 0x00;
+    buffer[3] = 0x01;
+    buffer[4] = 0xbe;
+    buffer[5] = (300 - 269) >> 8;
+    buffer[6] = (300 - 269) & 0xff;
+
+    CoAPMessageView message;
+    assertEqual(message.parse(buffer, sizeof(buffer)), true);
+    assertEqual(message.beginOptions()->getNumber(), OPTION_URI_PATH);
+    assertEqual(message.beginOptions()->getValue().size(), 300);
+    assertEqual(message.beginOptions()->getValue().begin(), buffer + 7);
+    assertEqual(message.parse(buffer, sizeof(buffer) - 1), false);
+}
+
+endTest
@@ -0,0 +1,47 @@
+#include "Test.hpp"
+
+static TokenArray prepareToken(unsigned char token_byte) {
+    TokenArray token;
+    token.pushBack(token_byte);
+    return token;
+}
+
+beginTest
+
+    test(AddAndRemove) {
+        CoAPObservers observers(4);
+        observers.add(CoAPEndpoint(1, 5683), prepareToken(1));
+        observers.add(CoAPEndpoint(2, 5683), prepareToken(1));
+        observers.add(CoAPEndpoint(1, 5683), prepareToken(1));
+        assertEqual(observers.size(), 2);
+        assertEqual(observers[0].endpoint.address, 2);
+
+        assertEqual(observers.contains(CoAPEndpoint(1, 5683), prepareToken(1)), true);
+        assertEqual(observers.contains(CoAPEndpoint(1, 5683), prepareToken(2)), false);
+        assertEqual(observers.remove(CoAPEndpoint(1, 5683), prepareToken(1)), true);
+        assertEqual(observers.remove(CoAPEndpoint(1, 5683), prepareToken(1)), false);
+        assertEqual(observers.size(), 1);
+    }
+
+    test(EvictsOldest) {
+        CoAPObservers observers(3);
+        for (unsigned char i = 0; i < 5; ++i) {
+            observers.add(CoAPEndpoint(), prepareToken(i));
+        }
+
+        assertEqual(observers.size(), 3);
+        assertEqual(observers.contains(CoAPEndpoint(), prepareToken(1)), false);
+        assertEqual(observers[0].token[0], 2);
+        assertEqual(observers[2].token[0], 4);
+    }
+
+    test(Sequence) {
+        CoAPObservers observers(1);
+        assertEqual(observers.getSequence(), 0);
+        assertEqual(observers.update(10), true);
+        assertEqual(observers.update(10), false);
+        assertEqual(observers.update(4294967295UL), true);
+        assertEqual(observers.getSequence(), 2);
+    }
+
+endTest
@@ -74,4 +74,88 @@ test(SingleOptionStringConversion) {
     assertEqual(expected, actual);
 }
 
+test(Block2Encoding) {
+    Block2 small = {2, 1, 6};
+    CoAPOption o1(small);
+    assertEqual(o1.getNumber(), OPTION_BLOCK2);
+    assertEqual(o1.getValue().size(), 1);
+    assertEqual(o1.getValue()[0], 0x2a);
+
+    Block2 medium = {300, 0, 10};
+    CoAPOption o2(OPTION_BLOCK1, medium);
+    assertEqual(o2.getNumber(), OPTION_BLOCK1);
+    assertEqual(o2.getValue().size(), 2);
+    assertEqual(o2.toBlock2().num, 300);
+    assertEqual(o2.toBlock2().m, 0);
+    assertEqual(o2.toBlock2().szx, 10);
+
+    Block2 big = {0xfffff, 1, 4};
+    CoAPOption o3(big);
+    assertEqual(o3.getValue().size(), 3);
+    assertEqual(o3.toBlock2().num, 0xfffff);
+    assertEqual(o3.toBlock2().m, 1);
+    assertEqual(o3.toBlock2().szx, 4);
+
+    Block2 first = {0, 0, 4};
+    CoAPOption o4(first);
+    assertEqual(o4.getValue().size(), 1);
+    assertEqual(o4.toBlock2().szx, 4);
+}
+
+test(ExtendedOptions) {
+    // Delta 13 + 2 with length 13 + 0, then delta 269 + 1 with empty value
+    unsigned char buffer[] = {0xdd, 0x02, 0x00, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+                              0xe0, 0x00, 0x01};
+    unsigned char* buffer_begin = buffer;
+    unsigned char* buffer_end = buffer + sizeof(buffer);
+
+    OptionArray option_array;
+    assertEqual(CoAPOption::deserialize(buffer_begin, buffer_end, option_array), true);
+    assertEqual((buffer_begin == buffer_end), true);
+    assertEqual(option_array.size(), 2);
+    assertEqual(option_array[0].getNumber(), 15);
+    assertEqual(option_array[0].getValue().size(), 13);
+    assertEqual(option_array[1].getNumber(), 15 + 270);
+    assertEqual(option_array[1].getValue().size(), 0);
+
+    assertProperlySerialized(option_array, buffer, sizeof(buffer));
+}
+
+test(MalformedOptions) {
+    OptionArray option_array;
+
+    unsigned char value_too_long[] = {0xb4, 0x74, 0x65};
+    unsigned char* cursor = value_too_long;
+    assertEqual(CoAPOption::deserialize(cursor, value_too_long + sizeof(value_too_long), option_array), false);
+
+    unsigned char reserved_delta[] = {0xf1, 0x61};
+    cursor = reserved_delta;
+    assertEqual(CoAPOption::deserialize(cursor, reserved_delta + sizeof(reserved_delta), option_array), false);
+
+    unsigned char missing_extended_length[] = {0x1e, 0x01};
+    cursor = missing_extended_length;
+    assertEqual(CoAPOption::deserialize(cursor, missing_extended_length + sizeof(missing_extended_length), option_array), false);
+
+    assertEqual(option_array.size(), 0);
+}
+
+test(SerializedSize) {
+    OptionArray option_array;
+    option_array.pushBack(CoAPOption(OPTION_URI_PATH, "test"));
+    assertEqual(CoAPOption::serializedSize(option_array), 5);
+
+    // Delta 20 and length 13 take one extended byte each
+    option_array.pushBack(CoAPOption(31, "0123456789abc"));
+    assertEqual(CoAPOption::serializedSize(option_array), 5 + 3 + 13);
+
+    // Delta 1000 takes two extended bytes
+    option_array.pushBack(CoAPOption(1031, ""));
+    assertEqual(CoAPOption::serializedSize(option_array), 5 + 3 + 13 + 3);
+
+    unsigned char buffer[24];
+    unsigned char* cursor = buffer;
+    CoAPOption::serialize(cursor, option_array);
+    assertEqual((unsigned int) (cursor - buffer), CoAPOption::serializedSize(option_array));
+}
+
 endTest
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "Test.hpp"
+
+static PendingMessage preparePendingMessage(unsigned short radio_id, unsigned char token_byte) {
+    PendingMessage message;
+    message.radio_id = radio_id;
+    message.message_id = 1;
+    message.type = TYPE_CON;
+    message.code = CODE_GET;
+    message.token.pushBack(token_byte);
+    message.timestamp = radio_id;
+    message.resource = nullptr;
+    message.blockwise = false;
+    return message;
+}
+
+beginTest
+
+    test(InsertAndTake) {
+        CoAPPendingMessages pending_messages(16);
+        assertEqual(pending_messages.capacity(), 16);
+
+        for (unsigned short i = 0; i < 10; ++i) {
+            assertEqual((pending_messages.insert(preparePendingMessage(i, (unsigned char) i)) != NO_PENDING_MESSAGE), true);
+        }
+        assertEqual(pending_messages.size(), 10);
+
+        PendingMessage message;
+        assertEqual(pending_messages.take(4, message), true);
+        assertEqual(message.radio_id, 4);
+        assertEqual(message.token[0], 4);
+        assertEqual(pending_messages.size(), 9);
+        assertEqual(pending_messages.take(4, message), false);
+
+        for (unsigned short i = 0; i < 10; ++i) {
+            assertEqual((pending_messages.find(i) != NO_PENDING_MESSAGE), (i != 4));
+        }
+    }
+
+    test(Full) {
+        CoAPPendingMessages pending_messages(4);
+        for (unsigned short i = 0; i < 4; ++i) {
+            assertEqual((pending_messages.insert(preparePendingMessage(i, 0)) != NO_PENDING_MESSAGE), true);
+        }
+        assertEqual(pending_messages.insert(preparePendingMessage(4, 0)), NO_PENDING_MESSAGE);
+
+        PendingMessage message;
+        assertEqual(pending_messages.take(3, message), true);
+        assertEqual((pending_messages.insert(preparePendingMessage(4, 0)) != NO_PENDING_MESSAGE), true);
+        assertEqual((pending_messages.find(4) != NO_PENDING_MESSAGE), true);
+    }
+
+    test(RemovalKeepsCollidingMessages) {
+        CoAPPendingMessages pending_messages(8);
+        // Index has 16 slots, every ID which differs by multiple of 16 lands in the same slot
+        for (unsigned short i = 0; i < 6; ++i) {
+            pending_messages.insert(preparePendingMessage((unsigned short) (i * 16 + 5), 0));
+        }
+
+        PendingMessage message;
+        assertEqual(pending_messages.take(21, message), true);
+        assertEqual(pending_messages.take(53, message), true);
+
+        for (unsigned short i = 0; i < 6; ++i) {
+            unsigned short radio_id = (unsigned short) (i * 16 + 5);
+            assertEqual((pending_messages.find(radio_id) != NO_PENDING_MESSAGE), (radio_id != 21 && radio_id != 53));
+        }
+    }
+
+    test(HandlesStayValid) {
+        CoAPPendingMessages pending_messages(8);
+        int first = pending_messages.insert(preparePendingMessage(5, 0));
+        int second = pending_messages.insert(preparePendingMessage(13, 0));
+        int third = pending_messages.insert(preparePendingMessage(21, 0));
+
+        pending_messages.remove(first);
+        assertEqual((pending_messages.at(first) == nullptr), true);
+        assertEqual(pending_messages.at(second)->radio_id, 13);
+        assertEqual(pending_messages.at(third)->radio_id, 21);
+        assertEqual(pending_messages.find(21), third);
+    }
+
+    test(HighWaterMark) {
+        CoAPPendingMessages pending_messages(8);
+        PendingMessage message;
+
+        for (unsigned short i = 0; i < 5; ++i) {
+            pending_messages.insert(preparePendingMessage(i, 0));
+        }
+        for (unsigned short i = 0; i < 5; ++i) {
+            pending_messages.take(i, message);
+        }
+        pending_messages.insert(preparePendingMessage(7, 0));
+
+        assertEqual(pending_messages.size(), 1);
+        assertEqual(pending_messages.getHighWaterMark(), 5);
+    }
+
+endTest
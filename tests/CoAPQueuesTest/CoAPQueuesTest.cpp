@@ -0,0 +1,82 @@
+#include "Test.hpp"
+
+static ByteArray prepareLampRequest(unsigned short message_id) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_GET);
+    message.setMessageId(message_id);
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+
+    ByteArray buffer;
+    buffer.resize(message.serializedSize());
+    message.serialize(buffer.begin(), buffer.size());
+    return buffer;
+}
+
+beginTest
+
+    test(RoundTripThroughQueues) {
+        CoAPQueues queues(4, 4);
+        CoAPHandler handler(queues, queues);
+        handler.setMaxAge(0);
+        CoAPEndpoint client(0x0100007f, 40000);
+
+        ByteArray request = prepareLampRequest(500);
+        assertEqual(queues.receive(request.begin(), request.size(), client), true);
+        assertEqual(queues.dispatch(handler), 1);
+
+        RadioMessage radioMessage;
+        assertEqual(queues.takeRadioMessage(radioMessage), true);
+        assertEqual(radioMessage.resource, RADIO_LAMP);
+        assertEqual(queues.takeRadioMessage(radioMessage), false);
+
+        radioMessage.value = 1;
+        assertEqual(queues.receive(radioMessage), true);
+        assertEqual(queues.dispatch(handler), 1);
+
+        CoAPDatagram datagram;
+        assertEqual(queues.takeDatagram(datagram), true);
+        assertEqual((datagram.endpoint == client), true);
+
+        CoAPMessageView response;
+        assertEqual(response.parse(datagram.data.begin(), datagram.data.size()), true);
+        assertEqual(response.getT(), TYPE_ACK);
+        assertEqual(response.getMessageId(), 500);
+        assertEqual(response.getCode(), CODE_CONTENT);
+        assertEqual(queues.takeDatagram(datagram), false);
+    }
+
+    test(DispatchLimit) {
+        CoAPQueues queues(4, 4);
+        CoAPHandler handler(queues, queues);
+
+        for (unsigned short i = 0; i < 3; ++i) {
+            ByteArray request = prepareLampRequest((unsigned short) (600 + i));
+            queues.receive(request.begin(), request.size());
+        }
+
+        assertEqual(queues.dispatch(handler, 2), 2);
+        assertEqual(queues.getCoAPInbound().size(), 1);
+        assertEqual(queues.dispatch(handler), 1);
+        assertEqual(queues.getRadioOutbound().size(), 3);
+    }
+
+    test(BackPressure) {
+        CoAPQueues queues(2, 2);
+        RadioMessage radioMessage;
+
+        assertEqual(queues.receive(radioMessage), true);
+        assertEqual(queues.receive(radioMessage), true);
+        assertEqual(queues.receive(radioMessage), false);
+        assertEqual(queues.getRadioInbound().getDropped(), 1);
+
+        unsigned char garbage[] = {0x80, 0x01};
+        queues.receive(garbage, 2);
+        queues.receive(garbage, 2);
+        queues.receive(garbage, 2);
+        assertEqual(queues.getCoAPInbound().getDropped(), 1);
+        assertEqual(queues.getCoAPInbound().getHighWaterMark(), 2);
+    }
+
+endTest
@@ -107,4 +107,74 @@ beginTest
         assertEqual(coapResources.toLinkFormat(), "</remote/speaker>;value=1,</remote/lamp>;value=0,</local/jitter>,</local/rtt>,</local/timed_out>");
     }
 
-endTest
\ No newline at end of file
+    test(ManySiblings) {
+        CoAPResources coapResources;
+        Array<String> uri_path;
+        uri_path.pushBack(RESOURCE_REMOTE);
+        uri_path.pushBack("");
+
+        Node* first = nullptr;
+        for (unsigned short i = 0; i < 300; ++i) {
+            uri_path.popBack();
+            uri_path.pushBack(TO_STRING(i));
+            coapResources.insert(uri_path, new unsigned short(i));
+            if (first == nullptr)
+                first = coapResources.search(uri_path);
+        }
+
+        // Nodes never move, even when index grows
+        uri_path.popBack();
+        uri_path.pushBack("0");
+        assertEqual(coapResources.search(uri_path), first);
+
+        for (unsigned short i = 0; i < 300; ++i) {
+            uri_path.popBack();
+            uri_path.pushBack(TO_STRING(i));
+            Node* node = coapResources.search(uri_path);
+            assert(node != nullptr);
+            assertEqual(*node->getValue(), i);
+        }
+
+        uri_path.popBack();
+        uri_path.pushBack("300");
+        assert(coapResources.search(uri_path) == nullptr);
+    }
+
+    test(FindChild) {
+        CoAPResources coapResources;
+        prepareSpeakerResource(coapResources);
+        prepareLampResource(coapResources);
+        unsigned char remote[] = {'r', 'e', 'm', 'o', 't', 'e'};
+        unsigned char lamp[] = {'l', 'a', 'm', 'p', '!'};
+
+        Node* branch = coapResources.findChild(coapResources.getRoot(), ByteView(remote, 6));
+        assert(branch != nullptr);
+        assertEqual(branch->getKey(), String(RESOURCE_REMOTE));
+        assertEqual(branch->getFirstChild()->getKey(), String(RESOURCE_SPEAKER));
+        assertEqual(branch->getFirstChild()->getNextSibling()->getKey(), String(RESOURCE_LAMP));
+
+        Node* node = coapResources.findChild(branch, ByteView(lamp, 4));
+        assert(node != nullptr);
+        assertEqual(*node->getValue(), RADIO_LAMP);
+        assertEqual(node->getParent(), branch);
+        assert(coapResources.findChild(branch, ByteView(lamp, 5)) == nullptr);
+        assert(coapResources.findChild(coapResources.getRoot(), ByteView(lamp, 4)) == nullptr);
+    }
+
+    test(CachedLinkFormat) {
+        CoAPResources coapResources;
+        prepareSpeakerResource(coapResources);
+
+        const CoAPLinkFormat &links = coapResources.getLinkFormat();
+        const unsigned char *document = links.getDocument().begin();
+        assertEqual(links.size(), 1);
+        assertEqual(coapResources.getLinkFormat().getDocument().begin(), document);
+
+        Array<String> heater;
+        heater.pushBack(RESOURCE_REMOTE);
+        heater.pushBack("heater");
+        coapResources.insert(heater, new unsigned short(2), RESOURCE_TYPE_RADIO);
+        assertEqual(coapResources.toLinkFormat(), String("</remote/speaker>;value=1,</remote/heater>;rt=\"radio\";value=2"));
+    }
+
+endTest
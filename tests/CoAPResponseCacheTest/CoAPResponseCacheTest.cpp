@@ -0,0 +1,62 @@
+#include "Test.hpp"
+
+static CoAPManualClock manualClock;
+
+beginTest
+
+    test(Freshness) {
+        manualClock.time = 0;
+        CoAPResponseCache cache(manualClock, 4, 10);
+        unsigned long value;
+        unsigned long max_age;
+        assertEqual(cache.find(RADIO_LAMP, value, max_age), false);
+
+        cache.store(RADIO_LAMP, 42);
+        manualClock.time = 2500;
+        assertEqual(cache.find(RADIO_LAMP, value, max_age), true);
+        assertEqual(value, 42);
+        assertEqual(max_age, 7);
+
+        manualClock.time = 10000;
+        assertEqual(cache.find(RADIO_LAMP, value, max_age), false);
+    }
+
+    test(Invalidate) {
+        manualClock.time = 0;
+        CoAPResponseCache cache(manualClock, 4, 10);
+        cache.store(RADIO_LAMP, 1);
+        cache.store(RADIO_SPEAKER, 2);
+        cache.invalidate(RADIO_LAMP);
+
+        unsigned long value;
+        unsigned long max_age;
+        assertEqual(cache.find(RADIO_LAMP, value, max_age), false);
+        assertEqual(cache.find(RADIO_SPEAKER, value, max_age), true);
+        assertEqual(value, 2);
+    }
+
+    test(ReplacesOldest) {
+        manualClock.time = 0;
+        CoAPResponseCache cache(manualClock, 2, 10);
+        cache.store(1, 1);
+        manualClock.time = 1;
+        cache.store(2, 2);
+        manualClock.time = 2;
+        cache.store(1, 11);
+        cache.store(3, 3);
+
+        unsigned long value;
+        unsigned long max_age;
+        assertEqual(cache.size(), 2);
+        assertEqual(cache.find(2, value, max_age), false);
+        assertEqual(cache.find(1, value, max_age), true);
+        assertEqual(value, 11);
+    }
+
+    test(Disabled) {
+        CoAPResponseCache cache(manualClock, 2, 0);
+        cache.store(1, 1);
+        assertEqual(cache.size(), 0);
+    }
+
+endTest
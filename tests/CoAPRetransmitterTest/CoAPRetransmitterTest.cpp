@@ -0,0 +1,115 @@
+#include "Test.hpp"
+
+static CoAPManualClock manualClock;
+
+static CoAPMessage prepareMessage(unsigned short message_id) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_EMPTY);
+    message.setMessageId(message_id);
+    return message;
+}
+
+beginTest
+
+    test(RandomizedInitialTimeout) {
+        manualClock.time = 0;
+        CoAPRetransmitter retransmitter(manualClock, 16);
+
+        for (unsigned short i = 0; i < 16; ++i) {
+            int handle = retransmitter.track(prepareMessage(i), CoAPEndpoint(i, 5683));
+            unsigned long timeout = retransmitter.at(handle)->timeout;
+            assertEqual((timeout >= ACK_TIMEOUT), true);
+            assertEqual((timeout <= ACK_TIMEOUT * ACK_RANDOM_FACTOR_PERCENT / 100), true);
+        }
+    }
+
+    test(SeededOnFirstUse) {
+        manualClock.time = 0;
+        CoAPRetransmitter first(manualClock, 4);
+        CoAPRetransmitter second(manualClock, 4);
+        CoAPRetransmitter first_seeded(manualClock, 4, 7);
+        CoAPRetransmitter second_seeded(manualClock, 4, 7);
+
+        // Retransmitters created at the same time use different timeouts if they start sending at different times
+        manualClock.time = 1234;
+        unsigned long first_timeout = first.at(first.track(prepareMessage(1), CoAPEndpoint(1, 5683)))->timeout;
+        unsigned long first_seeded_timeout =
+                first_seeded.at(first_seeded.track(prepareMessage(1), CoAPEndpoint(1, 5683)))->timeout;
+        manualClock.time = 5678;
+        unsigned long second_timeout = second.at(second.track(prepareMessage(1), CoAPEndpoint(1, 5683)))->timeout;
+        unsigned long second_seeded_timeout =
+                second_seeded.at(second_seeded.track(prepareMessage(1), CoAPEndpoint(1, 5683)))->timeout;
+
+        assertEqual((first_timeout != second_timeout), true);
+        assertEqual(first_seeded_timeout, second_seeded_timeout);
+    }
+
+    test(ExponentialBackoff) {
+        manualClock.time = 1000;
+        CoAPRetransmitter retransmitter(manualClock, 4);
+        int tracked = retransmitter.track(prepareMessage(7), CoAPEndpoint());
+        unsigned long timeout = retransmitter.at(tracked)->timeout;
+
+        int handle;
+        bool retransmit;
+        assertEqual(retransmitter.popDue(handle, retransmit), false);
+
+        for (unsigned int i = 0; i < MAX_RETRANSMIT; ++i) {
+            unsigned long deadline;
+            assertEqual(retransmitter.nextDeadline(deadline), true);
+            assertEqual(deadline, manualClock.time + timeout);
+
+            manualClock.time = deadline - 1;
+            assertEqual(retransmitter.popDue(handle, retransmit), false);
+            manualClock.time = deadline;
+            assertEqual(retransmitter.popDue(handle, retransmit), true);
+            assertEqual(handle, tracked);
+            assertEqual(retransmit, true);
+            assertEqual(retransmitter.at(handle)->retransmissions, i + 1);
+            timeout *= 2;
+        }
+
+        manualClock.time += timeout;
+        assertEqual(retransmitter.popDue(handle, retransmit), true);
+        assertEqual(retransmit, false);
+        retransmitter.release(handle);
+        assertEqual(retransmitter.size(), 0);
+    }
+
+    test(Acknowledge) {
+        manualClock.time = 0;
+        CoAPRetransmitter retransmitter(manualClock, 4);
+        retransmitter.track(prepareMessage(1), CoAPEndpoint(1, 5683));
+        retransmitter.track(prepareMessage(1), CoAPEndpoint(2, 5683));
+
+        int handle = retransmitter.find(1, CoAPEndpoint(2, 5683));
+        assertEqual(retransmitter.at(handle)->endpoint.address, 2);
+        retransmitter.release(handle);
+        assertEqual(retransmitter.find(1, CoAPEndpoint(2, 5683)), NO_TRANSMISSION);
+        assertEqual((retransmitter.find(1, CoAPEndpoint(1, 5683)) != NO_TRANSMISSION), true);
+
+        manualClock.time = 100000;
+        bool retransmit;
+        assertEqual(retransmitter.popDue(handle, retransmit), true);
+        assertEqual(retransmitter.at(handle)->endpoint.address, 1);
+        assertEqual(retransmitter.popDue(handle, retransmit), false);
+    }
+
+    test(StartLimit) {
+        CoAPRetransmitter retransmitter(manualClock, 2);
+        assertEqual(retransmitter.canSend(CoAPEndpoint(1, 5683)), true);
+        int first = retransmitter.track(prepareMessage(1), CoAPEndpoint(1, 5683));
+        assertEqual((first != NO_TRANSMISSION), true);
+
+        assertEqual(retransmitter.canSend(CoAPEndpoint(1, 5683)), (NSTART > 1));
+        assertEqual(retransmitter.canSend(CoAPEndpoint(1, 5684)), true);
+        assertEqual((retransmitter.track(prepareMessage(2), CoAPEndpoint(1, 5684)) != NO_TRANSMISSION), true);
+
+        // Retransmitter is full
+        assertEqual(retransmitter.track(prepareMessage(3), CoAPEndpoint(2, 5683)), NO_TRANSMISSION);
+        retransmitter.release(first);
+        assertEqual((retransmitter.track(prepareMessage(3), CoAPEndpoint(2, 5683)) != NO_TRANSMISSION), true);
+    }
+
+endTest
@@ -0,0 +1,35 @@
+#include "Test.hpp"
+
+static ByteView toSegment(const char *value) {
+    return ByteView((const unsigned char *) value, strlen(value));
+}
+
+beginTest
+
+    test(BuiltInRoutes) {
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_WELL_KNOWN), toSegment(RESOURCE_CORE)), ROUTE_CORE);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_LOCAL), toSegment(RESOURCE_RTT)), ROUTE_RTT);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_LOCAL), toSegment(RESOURCE_JITTER)), ROUTE_JITTER);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_LOCAL), toSegment(RESOURCE_TIMED_OUT)), ROUTE_TIMED_OUT);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_REMOTE), toSegment(RESOURCE_LAMP)), ROUTE_LAMP);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_REMOTE), toSegment(RESOURCE_SPEAKER)), ROUTE_SPEAKER);
+
+        assertEqual(CoAPRoutes::at(ROUTE_LAMP).radio_resource, RADIO_LAMP);
+        assertEqual(CoAPRoutes::at(ROUTE_SPEAKER).radio_resource, RADIO_SPEAKER);
+        assertEqual(CoAPRoutes::at(ROUTE_RTT).radio_resource, NO_RADIO_RESOURCE);
+    }
+
+    test(UnknownRoutes) {
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_REMOTE), toSegment("heater")), NO_ROUTE);
+        assertEqual(CoAPRoutes::find(toSegment(RESOURCE_LOCAL), toSegment(RESOURCE_LAMP)), NO_ROUTE);
+        assertEqual(CoAPRoutes::find(toSegment("remote/lamp"), ByteView()), NO_ROUTE);
+        assertEqual(CoAPRoutes::find(ByteView(), ByteView()), NO_ROUTE);
+    }
+
+    test(CompileTimeHash) {
+        static_assert(CoAPRoutes::hash("") == 2166136261UL, "Empty path hashes to FNV offset basis");
+        static_assert(CoAPRoutes::hash("a") != CoAPRoutes::hash("b"), "Hash depends on content");
+        assertEqual(CoAPRoutes::hash("ab"), CoAPRoutes::hash("b", CoAPRoutes::hash("a")));
+    }
+
+endTest
@@ -0,0 +1,166 @@
+#include "Test.hpp"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define CLIENTS 16
+
+static struct OnRadioMessageToSend : public RadioMessageListener {
+    std::mutex lock;
+    RadioMessage message;
+    unsigned int sent = 0;
+
+    void operator()(const RadioMessage &radioMessage) override {
+        std::lock_guard<std::mutex> guard(lock);
+        message = radioMessage;
+        ++sent;
+    }
+
+    unsigned int getSent() {
+        std::lock_guard<std::mutex> guard(lock);
+        return sent;
+    }
+
+    RadioMessage getMessage() {
+        std::lock_guard<std::mutex> guard(lock);
+        return message;
+    }
+} onRadioMessageToSend;
+
+static int openClient() {
+    int client = socket(AF_INET, SOCK_DGRAM, 0);
+    timeval timeout = {2, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return client;
+}
+
+static void sendRequest(int client, unsigned short port, unsigned short message_id, const char *branch,
+                        const char *key) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_GET);
+    message.setMessageId(message_id);
+    message.addOption(CoAPOption(OPTION_URI_PATH, branch));
+    message.addOption(CoAPOption(OPTION_URI_PATH, key));
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    unsigned int size = message.serialize(buffer, sizeof(buffer));
+    sockaddr_in server;
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server.sin_port = htons(port);
+    sendto(client, buffer, size, 0, (const sockaddr *) &server, sizeof(server));
+}
+
+static bool receiveResponse(int client, CoAPMessageView &message, unsigned char *buffer) {
+    ssize_t size = recv(client, buffer, UDP_BUFFER_SIZE, 0);
+    return size > 0 && message.parse(buffer, (unsigned int) size);
+}
+
+beginTest
+
+test(EveryClientGetsItsResponse) {
+    CoAPShardedServer server(4, onRadioMessageToSend);
+    assertEqual(server.size(), 4);
+    assertEqual(server.start(0, htonl(INADDR_LOOPBACK)), true);
+    unsigned short port = server.getPort();
+    assertEqual(port != 0, true);
+
+    int clients[CLIENTS];
+    for (int i = 0; i < CLIENTS; ++i) {
+        clients[i] = openClient();
+        sendRequest(clients[i], port, (unsigned short) (1000 + i), RESOURCE_LOCAL, RESOURCE_RTT);
+    }
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    for (int i = 0; i < CLIENTS; ++i) {
+        CoAPMessageView response;
+        assertEqual(receiveResponse(clients[i], response, buffer), true);
+        assertEqual(response.getCode(), CODE_CONTENT);
+        assertEqual(response.getMessageId(), 1000 + i);
+        close(clients[i]);
+    }
+
+    server.stop();
+}
+
+test(RadioReplyReachesItsShard) {
+    CoAPShardedServer server(3, onRadioMessageToSend);
+    server.setMaxAge(0);
+    assertEqual(server.start(0, htonl(INADDR_LOOPBACK)), true);
+
+    // Clients are spread over shards, every radio reply has to reach shard of its request
+    int clients[CLIENTS];
+    for (int i = 0; i < CLIENTS; ++i) {
+        clients[i] = openClient();
+        unsigned int sent = onRadioMessageToSend.getSent();
+        sendRequest(clients[i], server.getPort(), (unsigned short) (2000 + i), RESOURCE_REMOTE, RESOURCE_LAMP);
+
+        for (int j = 0; j < 200 && onRadioMessageToSend.getSent() == sent; ++j) {
+            usleep(10000);
+        }
+        assertEqual(onRadioMessageToSend.getSent(), sent + 1);
+
+        RadioMessage reply;
+        reply.message_id = onRadioMessageToSend.getMessage().message_id;
+        reply.code = RADIO_GET;
+        reply.resource = RADIO_LAMP;
+        reply.value = 1;
+        server.handleMessage(reply);
+    }
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    for (int i = 0; i < CLIENTS; ++i) {
+        CoAPMessageView response;
+        assertEqual(receiveResponse(clients[i], response, buffer), true);
+        assertEqual(response.getMessageId(), 2000 + i);
+        assertEqual(response.getCode(), CODE_CONTENT);
+        assertEqual(response.getPayload()[0], '1');
+        close(clients[i]);
+    }
+}
+
+test(RegisteredResourceInEveryShard) {
+    CoAPShardedServer *server = new CoAPShardedServer(3, onRadioMessageToSend);
+    server->setMaxAge(0);
+    Array<String> heater;
+    heater.pushBack(RESOURCE_REMOTE);
+    heater.pushBack("heater");
+    server->registerResource(heater, new unsigned short(RADIO_SPEAKER), RESOURCE_TYPE_RADIO);
+    assertEqual(server->start(0, htonl(INADDR_LOOPBACK)), true);
+
+    // Clients are spread over shards, every one of them knows the resource
+    int clients[CLIENTS];
+    unsigned int sent = onRadioMessageToSend.getSent();
+    for (int i = 0; i < CLIENTS; ++i) {
+        clients[i] = openClient();
+        sendRequest(clients[i], server->getPort(), (unsigned short) (3000 + i), RESOURCE_REMOTE, "heater");
+    }
+
+    for (int i = 0; i < 200 && onRadioMessageToSend.getSent() != sent + CLIENTS; ++i) {
+        usleep(10000);
+    }
+    assertEqual(onRadioMessageToSend.getSent(), sent + CLIENTS);
+    assertEqual(onRadioMessageToSend.getMessage().resource, RADIO_SPEAKER);
+
+    for (int i = 0; i < CLIENTS; ++i) {
+        close(clients[i]);
+    }
+
+    // Every shard deletes its own copy of the value
+    server->stop();
+    delete server;
+}
+
+endTest
+
+#else
+
+beginTest
+endTest
+
+#endif
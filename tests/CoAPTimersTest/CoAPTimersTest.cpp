@@ -0,0 +1,74 @@
+#include "Test.hpp"
+
+beginTest
+
+    test(ExpiresInOrder) {
+        CoAPTimers timers(8);
+        timers.schedule(0, 300);
+        timers.schedule(1, 100);
+        timers.schedule(2, 200);
+        assertEqual(timers.size(), 3);
+
+        unsigned long deadline;
+        assertEqual(timers.nextDeadline(deadline), true);
+        assertEqual(deadline, 100);
+
+        int handle;
+        assertEqual(timers.popExpired(99, handle), false);
+        assertEqual(timers.popExpired(250, handle), true);
+        assertEqual(handle, 1);
+        assertEqual(timers.popExpired(250, handle), true);
+        assertEqual(handle, 2);
+        assertEqual(timers.popExpired(250, handle), false);
+        assertEqual(timers.size(), 1);
+    }
+
+    test(Cancel) {
+        CoAPTimers timers(8);
+        for (int i = 0; i < 8; ++i) {
+            timers.schedule(i, (unsigned long) (100 + i));
+        }
+        timers.cancel(0);
+        timers.cancel(5);
+        timers.cancel(5);
+        assertEqual(timers.size(), 6);
+
+        int handle;
+        int expected[] = {1, 2, 3, 4, 6, 7};
+        for (int i = 0; i < 6; ++i) {
+            assertEqual(timers.popExpired(1000, handle), true);
+            assertEqual(handle, expected[i]);
+        }
+
+        unsigned long deadline;
+        assertEqual(timers.nextDeadline(deadline), false);
+    }
+
+    test(Reschedule) {
+        CoAPTimers timers(4);
+        timers.schedule(0, 100);
+        timers.schedule(1, 200);
+        timers.schedule(0, 300);
+        assertEqual(timers.size(), 2);
+
+        int handle;
+        assertEqual(timers.popExpired(250, handle), true);
+        assertEqual(handle, 1);
+        assertEqual(timers.popExpired(250, handle), false);
+    }
+
+    test(Overflow) {
+        CoAPTimers timers(4);
+        unsigned long now = (unsigned long) -100;
+        timers.schedule(0, now + 200);
+        timers.schedule(1, now + 50);
+
+        int handle;
+        assertEqual(timers.popExpired(now + 60, handle), true);
+        assertEqual(handle, 1);
+        assertEqual(timers.popExpired(now + 150, handle), false);
+        assertEqual(timers.popExpired(now + 200, handle), true);
+        assertEqual(handle, 0);
+    }
+
+endTest
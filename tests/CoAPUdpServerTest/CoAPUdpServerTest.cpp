@@ -0,0 +1,279 @@
+#include "Test.hpp"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static struct OnRadioMessageToSend : public RadioMessageListener {
+    void operator()(const RadioMessage &message) override {}
+} onRadioMessageToSend;
+
+static CoAPManualClock manualClock;
+
+static int openClient() {
+    int client = socket(AF_INET, SOCK_DGRAM, 0);
+    timeval timeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return client;
+}
+
+static sockaddr_in toLoopback(unsigned short port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    return address;
+}
+
+static void sendRttRequest(int client, unsigned short port, unsigned short message_id) {
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_GET);
+    message.setMessageId(message_id);
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LOCAL));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_RTT));
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    unsigned int size = message.serialize(buffer, sizeof(buffer));
+    sockaddr_in server = toLoopback(port);
+    sendto(client, buffer, size, 0, (const sockaddr *) &server, sizeof(server));
+}
+
+static bool receiveResponse(int client, CoAPMessageView &message, unsigned char *buffer) {
+    ssize_t size = recv(client, buffer, UDP_BUFFER_SIZE, 0);
+    return size > 0 && message.parse(buffer, (unsigned int) size);
+}
+
+beginTest
+
+test(ResponsesGoToTheirPeers) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+    unsigned short port = server.getPort();
+    assertEqual(port != 0, true);
+
+    int first_client = openClient();
+    int second_client = openClient();
+    sendRttRequest(first_client, port, 100);
+    sendRttRequest(second_client, port, 200);
+
+    int handled = 0;
+    for (int i = 0; i < 10 && handled < 2; ++i) {
+        handled += server.poll(100);
+    }
+    assertEqual(handled, 2);
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    CoAPMessageView response;
+
+    assertEqual(receiveResponse(first_client, response, buffer), true);
+    assertEqual(response.getT(), TYPE_ACK);
+    assertEqual(response.getCode(), CODE_CONTENT);
+    assertEqual(response.getMessageId(), 100);
+
+    assertEqual(receiveResponse(second_client, response, buffer), true);
+    assertEqual(response.getT(), TYPE_ACK);
+    assertEqual(response.getCode(), CODE_CONTENT);
+    assertEqual(response.getMessageId(), 200);
+
+    close(first_client);
+    close(second_client);
+}
+
+test(MalformedDatagramIgnored) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+
+    int client = openClient();
+    sockaddr_in address = toLoopback(server.getPort());
+    unsigned char garbage[] = {0x80, 0x01};
+    sendto(client, garbage, sizeof(garbage), 0, (const sockaddr *) &address, sizeof(address));
+    sendRttRequest(client, server.getPort(), 300);
+
+    int handled = 0;
+    for (int i = 0; i < 10 && handled < 2; ++i) {
+        handled += server.poll(100);
+    }
+    assertEqual(handled, 2);
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    CoAPMessageView response;
+    assertEqual(receiveResponse(client, response, buffer), true);
+    assertEqual(response.getMessageId(), 300);
+
+    close(client);
+}
+
+test(LargePayloadSentInOrder) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+
+    int client = openClient();
+    sockaddr_in local = toLoopback(0);
+    bind(client, (const sockaddr *) &local, sizeof(local));
+    socklen_t length = sizeof(local);
+    getsockname(client, (sockaddr *) &local, &length);
+    CoAPEndpoint endpoint(htonl(INADDR_LOOPBACK), ntohs(local.sin_port));
+
+    CoAPMessage small;
+    small.setT(TYPE_NON);
+    small.setCode(CODE_CONTENT);
+    small.setMessageId(1);
+
+    CoAPMessage large;
+    large.setT(TYPE_NON);
+    large.setCode(CODE_CONTENT);
+    large.setMessageId(2);
+    ByteArray payload;
+    for (unsigned int i = 0; i < UDP_GATHER_THRESHOLD + 100; ++i) {
+        payload.pushBack((unsigned char) i);
+    }
+    large.setPayload(payload);
+
+    server(small, endpoint);
+    server(large, endpoint);
+    server.flush();
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    CoAPMessageView response;
+    assertEqual(receiveResponse(client, response, buffer), true);
+    assertEqual(response.getMessageId(), 1);
+    assertEqual(receiveResponse(client, response, buffer), true);
+    assertEqual(response.getMessageId(), 2);
+    assertEqual((response.getPayload() == ByteView(payload.begin(), payload.size())), true);
+
+    close(client);
+}
+
+test(OversizedMessageDropped) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+
+    CoAPMessage message;
+    message.setT(TYPE_NON);
+    message.setCode(CODE_CONTENT);
+    ByteArray payload;
+    payload.resize(UDP_BUFFER_SIZE);
+    message.setPayload(payload);
+
+    server(message, CoAPEndpoint(htonl(INADDR_LOOPBACK), server.getPort()));
+    assertEqual(server.getOversized(), 1);
+    assertEqual(server.flush(), true);
+}
+
+test(TruncatedDatagramDropped) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+
+    // Request which is cut at UDP_BUFFER_SIZE would still parse, with shorter payload
+    CoAPMessage message;
+    message.setT(TYPE_CON);
+    message.setCode(CODE_PUT);
+    message.setMessageId(400);
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LOCAL));
+    message.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_RTT));
+    ByteArray payload;
+    payload.resize(UDP_BUFFER_SIZE);
+    message.setPayload(payload);
+    unsigned char datagram[UDP_BUFFER_SIZE + 16];
+    unsigned int size = message.serialize(datagram, sizeof(datagram));
+
+    int client = openClient();
+    sockaddr_in address = toLoopback(server.getPort());
+    sendto(client, datagram, size, 0, (const sockaddr *) &address, sizeof(address));
+    sendRttRequest(client, server.getPort(), 401);
+
+    int handled = 0;
+    for (int i = 0; i < 10 && handled < 2; ++i) {
+        handled += server.poll(100);
+    }
+    assertEqual(handled, 2);
+    assertEqual(server.getTruncated(), 1);
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    CoAPMessageView response;
+    assertEqual(receiveResponse(client, response, buffer), true);
+    assertEqual(response.getMessageId(), 401);
+
+    close(client);
+}
+
+test(TimeoutMeasuredByHandlerClock) {
+    CoAPUdpServer server;
+    manualClock.time = 0;
+    CoAPHandler handler(server, onRadioMessageToSend, manualClock);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+    assertEqual(server.getTimeout(100), 100);
+
+    // Ping is retransmitted no sooner than ACK_TIMEOUT, which has not passed for the handler
+    handler.sendPing(CoAPEndpoint(htonl(INADDR_LOOPBACK), server.getPort()));
+    assertEqual(server.getTimeout(100), 100);
+    int timeout = server.getTimeout(ACK_TIMEOUT * 2);
+    assertEqual((timeout >= ACK_TIMEOUT && timeout <= ACK_TIMEOUT * ACK_RANDOM_FACTOR_PERCENT / 100), true);
+
+    manualClock.time = ACK_TIMEOUT * ACK_RANDOM_FACTOR_PERCENT / 100;
+    assertEqual(server.getTimeout(100), 0);
+}
+
+test(UnsendableMessageDropped) {
+    CoAPUdpServer server;
+    CoAPHandler handler(server, onRadioMessageToSend);
+    server.setHandler(handler);
+    assertEqual(server.bind(0, htonl(INADDR_LOOPBACK)), true);
+
+    int client = openClient();
+    sockaddr_in local = toLoopback(0);
+    bind(client, (const sockaddr *) &local, sizeof(local));
+    socklen_t length = sizeof(local);
+    getsockname(client, (sockaddr *) &local, &length);
+
+    CoAPMessage message;
+    message.setT(TYPE_NON);
+    message.setCode(CODE_CONTENT);
+    message.setMessageId(500);
+
+    // Port 0 can not be sent to, message after it still has to leave
+    server(message, CoAPEndpoint(htonl(INADDR_LOOPBACK), 0));
+    message.setMessageId(501);
+    server(message, CoAPEndpoint(htonl(INADDR_LOOPBACK), ntohs(local.sin_port)));
+    assertEqual(server.flush(), false);
+    assertEqual(server.getUnsent(), 1);
+    assertEqual(server.flush(), true);
+
+    unsigned char buffer[UDP_BUFFER_SIZE];
+    CoAPMessageView response;
+    assertEqual(receiveResponse(client, response, buffer), true);
+    assertEqual(response.getMessageId(), 501);
+
+    close(client);
+}
+
+test(PollWithoutSocket) {
+    CoAPUdpServer server;
+    assertEqual(server.poll(0), -1);
+    assertEqual(server.getPort(), 0);
+}
+
+endTest
+
+#else
+
+beginTest
+endTest
+
+#endif
@@ -0,0 +1,159 @@
+#include "Test.hpp"
+
+static struct OnRadioFrameToSend : public RadioFrameListener {
+    unsigned char frame[RADIO_FRAME_SIZE];
+    unsigned int size = 0;
+    unsigned int frames = 0;
+
+    void operator()(const unsigned char *frame_begin, unsigned int frame_size) override {
+        memcpy(frame, frame_begin, frame_size);
+        size = frame_size;
+        ++frames;
+    }
+} onRadioFrameToSend;
+
+static struct OnCoAPMessageToSend : public CoAPMessageListener {
+    unsigned int sent = 0;
+    unsigned short last_message_id = 0;
+
+    void operator()(const CoAPMessage &message) override {
+        last_message_id = message.getMessageId();
+        ++sent;
+    }
+} onCoAPMessageToSend;
+
+static CoAPManualClock manualClock;
+
+static struct MessageCollector {
+    RadioMessage messages[RADIO_FRAME_SIZE];
+    unsigned int size = 0;
+
+    void handleMessage(RadioMessage &message) {
+        messages[size++] = message;
+    }
+} collector;
+
+static RadioMessage prepareMessage(unsigned short message_id) {
+    RadioMessage message;
+    message.message_id = message_id;
+    message.code = RADIO_GET;
+    message.resource = RADIO_LAMP;
+    message.value = (unsigned short) (message_id % 100);
+    return message;
+}
+
+beginTest
+
+    test(SingleMessageFrame) {
+        onRadioFrameToSend.frames = 0;
+        manualClock.time = 0;
+        RadioBatcher batcher(onRadioFrameToSend, manualClock, 2);
+
+        batcher(prepareMessage(1));
+        batcher.poll();
+        assertEqual(onRadioFrameToSend.frames, 0);
+
+        manualClock.time = 2;
+        batcher.poll();
+        assertEqual(onRadioFrameToSend.frames, 1);
+
+        RadioMessage message;
+        assertEqual(message.decode(onRadioFrameToSend.frame, onRadioFrameToSend.size), onRadioFrameToSend.size);
+        assertEqual(message.message_id, 1);
+    }
+
+    test(FullFrameSentAtOnce) {
+        onRadioFrameToSend.frames = 0;
+        manualClock.time = 0;
+        RadioBatcher batcher(onRadioFrameToSend, manualClock, 100, RADIO_FORMAT_LEGACY);
+        const unsigned int messages_per_frame = RADIO_FRAME_SIZE / RADIO_LEGACY_MESSAGE_SIZE;
+
+        for (unsigned short i = 0; i < messages_per_frame; ++i) {
+            batcher(prepareMessage((unsigned short) (10 + i)));
+        }
+        assertEqual(onRadioFrameToSend.frames, 0);
+        assertEqual(batcher.size(), messages_per_frame);
+
+        // Message which does not fit pushes full frame out
+        batcher(prepareMessage(99));
+        assertEqual(onRadioFrameToSend.frames, 1);
+        assertEqual(onRadioFrameToSend.size, RADIO_FRAME_SIZE);
+        assertEqual(batcher.size(), 1);
+        unsigned long deadline = 0;
+        assertEqual(batcher.getNextDeadline(deadline), true);
+        assertEqual(deadline, 100);
+
+        batcher.flush();
+        assertEqual(onRadioFrameToSend.frames, 2);
+        assertEqual(batcher.getFramesSent(), 2);
+        assertEqual(batcher.getMessagesSent(), messages_per_frame + 1);
+        assertEqual(batcher.getNextDeadline(deadline), false);
+
+        // Legacy frame can not carry wide values
+        RadioMessage wide = prepareMessage(100);
+        wide.value = 20000;
+        batcher(wide);
+        assertEqual(batcher.size(), 0);
+        assertEqual(batcher.getMessagesDropped(), 1);
+
+        // Nor does message which can not be encoded send frame early
+        batcher(prepareMessage(101));
+        batcher(wide);
+        assertEqual(batcher.size(), 1);
+        assertEqual(onRadioFrameToSend.frames, 2);
+        assertEqual(batcher.getMessagesDropped(), 2);
+    }
+
+    test(SplitFrame) {
+        RadioBatcher batcher(onRadioFrameToSend, manualClock, 100);
+        batcher(prepareMessage(21));
+        batcher(prepareMessage(22));
+        batcher(prepareMessage(23));
+        batcher.flush();
+
+        collector.size = 0;
+        assertEqual(RadioBatcher::split(onRadioFrameToSend.frame, onRadioFrameToSend.size, collector), 3);
+        assertEqual(collector.size, 3);
+        assertEqual(collector.messages[0].message_id, 21);
+        assertEqual(collector.messages[2].message_id, 23);
+        assertEqual(collector.messages[2].value, 23);
+
+        // Trailing bytes which do not form whole message are ignored
+        collector.size = 0;
+        RadioMessage message;
+        unsigned int first_size = message.decode(onRadioFrameToSend.frame, onRadioFrameToSend.size);
+        assertEqual(RadioBatcher::split(onRadioFrameToSend.frame, first_size + 1, collector), 1);
+    }
+
+    test(BatchedRepliesReachHandler) {
+        onRadioFrameToSend.frames = 0;
+        manualClock.time = 0;
+        RadioBatcher batcher(onRadioFrameToSend, manualClock, 2);
+        CoAPHandler handler(onCoAPMessageToSend, batcher, manualClock);
+        handler.setMaxAge(0);
+
+        for (unsigned short i = 0; i < 3; ++i) {
+            CoAPMessage request;
+            request.setT(TYPE_CON);
+            request.setCode(CODE_GET);
+            request.setMessageId((unsigned short) (30 + i));
+            request.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_REMOTE));
+            request.addOption(CoAPOption(OPTION_URI_PATH, RESOURCE_LAMP));
+            handler.handleMessage(request);
+        }
+        assertEqual(onRadioFrameToSend.frames, 0);
+
+        manualClock.time = 2;
+        batcher.poll();
+        assertEqual(onRadioFrameToSend.frames, 1);
+        assertEqual(batcher.getMessagesSent(), 3);
+
+        // Peer answers all requests in one frame
+        onCoAPMessageToSend.sent = 0;
+        assertEqual(RadioBatcher::split(onRadioFrameToSend.frame, onRadioFrameToSend.size, handler), 3);
+        assertEqual(onCoAPMessageToSend.sent, 3);
+        assertEqual(onCoAPMessageToSend.last_message_id, 32);
+        assertEqual(handler.getPendingMessages().size(), 0);
+    }
+
+endTest
@@ -0,0 +1,148 @@
+#include "Test.hpp"
+
+/** Layout of radio message before it was versioned, as compiled by GCC for AVR and x86 **/
+struct LegacyRadioMessage {
+    unsigned short message_id : 16;
+    unsigned short code : 1;
+    unsigned short resource : 1;
+    unsigned short value : 14;
+};
+
+beginTest
+
+    test(VersionedRoundTrip) {
+        RadioMessage message;
+        message.message_id = 0x1234;
+        message.code = RADIO_GET;
+        message.resource = 300;
+        message.value = 100000;
+
+        unsigned char buffer[RADIO_MESSAGE_MAX_SIZE];
+        unsigned int size = message.encode(buffer, sizeof(buffer), RADIO_FORMAT_V1);
+        assertEqual(size, 8);
+        assertEqual(buffer[0], (RADIO_FORMAT_V1 << 4) | RADIO_GET);
+        assertEqual(buffer[1], 0x12);
+        assertEqual(buffer[2], 0x34);
+        assertEqual(buffer[3], 0xac);
+        assertEqual(buffer[4], 0x02);
+
+        RadioMessage decoded;
+        assertEqual(decoded.decode(buffer, size, RADIO_FORMAT_V1), size);
+        assertEqual(decoded.message_id, 0x1234);
+        assertEqual(decoded.code, RADIO_GET);
+        assertEqual(decoded.resource, 300);
+        assertEqual(decoded.value, 100000);
+    }
+
+    test(MaxSizes) {
+        RadioMessage message;
+        message.message_id = 0xFFFF;
+        message.code = 0x0F;
+        message.resource = 0xFFFF;
+        message.value = 0xFFFFFFFFUL;
+
+        unsigned char buffer[RADIO_MESSAGE_MAX_SIZE];
+        assertEqual(message.encode(buffer, sizeof(buffer)), RADIO_MESSAGE_MAX_SIZE);
+        assertEqual(message.encode(buffer, sizeof(buffer) - 1), 0);
+
+        RadioMessage decoded;
+        assertEqual(decoded.decode(buffer, RADIO_MESSAGE_MAX_SIZE), RADIO_MESSAGE_MAX_SIZE);
+        assertEqual(decoded.value, 0xFFFFFFFFUL);
+        assertEqual(decoded.resource, 0xFFFF);
+
+        message.code = 0x10;
+        assertEqual(message.encode(buffer, sizeof(buffer)), 0);
+    }
+
+    test(LegacyCompatibility) {
+        LegacyRadioMessage legacy;
+        legacy.message_id = 4242;
+        legacy.code = RADIO_GET;
+        legacy.resource = RADIO_SPEAKER;
+        legacy.value = 16000;
+
+        RadioMessage decoded;
+        assertEqual(decoded.decode((const unsigned char *) &legacy, sizeof(legacy), RADIO_FORMAT_LEGACY),
+                    RADIO_LEGACY_MESSAGE_SIZE);
+        assertEqual(decoded.message_id, 4242);
+        assertEqual(decoded.code, RADIO_GET);
+        assertEqual(decoded.resource, RADIO_SPEAKER);
+        assertEqual(decoded.value, 16000);
+
+        unsigned char buffer[RADIO_LEGACY_MESSAGE_SIZE];
+        assertEqual(decoded.encode(buffer, sizeof(buffer), RADIO_FORMAT_LEGACY), RADIO_LEGACY_MESSAGE_SIZE);
+        assertEqual(memcmp(buffer, &legacy, RADIO_LEGACY_MESSAGE_SIZE), 0);
+    }
+
+    test(LegacyLimits) {
+        unsigned char buffer[RADIO_LEGACY_MESSAGE_SIZE];
+        RadioMessage message;
+
+        message.value = 0x3FFF;
+        assertEqual(message.encode(buffer, sizeof(buffer), RADIO_FORMAT_LEGACY), RADIO_LEGACY_MESSAGE_SIZE);
+        message.value = 0x4000;
+        assertEqual(message.encode(buffer, sizeof(buffer), RADIO_FORMAT_LEGACY), 0);
+
+        message.value = 0;
+        message.resource = 2;
+        assertEqual(message.encode(buffer, sizeof(buffer), RADIO_FORMAT_LEGACY), 0);
+    }
+
+    test(ValueLimits) {
+        unsigned char buffer[RADIO_MESSAGE_MAX_SIZE];
+        RadioMessage message;
+
+        message.resource = 0xFFFF;
+        message.value = RADIO_MAX_VALUE;
+        assertEqual(message.encode(buffer, sizeof(buffer)), RADIO_MESSAGE_MAX_SIZE);
+
+        // Bigger values fit into unsigned long only where it is wider than 32 bits
+        if (sizeof(unsigned long) > 4) {
+            message.value = RADIO_MAX_VALUE + 1;
+            assertEqual(message.encode(buffer, sizeof(buffer)), 0);
+        }
+    }
+
+    test(FitsFormat) {
+        RadioMessage message;
+        message.code = RADIO_PUT;
+        message.resource = RADIO_SPEAKER;
+        message.value = RADIO_LEGACY_MAX_VALUE;
+        assertEqual(message.fits(RADIO_FORMAT_LEGACY), true);
+
+        message.value = RADIO_LEGACY_MAX_VALUE + 1;
+        assertEqual(message.fits(RADIO_FORMAT_LEGACY), false);
+        assertEqual(message.fits(RADIO_FORMAT_V1), true);
+
+        message.value = 0;
+        message.resource = RADIO_LEGACY_MAX_RESOURCE + 1;
+        assertEqual(message.fits(RADIO_FORMAT_LEGACY), false);
+        assertEqual(message.fits(RADIO_FORMAT_V1), true);
+    }
+
+    test(Malformed) {
+        RadioMessage message;
+
+        unsigned char too_short[] = {0x11, 0x00};
+        assertEqual(message.decode(too_short, sizeof(too_short)), 0);
+
+        unsigned char wrong_version[] = {0x21, 0x00, 0x01, 0x00, 0x00};
+        assertEqual(message.decode(wrong_version, sizeof(wrong_version)), 0);
+
+        unsigned char unfinished_varint[] = {0x11, 0x00, 0x01, 0x80};
+        assertEqual(message.decode(unfinished_varint, sizeof(unfinished_varint)), 0);
+
+        unsigned char resource_too_big[] = {0x11, 0x00, 0x01, 0x80, 0x80, 0x04, 0x00};
+        assertEqual(message.decode(resource_too_big, sizeof(resource_too_big)), 0);
+
+        unsigned char value_too_big[] = {0x11, 0x00, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x1f};
+        assertEqual(message.decode(value_too_big, sizeof(value_too_big)), 0);
+
+        // Zero could be also written as 0x80 0x00, but only the shortest encoding is accepted
+        unsigned char overlong_varint[] = {0x11, 0x00, 0x01, 0x80, 0x00, 0x00};
+        assertEqual(message.decode(overlong_varint, sizeof(overlong_varint)), 0);
+        overlong_varint[3] = 0x00;
+        assertEqual(message.decode(overlong_varint, sizeof(overlong_varint) - 1), sizeof(overlong_varint) - 1);
+    }
+
+endTest
@@ -0,0 +1,110 @@
+#include "Test.hpp"
+
+beginTest
+
+    test(FirstInFirstOut) {
+        RingBuffer<unsigned short> buffer(4);
+        assertEqual(buffer.isEmpty(), true);
+
+        assertEqual(buffer.push(1), true);
+        assertEqual(buffer.push(2), true);
+        assertEqual(buffer.size(), 2);
+
+        unsigned short value = 0;
+        assertEqual(buffer.pop(value), true);
+        assertEqual(value, 1);
+        assertEqual(buffer.pop(value), true);
+        assertEqual(value, 2);
+        assertEqual(buffer.pop(value), false);
+        assertEqual(buffer.isEmpty(), true);
+    }
+
+    test(CapacityRoundedUp) {
+        RingBuffer<unsigned short> buffer(5);
+        assertEqual(buffer.capacity(), 8);
+    }
+
+    test(FullQueueDrops) {
+        RingBuffer<unsigned short> buffer(2);
+        assertEqual(buffer.push(1), true);
+        assertEqual(buffer.push(2), true);
+        assertEqual(buffer.push(3), false);
+        assertEqual(buffer.push(4), false);
+
+        assertEqual(buffer.size(), 2);
+        assertEqual(buffer.getDropped(), 2);
+        assertEqual(buffer.getHighWaterMark(), 2);
+
+        unsigned short value = 0;
+        buffer.pop(value);
+        assertEqual(value, 1);
+        assertEqual(buffer.push(5), true);
+        buffer.pop(value);
+        assertEqual(value, 2);
+        buffer.pop(value);
+        assertEqual(value, 5);
+    }
+
+    test(WrapAround) {
+        RingBuffer<unsigned int> buffer(4);
+        unsigned int value = 0;
+
+        for (unsigned int i = 0; i < 1000; ++i) {
+            assertEqual(buffer.push(i), true);
+            assertEqual(buffer.push(i + 1), true);
+            assertEqual(buffer.pop(value), true);
+            assertEqual(value, i);
+            assertEqual(buffer.pop(value), true);
+            assertEqual(value, i + 1);
+        }
+        assertEqual(buffer.isEmpty(), true);
+        assertEqual(buffer.getDropped(), 0);
+    }
+
+    test(MovedElements) {
+        RingBuffer<ByteArray> buffer(2);
+        ByteArray array(16);
+        array.pushBack(42);
+        unsigned char* elements = array.begin();
+
+        assertEqual(buffer.push(static_cast<ByteArray &&>(array)), true);
+        assertEqual(array.size(), 0);
+
+        ByteArray popped;
+        assertEqual(buffer.pop(popped), true);
+        assertEqual(popped.begin(), elements);
+        assertEqual(popped[0], 42);
+    }
+
+#if defined(__linux__)
+    test(ProducerAndConsumerThreads) {
+        RingBuffer<unsigned int> buffer(64);
+        const unsigned int count = 100000;
+
+        std::thread producer([&buffer, count]() {
+            for (unsigned int i = 0; i < count; ++i) {
+                while (!buffer.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        unsigned int expected = 0;
+        unsigned int value;
+        while (expected < count) {
+            if (buffer.pop(value)) {
+                assertEqual(value, expected);
+                ++expected;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        assertEqual(buffer.isEmpty(), true);
+        assertEqual(buffer.getHighWaterMark() <= 64, true);
+    }
+#endif
+
+endTest